@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace StandardUtilities {
+    inline constexpr uint32_t MAX_ALLOCATION_SITES = 32;
+
+    // Where operator new was called from (the return address, resolve it with addr2line)
+    //  . In an optimized build that's usually the function that allocated, in a debug one it tends to be std::allocator
+    struct AllocationSite {
+        const void* Address;
+        uint64_t    Count;
+        uint64_t    Bytes;
+    };
+
+    struct AllocationReport {
+        uint64_t Allocations = 0;
+        uint64_t Frees       = 0;
+        uint64_t Bytes       = 0;
+
+        std::array<AllocationSite, MAX_ALLOCATION_SITES> Sites{};
+        uint32_t                                         SiteCount     = 0;
+        uint64_t                                         DroppedSites  = 0; // Allocations from sites that didn't fit anymore
+    };
+
+    // Global operator new/delete are replaced (see AllocationTracker.cpp), they only count on a thread that armed tracking
+    //  . Nothing in here allocates itself, so it can be armed around code that's meant to be allocation free
+    //  . Arming again just starts over
+    void             armAllocationTracking();
+    AllocationReport disarmAllocationTracking();
+
+    // Adds another report onto the first one, sites are merged by address
+    void accumulateAllocationReport(AllocationReport& total, const AllocationReport& report);
+}
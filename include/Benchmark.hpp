@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace Benchmark {
+    using Clock = std::chrono::steady_clock;
+
+    struct Result {
+        std::string Name;
+        uint64_t    Iterations;
+        double      TotalMilliseconds;
+
+        [[nodiscard]] double averageMilliseconds() const;
+    };
+
+    class Stopwatch {
+    public:
+        Stopwatch();
+
+        void                 restart();
+        [[nodiscard]] double elapsedMilliseconds() const;
+
+    private:
+        Clock::time_point start_time;
+    };
+
+    // Runs the function the given amount of times and returns how long it took in total
+    template <typename Function>
+    Result measure(std::string name, const uint64_t iterations, Function&& function) {
+        const Stopwatch stopwatch{};
+
+        for (uint64_t i = 0; i < iterations; i++)
+            function(i);
+
+        return { std::move(name), iterations, stopwatch.elapsedMilliseconds() };
+    }
+
+    void report(const Result& result);
+    void report(const Result& baseline, const Result& candidate);
+}
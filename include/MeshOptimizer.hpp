@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MeshUtils.hpp"
+
+namespace MeshUtilities {
+    // Roughly what the post-transform cache holds on current hardware (it isn't a real FIFO anymore, but it's still a good model)
+    inline constexpr uint32_t DEFAULT_VERTEX_CACHE_SIZE  = 16;
+    inline constexpr float    DEFAULT_OVERDRAW_THRESHOLD = 1.05f; // How much ACMR the overdraw pass is allowed to give back
+    inline constexpr uint32_t DEFAULT_FETCH_LINE_SIZE    = 64;
+    inline constexpr uint32_t DEFAULT_FETCH_LINE_COUNT   = 256; // 16KB, about what a vertex fetch (L1) cache gets
+
+    // Simulated with a FIFO cache:
+    //  . ACMR: Vertex shader invocations per triangle (0.5 is the best a regular grid can do, 3 is no reuse at all)
+    //  . ATVR: Vertex shader invocations per referenced vertex (1 is perfect)
+    struct VertexCacheStatistics {
+        uint32_t Misses    = 0;
+        uint32_t Triangles = 0;
+        uint32_t Vertices  = 0;
+
+        float ACMR = 0.0f;
+        float ATVR = 0.0f;
+    };
+
+    // Memory traffic for one pass over the index buffer, through the post-transform cache and then a FIFO cache of lines:
+    //  . BytesFetched: Whole lines, so a stride that drags unused attributes along pays for them too
+    //  . Overfetch:    BytesFetched / (referenced vertices * fetch size), 1 means every byte that was needed got read once
+    struct VertexFetchStatistics {
+        uint64_t BytesFetched = 0;
+        uint32_t Vertices     = 0;
+
+        float Overfetch = 0.0f;
+    };
+
+    struct MeshOptimizationReport {
+        uint32_t VerticesBefore = 0;
+        uint32_t VerticesAfter  = 0;
+
+        VertexCacheStatistics Before;
+        VertexCacheStatistics After;
+    };
+
+    VertexCacheStatistics analyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertex_count, uint32_t cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+
+    // Every vertex shader invocation reads fetch_size bytes at index * vertex_stride (fetch_size < vertex_stride for a pass that only uses some attributes)
+    VertexFetchStatistics analyzeVertexFetch(
+        std::span<const uint32_t> indices,
+        uint32_t                  vertex_count,
+        uint32_t                  vertex_stride,
+        uint32_t                  fetch_size,
+        uint32_t                  cache_size = DEFAULT_VERTEX_CACHE_SIZE,
+        uint32_t                  line_size  = DEFAULT_FETCH_LINE_SIZE,
+        uint32_t                  line_count = DEFAULT_FETCH_LINE_COUNT
+    );
+
+    // Merges vertices that are bit-for-bit identical in every stream (a non-indexed mesh gets its index buffer here), returns the new vertex count
+    uint32_t deduplicateVertices(Mesh& mesh);
+
+    // Tipsify (Sander et al. 2007), fans around the most recently used vertices and only jumps when the cache runs dry
+    void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+
+    // Splits the (cache optimized) triangle list into clusters wherever that doesn't cost more than threshold * ACMR,
+    // then draws the clusters facing outwards first so they tend to occlude the rest
+    void optimizeOverdraw(
+        std::vector<uint32_t>&     indices,
+        std::span<const glm::vec3> positions,
+        uint32_t                   cache_size = DEFAULT_VERTEX_CACHE_SIZE,
+        float                      threshold  = DEFAULT_OVERDRAW_THRESHOLD
+    );
+
+    // Renumbers vertices in the order the index buffer first touches them (and drops unused ones), returns the new vertex count
+    uint32_t optimizeVertexFetch(Mesh& mesh);
+
+    // All of the above, in the order they have to run in
+    MeshOptimizationReport optimizeMesh(Mesh& mesh, uint32_t cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace MeshUtilities {
+    // CPU side mesh, one array per attribute so each stream can be processed (and encoded) on its own
+    //  . Attributes that a mesh doesn't have are left empty
+    struct Mesh {
+        std::vector<glm::vec3> Positions;
+        std::vector<glm::vec3> Normals;
+        std::vector<glm::vec2> UVs;
+        std::vector<glm::vec4> Colors;
+        std::vector<uint32_t>  Indices;
+
+        [[nodiscard]] uint32_t vertexCount() const;
+        [[nodiscard]] uint32_t triangleCount() const;
+    };
+
+    // A wavy (columns + 1) x (rows + 1) vertex heightfield on the XZ plane, two triangles per cell
+    //  . Big enough grids make a decent stand-in for a real mesh until there's a model loader
+    Mesh createGridMesh(uint32_t columns, uint32_t rows);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Rendering {
+    // Sort key layout, most significant first (what's most expensive to change goes highest so sorting groups by it):
+    //  . Pass:     4 bits, the order passes run in (depth prepass before opaque, ...)
+    //  . Pipeline: 12 bits
+    //  . Material: 16 bits
+    //  . Depth:    32 bits, the float's own bits (they sort like the value as long as it's not negative)
+    inline constexpr uint32_t SORT_KEY_PASS_BITS     = 4;
+    inline constexpr uint32_t SORT_KEY_PIPELINE_BITS = 12;
+    inline constexpr uint32_t SORT_KEY_MATERIAL_BITS = 16;
+    inline constexpr uint32_t SORT_KEY_DEPTH_BITS    = 32;
+
+    inline constexpr uint32_t SORT_KEY_DEPTH_SHIFT    = 0;
+    inline constexpr uint32_t SORT_KEY_MATERIAL_SHIFT = SORT_KEY_DEPTH_SHIFT    + SORT_KEY_DEPTH_BITS;
+    inline constexpr uint32_t SORT_KEY_PIPELINE_SHIFT = SORT_KEY_MATERIAL_SHIFT + SORT_KEY_MATERIAL_BITS;
+    inline constexpr uint32_t SORT_KEY_PASS_SHIFT     = SORT_KEY_PIPELINE_SHIFT + SORT_KEY_PIPELINE_BITS;
+
+    static_assert(SORT_KEY_PASS_SHIFT + SORT_KEY_PASS_BITS == 64, "Sort key fields have to fill exactly 64 bits");
+
+    // Opaque draws go front to back (early-z rejects more), blended ones have to go back to front
+    enum class DepthOrder {
+        FrontToBack,
+        BackToFront
+    };
+
+    // Fields that don't fit get masked down, depth is clamped to >= 0
+    uint64_t makeSortKey(uint32_t pass, uint32_t pipeline, uint32_t material, float depth, DepthOrder order = DepthOrder::FrontToBack);
+
+    uint32_t getSortKeyPass(uint64_t key);
+    uint32_t getSortKeyPipeline(uint64_t key);
+    uint32_t getSortKeyMaterial(uint64_t key);
+
+    // Object is whatever the recorder needs to find the draw's data again (an index into the scene, usually)
+    struct DrawItem {
+        uint64_t Key;
+        uint32_t Object;
+    };
+
+    // Refilled every frame, the vectors keep their capacity so a steady scene doesn't allocate
+    struct RenderQueue {
+        std::vector<DrawItem> Items;
+        std::vector<DrawItem> Scratch; // Ping-pong buffer for the radix sort
+    };
+
+    void resetRenderQueue(RenderQueue& queue);
+    void submitDraw(RenderQueue& queue, uint64_t key, uint32_t object);
+
+    // LSD radix sort on the key, a byte per pass (stable, and passes where every key has the same byte are skipped)
+    void sortRenderQueue(RenderQueue& queue);
+
+    inline constexpr uint32_t UNBOUND = ~0u;
+
+    struct BindStatistics {
+        uint32_t Issued  = 0;
+        uint32_t Skipped = 0;
+    };
+
+    // What the recorder last bound, by id (pipeline/material come straight out of the key, the set id is up to the caller)
+    //  . Only tracks, the caller still issues the vkCmdBind* when bindIfChanged() says so
+    struct BoundState {
+        uint32_t Pipeline      = UNBOUND;
+        uint32_t DescriptorSet = UNBOUND;
+        uint32_t Material      = UNBOUND;
+
+        BindStatistics Statistics;
+    };
+
+    // True (and bound updated) when value differs from what's bound, counts the bind as issued or skipped either way
+    bool bindIfChanged(BoundState& state, uint32_t& bound, uint32_t value);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+namespace StandardUtilities {
+    struct TaskGraphTask {
+        std::string           Name;
+        std::function<void()> Job;
+        std::vector<uint32_t> Dependencies;
+        bool                  MainThread = false; // Runs on the thread that called runTaskGraph() (GLFW calls that have to come from the main thread)
+    };
+
+    // Tasks that only start once everything they depend on is done, the dependencies are the only ordering there is
+    //  . A task can only depend on tasks added before it, so there are no cycles and the ids are a valid serial order too
+    //  . Whatever two tasks without a path between them share has to be safe to touch from two threads at once
+    struct TaskGraph {
+        std::vector<TaskGraphTask> Tasks;
+    };
+
+    struct TaskTiming {
+        std::string Name;
+        double      StartMilliseconds; // Since runTaskGraph() was called
+        double      EndMilliseconds;
+        uint32_t    Thread;            // 0 is the calling thread, workers are numbered in the order they first ran something
+    };
+
+    uint32_t addTask(TaskGraph& graph, std::string name, std::vector<uint32_t> dependencies, std::function<void()> job, bool main_thread = false);
+
+    // Without workers every task runs on the calling thread in the order it was added
+    //  . The first exception a task throws stops anything new from starting, it's rethrown once whatever is running has finished
+    //  . Timings come back in the order the tasks finished
+    std::vector<TaskTiming> runTaskGraph(const TaskGraph& graph, ThreadPool* workers);
+}
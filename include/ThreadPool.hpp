@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace StandardUtilities {
+    // Fixed set of worker threads pulling jobs off one FIFO queue
+    //  . Jobs can't return anything, they write their results wherever they need to (under their own lock)
+    //  . A job that throws takes the program down (std::terminate), catch inside the job if that matters
+    class ThreadPool {
+    public:
+        explicit ThreadPool(uint32_t thread_count = defaultThreadCount());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void submit(std::function<void()> job);
+
+        // Blocks until the queue is empty and every worker is idle again
+        void waitIdle();
+
+        [[nodiscard]] uint32_t threadCount() const;
+
+        // Every hardware thread but the one the caller is on (and at least one)
+        static uint32_t defaultThreadCount();
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread>          workers;
+        std::deque<std::function<void()>> jobs;
+        std::mutex                        mutex;
+        std::condition_variable           job_available;
+        std::condition_variable           idle;
+        uint32_t                          busy_workers = 0;
+        bool                              stopping     = false;
+    };
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan_core.h>
+
+namespace VulkanUtilities {
+    // Bindings inside the bindless set (the sampler array is last so it can use a variable descriptor count)
+    inline constexpr uint32_t BINDLESS_STORAGE_BUFFER_BINDING = 0;
+    inline constexpr uint32_t BINDLESS_SAMPLED_IMAGE_BINDING  = 1;
+    inline constexpr uint32_t BINDLESS_SAMPLER_BINDING        = 2;
+
+    inline constexpr uint32_t BINDLESS_INVALID_INDEX = UINT32_MAX;
+
+    // Requested sizes of the global arrays, these get clamped to what the device can actually do
+    struct BindlessCapacities {
+        uint32_t StorageBuffers = 1024;
+        uint32_t SampledImages  = 16384;
+        uint32_t Samplers       = 256;
+    };
+
+    // One global descriptor set that every draw indexes into, instead of a set per resource combination
+    //  . Slots are handed out with register*() and recycled with release*()
+    //  . The set is update-after-bind, so registering resources never requires rebinding it
+    struct BindlessTable {
+        VkDescriptorSetLayout Layout = VK_NULL_HANDLE;
+        VkDescriptorPool      Pool   = VK_NULL_HANDLE;
+        VkDescriptorSet       Set    = VK_NULL_HANDLE;
+
+        BindlessCapacities Capacities{};
+
+        uint32_t StorageBufferCount = 0;
+        uint32_t SampledImageCount  = 0;
+        uint32_t SamplerCount       = 0;
+
+        std::vector<uint32_t> FreeStorageBuffers;
+        std::vector<uint32_t> FreeSampledImages;
+        std::vector<uint32_t> FreeSamplers;
+    };
+
+    // Takes the features queried with VK_EXT_descriptor_indexing available (see DeviceCapabilities), checks what the bindless table uses
+    bool isDescriptorIndexingSupported(const VkPhysicalDeviceDescriptorIndexingFeaturesEXT& features);
+    void populateDescriptorIndexingFeatures(VkPhysicalDeviceDescriptorIndexingFeaturesEXT& features);
+
+    BindlessTable createBindlessTable(VkDevice device, VkPhysicalDevice physical_device, const BindlessCapacities& requested_capacities);
+    void          destroyBindlessTable(VkDevice device, BindlessTable& table);
+
+    uint32_t registerBindlessStorageBuffer(VkDevice device, BindlessTable& table, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+    uint32_t registerBindlessSampledImage(VkDevice device, BindlessTable& table, VkImageView view, VkImageLayout layout);
+    uint32_t registerBindlessSampler(VkDevice device, BindlessTable& table, VkSampler sampler);
+
+    void releaseBindlessStorageBuffer(BindlessTable& table, uint32_t index);
+    void releaseBindlessSampledImage(BindlessTable& table, uint32_t index);
+    void releaseBindlessSampler(BindlessTable& table, uint32_t index);
+}
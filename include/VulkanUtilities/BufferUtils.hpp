@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include <vulkan_core.h>
 
 namespace VulkanUtilities {
@@ -19,6 +20,10 @@ namespace VulkanUtilities {
         VkDeviceMemory&       memory
     );
 
+    // One-off command buffers for uploads and layout transitions, end...() submits and waits for the queue to go idle
+    VkCommandBuffer beginSingleTimeCommands(VkDevice device, VkCommandPool pool);
+    void            endSingleTimeCommands(VkDevice device, VkCommandPool pool, VkQueue queue, VkCommandBuffer command_buffer);
+
     void copyBuffer(
         VkDevice      device,
         VkCommandPool pool,
@@ -27,4 +32,22 @@ namespace VulkanUtilities {
         VkBuffer      destination,
         VkDeviceSize  size
     );
+
+    // Same as copyBuffer() but with any number of regions in one submit (used for sub-allocated buffers)
+    void copyBufferRegions(
+        VkDevice                         device,
+        VkCommandPool                    pool,
+        VkQueue                          queue,
+        VkBuffer                         source,
+        VkBuffer                         destination,
+        const std::vector<VkBufferCopy>& regions
+    );
+
+    // Just records the copy (nothing for no regions), so several buffers can go in one single time submit
+    void cmdCopyBufferRegions(
+        VkCommandBuffer                  command_buffer,
+        VkBuffer                         source,
+        VkBuffer                         destination,
+        const std::vector<VkBufferCopy>& regions
+    );
 }
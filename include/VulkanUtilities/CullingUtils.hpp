@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <vulkan_core.h>
+
+#include <glm/glm.hpp>
+
+namespace VulkanUtilities {
+    // Bounding spheres are xyz = center, w = radius (the same layout the culling shaders read)
+    using FrustumPlanes = std::array<glm::vec4, 6>;
+
+    // Gribb/Hartmann plane extraction for Vulkan clip space (0 <= z <= w), normals point inwards and are normalized
+    FrustumPlanes extractFrustumPlanes(const glm::mat4& view_projection);
+
+    // CPU versions of what the culling shader does, handy for checking it (and for the CPU path)
+    bool      isSphereInFrustum(const FrustumPlanes& planes, glm::vec4 sphere);
+    glm::vec4 computeBoundingSphere(std::span<const glm::vec3> positions);
+    glm::vec4 transformBoundingSphere(const glm::mat4& model, glm::vec4 sphere);
+
+    // GPU-driven drawing needs VK_KHR_draw_indirect_count, multiDrawIndirect and drawIndirectFirstInstance (the object index rides in firstInstance)
+    //  . Only checks the features, the extension is up to the caller
+    bool isDrawIndirectCountSupported(const VkPhysicalDeviceFeatures& features);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include <vulkan_core.h>
+
+#include "VulkanUtilities/ExtensionUtils.hpp"
+
+// On in debug builds unless the build says otherwise (-DVULKAN_DEBUG_NAMES=0/1)
+#ifndef VULKAN_DEBUG_NAMES
+#ifdef NDEBUG
+#define VULKAN_DEBUG_NAMES 0
+#else
+#define VULKAN_DEBUG_NAMES 1
+#endif
+#endif
+
+namespace VulkanUtilities {
+    inline constexpr bool     DEBUG_NAMES_ENABLED = VULKAN_DEBUG_NAMES;
+    inline constexpr uint32_t NO_NAME_INDEX       = ~0u;
+    inline constexpr uint32_t DEBUG_NAME_LENGTH   = 128;
+
+    // Object names show up in captures (RenderDoc, Nsight, ...) and in validation messages instead of raw handles
+    //  . Everything here is an empty inline function with VULKAN_DEBUG_NAMES off, so the calls can stay in release builds
+    //  . Names get copied by the driver, a temporary is fine
+
+    // Appends " [index]" unless it's NO_NAME_INDEX, for handles that come in arrays (one per frame, per swapchain image, ...)
+    void setDebugObjectName(VkDevice device, VkObjectType type, uint64_t handle, const char* name, uint32_t index);
+
+    // Non-dispatchable handles are pointers or uint64_t depending on the platform, this takes either
+    template <typename Handle>
+    void setObjectName(const VkDevice device, const VkObjectType type, const Handle handle, const char* name, const uint32_t index = NO_NAME_INDEX) {
+        if constexpr (DEBUG_NAMES_ENABLED) {
+            if constexpr (std::is_pointer_v<Handle>)
+                setDebugObjectName(device, type, reinterpret_cast<uint64_t>(handle), name, index);
+            else
+                setDebugObjectName(device, type, static_cast<uint64_t>(handle), name, index);
+        }
+    }
+
+    // Labels everything recorded while it's alive, regions nest like the scopes do
+    class DebugLabelScope {
+    public:
+        DebugLabelScope(const VkCommandBuffer command_buffer, const char* name) : buffer{ command_buffer } {
+            if constexpr (DEBUG_NAMES_ENABLED)
+                cmdBeginDebugUtilsLabelEXT(buffer, name);
+        }
+
+        ~DebugLabelScope() {
+            if constexpr (DEBUG_NAMES_ENABLED)
+                cmdEndDebugUtilsLabelEXT(buffer);
+        }
+
+        DebugLabelScope(const DebugLabelScope&)            = delete;
+        DebugLabelScope& operator=(const DebugLabelScope&) = delete;
+
+    private:
+        VkCommandBuffer buffer;
+    };
+}
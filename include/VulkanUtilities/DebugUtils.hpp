@@ -1,11 +1,39 @@
 #pragma once
+#include <cstdint>
+
 #include "BufferUtils.hpp"
 
 namespace VulkanUtilities {
+    inline constexpr uint32_t DEBUG_MESSAGE_QUEUE_SIZE     = 1024; // Power of two, messages that don't fit anymore are dropped (and counted)
+    inline constexpr uint32_t DEBUG_MESSAGE_LENGTH         = 1024; // Longer ones get cut off
+    inline constexpr uint32_t DEBUG_MESSAGE_ID_SLOTS       = 512;  // Power of two, ids past that many aren't rate limited
+    inline constexpr uint32_t DEBUG_MESSAGE_RATE_LIMIT     = 5;    // Per id and window, the rest are only counted
+    inline constexpr uint32_t DEBUG_MESSAGE_RATE_WINDOW_MS = 1000;
+
+    struct DebugMessageStatistics {
+        uint64_t Received    = 0; // Warnings and errors, verbose/info messages are ignored
+        uint64_t Logged      = 0;
+        uint64_t Suppressed  = 0; // Over the rate limit of their id
+        uint64_t Dropped     = 0; // The queue was full
+        uint32_t DistinctIds = 0;
+    };
+
+    // Runs on whatever thread the driver happens to be on, so all it does is copy the message into a lock-free queue
+    //  . Nothing is allocated and nothing waits on a lock, a validation flood costs the render thread a memcpy per message
+    //  . Repeats of the same messageIdNumber past DEBUG_MESSAGE_RATE_LIMIT per window are folded into a count instead
+    //  . startDebugMessageLog()'s thread does the actual logging
     VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
         VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
         VkDebugUtilsMessageTypeFlagsEXT messageType,
         const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
         void* pUserData
     );
+
+    // Messages queued before it starts (instance creation) are logged straight away
+    void startDebugMessageLog();
+
+    // Logs whatever is still queued and a summary of the noisiest ids, fine to call more than once
+    void stopDebugMessageLog();
+
+    DebugMessageStatistics getDebugMessageStatistics();
 }
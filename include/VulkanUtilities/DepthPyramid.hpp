@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan_core.h>
+
+namespace VulkanUtilities {
+    // R32 float is guaranteed to support storage writes, so every level can be written straight from compute
+    inline constexpr VkFormat DEPTH_PYRAMID_FORMAT = VK_FORMAT_R32_SFLOAT;
+
+    // Hierarchical-Z buffer: every texel holds the farthest depth of the texels it covers one level down
+    //  . Level 0 is half the depth buffer (rounded down), the odd row/column gets folded into the last texel
+    //  . Lives in VK_IMAGE_LAYOUT_GENERAL for good, it gets written as a storage image and sampled in the same frame
+    struct DepthPyramid {
+        uint32_t Width     = 0;
+        uint32_t Height    = 0;
+        uint32_t MipLevels = 0;
+
+        VkImage                  Image  = VK_NULL_HANDLE;
+        VkDeviceMemory           Memory = VK_NULL_HANDLE;
+        VkImageView              View   = VK_NULL_HANDLE; // Every level, what the culling pass samples
+        std::vector<VkImageView> MipViews;                // One per level, written by the reduction and read by the next one
+        VkSampler                Sampler = VK_NULL_HANDLE; // Nearest, so a sample is exactly one texel's max depth
+    };
+
+    VkExtent2D getDepthPyramidExtent(VkExtent2D depth_extent);
+
+    DepthPyramid createDepthPyramid(VkDevice device, VkPhysicalDevice physical_device, VkCommandPool pool, VkQueue queue, VkExtent2D depth_extent);
+    void         destroyDepthPyramid(VkDevice device, DepthPyramid& pyramid);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <vulkan_core.h>
+
+namespace VulkanUtilities {
+    // How many descriptors of a type each set is expected to need on average (pool sizes = Ratio * SetsPerPool)
+    struct DescriptorPoolRatio {
+        VkDescriptorType Type;
+        float            Ratio;
+    };
+
+    inline const std::vector<DescriptorPoolRatio> DEFAULT_DESCRIPTOR_POOL_RATIOS = {
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         1.0f },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         1.0f },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f }
+    };
+
+    inline constexpr uint32_t MAX_DESCRIPTOR_SETS_PER_POOL = 4096;
+
+    // A descriptor allocator that never runs out:
+    //  . When the current pool is full (VK_ERROR_OUT_OF_POOL_MEMORY / VK_ERROR_FRAGMENTED_POOL) it chains a new (bigger) one
+    //  . Resetting hands every pool back with vkResetDescriptorPool, so a transient allocator can drop a whole frame of sets at once
+    struct DescriptorAllocator {
+        std::vector<DescriptorPoolRatio> Ratios;
+        uint32_t                         SetsPerPool = 0; // Grows every time a new pool has to be created
+
+        VkDescriptorPool              CurrentPool = VK_NULL_HANDLE;
+        std::vector<VkDescriptorPool> FullPools;
+        std::vector<VkDescriptorPool> ReadyPools;
+
+        uint32_t PoolsCreated  = 0;
+        uint64_t SetsAllocated = 0;
+    };
+
+    DescriptorAllocator createDescriptorAllocator(uint32_t initial_sets_per_pool, const std::vector<DescriptorPoolRatio>& ratios = DEFAULT_DESCRIPTOR_POOL_RATIOS);
+    void                destroyDescriptorAllocator(VkDevice device, DescriptorAllocator& allocator);
+    void                resetDescriptorAllocator(VkDevice device, DescriptorAllocator& allocator);
+
+    VkDescriptorSet allocateDescriptorSet(VkDevice device, DescriptorAllocator& allocator, VkDescriptorSetLayout layout, const void* allocate_next = nullptr);
+
+    // Samplers, images and input attachments read VkDescriptorImageInfo, (non-texel) buffers VkDescriptorBufferInfo
+    bool isImageDescriptor(VkDescriptorType type);
+
+    // Everything that decides the contents of a descriptor (only the info matching the Type is looked at)
+    struct DescriptorBinding {
+        uint32_t               Binding;
+        VkDescriptorType       Type;
+        VkDescriptorBufferInfo BufferInfo;
+        VkDescriptorImageInfo  ImageInfo;
+    };
+
+    bool operator==(const DescriptorBinding& left, const DescriptorBinding& right);
+
+    struct DescriptorSetKey {
+        VkDescriptorSetLayout          Layout;
+        std::vector<DescriptorBinding> Bindings;
+
+        bool operator==(const DescriptorSetKey& other) const = default;
+    };
+
+    struct DescriptorSetKeyHash {
+        size_t operator()(const DescriptorSetKey& key) const;
+    };
+
+    // Persistent sets, allocated and written once per unique (layout, bindings) combination
+    struct DescriptorSetCache {
+        DescriptorAllocator Allocator;
+
+        std::unordered_map<DescriptorSetKey, VkDescriptorSet, DescriptorSetKeyHash> Sets;
+
+        uint64_t Hits   = 0;
+        uint64_t Misses = 0;
+    };
+
+    DescriptorSetCache createDescriptorSetCache(uint32_t initial_sets_per_pool, const std::vector<DescriptorPoolRatio>& ratios = DEFAULT_DESCRIPTOR_POOL_RATIOS);
+    void               destroyDescriptorSetCache(VkDevice device, DescriptorSetCache& cache);
+
+    // New sets are written with the update template when one is given (the bindings then have to be in layout order)
+    VkDescriptorSet getOrCreateDescriptorSet(
+        VkDevice                              device,
+        DescriptorSetCache&                   cache,
+        VkDescriptorSetLayout                 layout,
+        const std::vector<DescriptorBinding>& bindings,
+        VkDescriptorUpdateTemplate            update_template = VK_NULL_HANDLE
+    );
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include <vulkan_core.h>
+
+#include "DescriptorAllocator.hpp"
+#include "HostAllocator.hpp"
+
+namespace VulkanUtilities {
+    // Descriptor data gets packed binding after binding, in the order the layout bindings were given:
+    //  . Buffers:        VkDescriptorBufferInfo[descriptorCount]
+    //  . Images/Samplers VkDescriptorImageInfo[descriptorCount]
+    //  . Texel Buffers:  VkBufferView[descriptorCount]
+    // Which is exactly what a plain struct with one member (or array) per binding looks like in memory
+    size_t getDescriptorDataStride(VkDescriptorType type);
+    size_t getDescriptorDataSize(const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+
+    // Builds the template entries straight from the layout bindings (data_size is checked against the packed size)
+    VkDescriptorUpdateTemplate createDescriptorUpdateTemplate(
+        VkDevice                                         device,
+        VkDescriptorSetLayout                            layout,
+        const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+        size_t                                           data_size
+    );
+
+    // Packs cache-style bindings (one descriptor each, sorted like the layout) into template data
+    std::vector<std::byte> packDescriptorBindings(const std::vector<DescriptorBinding>& bindings);
+
+    // Typed front end: Data is the packed struct, so updating a set is a single call with no write arrays to fill
+    template <typename Data>
+    struct TypedDescriptorTemplate {
+        static_assert(std::is_trivially_copyable_v<Data>, "Descriptor template data is read as raw bytes!");
+
+        VkDescriptorUpdateTemplate Template = VK_NULL_HANDLE;
+
+        void update(const VkDevice device, const VkDescriptorSet set, const Data& data) const {
+            vkUpdateDescriptorSetWithTemplate(device, set, Template, &data);
+        }
+    };
+
+    template <typename Data>
+    TypedDescriptorTemplate<Data> createTypedDescriptorTemplate(
+        const VkDevice                                   device,
+        const VkDescriptorSetLayout                      layout,
+        const std::vector<VkDescriptorSetLayoutBinding>& bindings
+    ) {
+        return { createDescriptorUpdateTemplate(device, layout, bindings, sizeof(Data)) };
+    }
+
+    template <typename Data>
+    void destroyTypedDescriptorTemplate(const VkDevice device, TypedDescriptorTemplate<Data>& descriptor_template) {
+        vkDestroyDescriptorUpdateTemplate(device, descriptor_template.Template, getAllocationCallbacks());
+        descriptor_template.Template = VK_NULL_HANDLE;
+    }
+}
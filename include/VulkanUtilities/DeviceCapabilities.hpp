@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <vulkan_core.h>
+
+namespace VulkanUtilities {
+    // Everything device selection and creation look at, queried once per physical device instead of every time something asks
+    //  . The surface independent half can come from the disk cache, as long as the driver version matches
+    //  . The surface half (present support, formats, present modes) is queried every run
+    struct DeviceCapabilities {
+        VkPhysicalDevice Device = VK_NULL_HANDLE;
+
+        VkPhysicalDeviceProperties           Properties{};
+        VkPhysicalDeviceFeatures             Features{};
+        VkPhysicalDeviceMemoryProperties     MemoryProperties{};
+        std::vector<VkQueueFamilyProperties> QueueFamilies;
+        std::vector<uint64_t>                Extensions; // Sorted hashes of the extension names, see hasDeviceExtension()
+
+        // The optional features the renderer can turn on
+        bool     DescriptorIndexing      = false;
+        bool     DrawIndirectCount       = false;
+        bool     GraphicsPipelineLibrary = false;
+        uint32_t DynamicPipelineState    = 0; // DYNAMIC_PIPELINE_STATE_* bits
+
+        std::vector<VkBool32>           PresentSupport; // One per queue family
+        std::vector<VkSurfaceFormatKHR> SurfaceFormats;
+        std::vector<VkPresentModeKHR>   PresentModes;
+
+        bool FromDiskCache = false;
+    };
+
+    struct DeviceCapabilityDatabase {
+        std::vector<DeviceCapabilities> Devices; // Enumeration order
+
+        uint32_t DiskHits          = 0;
+        uint32_t DiskMisses        = 0;
+        double   QueryMilliseconds = 0.0; // Everything queryDeviceCapabilities() took, disk included
+    };
+
+    // An empty cache path skips the disk cache, otherwise it's read first and rewritten when any device was missing from it
+    DeviceCapabilityDatabase queryDeviceCapabilities(VkInstance instance, VkSurfaceKHR surface, const std::string& cache_path);
+
+    // Throws for devices that weren't enumerated when the database was queried
+    const DeviceCapabilities& getDeviceCapabilities(const DeviceCapabilityDatabase& database, VkPhysicalDevice device);
+
+    bool hasDeviceExtension(const DeviceCapabilities& capabilities, std::string_view name);
+}
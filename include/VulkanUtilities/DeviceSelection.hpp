@@ -0,0 +1,45 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <vulkan_core.h>
+
+namespace VulkanUtilities {
+    // Compared field by field in this order, so a discrete GPU always beats an integrated one no matter how much memory either has
+    struct PhysicalDeviceScore {
+        uint32_t TypeRank            = 0; // Discrete > integrated > virtual > CPU > other
+        uint32_t OptionalFeatures    = 0; // How many of the optional features asked for it has
+        uint64_t LocalMemoryMB       = 0; // Biggest device local heap
+        uint32_t MaxImageDimension2D = 0; // Stand-in for how capable the rest of the limits are
+
+        auto operator<=>(const PhysicalDeviceScore&) const = default;
+    };
+
+    struct PhysicalDeviceCandidate {
+        VkPhysicalDevice     Device = VK_NULL_HANDLE;
+        uint32_t             Index  = 0; // Enumeration order, breaks ties so the pick doesn't change between runs
+        std::string          Name;
+        std::string          Uuid;
+        VkPhysicalDeviceType Type     = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+        bool                 Suitable = false; // Has everything that's required, unsuitable devices are never picked
+        PhysicalDeviceScore  Score;
+    };
+
+    // Best first, unsuitable devices last (equal scores keep enumeration order)
+    std::vector<PhysicalDeviceCandidate> rankPhysicalDevices(
+        VkInstance                                      instance,
+        const std::function<bool(VkPhysicalDevice)>&     is_suitable,
+        const std::function<uint32_t(VkPhysicalDevice)>& count_optional_features
+    );
+
+    // Lowercase hex, 8-4-4-4-12 like every other UUID
+    std::string formatDeviceUuid(const uint8_t (&uuid)[VK_UUID_SIZE]);
+
+    // A selector is either a UUID (dashes and case don't matter) or part of the device name (case doesn't matter)
+    bool matchesDeviceSelector(const PhysicalDeviceCandidate& candidate, const std::string& selector);
+
+    const char* getDeviceTypeName(VkPhysicalDeviceType type);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vulkan_core.h>
+
+#include "VulkanUtilities/PipelineDescription.hpp"
+
+// VK_EXT_extended_dynamic_state (and 3), fixed function state that gets set on the command buffer instead of baked into the pipeline
+//  . Descriptions that only differ in dynamic fields share a pipeline, so every bind has to be followed by cmdSetFixedFunctionState()
+//  . Extended dynamic state 2 isn't used, nothing it covers (depth bias, primitive restart, rasterizer discard) is in a description
+
+namespace VulkanUtilities {
+    // DYNAMIC_PIPELINE_STATE_* bits the device can do (blend needs both the blend enable and write mask features of 3)
+    //  . Takes the queried features, a struct for an extension the device doesn't have should be left zeroed
+    uint32_t getDynamicPipelineStateSupport(const VkPhysicalDeviceExtendedDynamicStateFeaturesEXT& dynamic_state_features, const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT& dynamic_state_3_features);
+
+    void populateExtendedDynamicStateFeatures(VkPhysicalDeviceExtendedDynamicStateFeaturesEXT& features);
+    void populateExtendedDynamicState3Features(VkPhysicalDeviceExtendedDynamicState3FeaturesEXT& features);
+
+    // Looked up once, they're called after every pipeline bind
+    struct DynamicStateCommands {
+        PFN_vkCmdSetPrimitiveTopologyEXT SetPrimitiveTopology = nullptr;
+        PFN_vkCmdSetCullModeEXT          SetCullMode          = nullptr;
+        PFN_vkCmdSetFrontFaceEXT         SetFrontFace         = nullptr;
+        PFN_vkCmdSetDepthTestEnableEXT   SetDepthTestEnable   = nullptr;
+        PFN_vkCmdSetDepthWriteEnableEXT  SetDepthWriteEnable  = nullptr;
+        PFN_vkCmdSetDepthCompareOpEXT    SetDepthCompareOp    = nullptr;
+        PFN_vkCmdSetColorBlendEnableEXT  SetColorBlendEnable  = nullptr;
+        PFN_vkCmdSetColorWriteMaskEXT    SetColorWriteMask    = nullptr;
+    };
+
+    // Only the commands for the given DYNAMIC_PIPELINE_STATE_* bits are loaded
+    DynamicStateCommands loadDynamicStateCommands(VkDevice device, uint32_t dynamic_state);
+
+    // Sets the fields covered by dynamic_state, which has to match what the bound pipeline was described with
+    void cmdSetFixedFunctionState(const DynamicStateCommands& commands, VkCommandBuffer buffer, uint32_t dynamic_state, const FixedFunctionState& state);
+}
@@ -16,4 +16,33 @@ namespace VulkanUtilities {
         VkDebugUtilsMessengerEXT     debug_messenger,
         const VkAllocationCallbacks* allocator
     );
+
+    // Debug utils object names and labels (see DebugNames.hpp for the wrappers)
+    //  . Loaded once, they stay no-ops unless VK_EXT_debug_utils was enabled on the instance
+    void loadDebugUtilsFunctions(VkInstance instance);
+
+    void setDebugUtilsObjectNameEXT(
+        VkDevice     device,
+        VkObjectType object_type,
+        uint64_t     object_handle,
+        const char*  name
+    );
+
+    void cmdBeginDebugUtilsLabelEXT(VkCommandBuffer command_buffer, const char* name);
+    void cmdEndDebugUtilsLabelEXT(VkCommandBuffer command_buffer);
+
+    // Commands
+    //  . VK_KHR_draw_indirect_count is core in 1.2, but the core version needs the Vulkan12Features struct (which can't share a pNext chain with the bindless features)
+    //  . Loaded once after the device is created, the draw is recorded every frame
+    void loadDrawIndirectCountFunctions(VkDevice device);
+
+    void cmdDrawIndexedIndirectCountKHR(
+        VkCommandBuffer command_buffer,
+        VkBuffer        buffer,
+        VkDeviceSize    offset,
+        VkBuffer        count_buffer,
+        VkDeviceSize    count_buffer_offset,
+        uint32_t        max_draw_count,
+        uint32_t        stride
+    );
 }
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <vulkan_core.h>
+
+#include "VulkanUtilities/IndexBuffer.hpp"
+
+namespace VulkanUtilities {
+    inline constexpr uint32_t INVALID_GEOMETRY_OFFSET = ~0u;
+
+    // [Offset, Offset + Count) in elements (vertices or indices, not bytes)
+    struct GeometryRange {
+        uint32_t Offset;
+        uint32_t Count;
+    };
+
+    // First-fit free list, kept sorted by offset so neighbouring holes merge back together when freed
+    struct RangeAllocator {
+        uint32_t                   Capacity = 0;
+        uint32_t                   Used     = 0;
+        std::vector<GeometryRange> FreeRanges;
+    };
+
+    RangeAllocator createRangeAllocator(uint32_t capacity);
+    uint32_t       allocateRange(RangeAllocator& allocator, uint32_t count); // INVALID_GEOMETRY_OFFSET when no hole is big enough
+    void           freeRange(RangeAllocator& allocator, GeometryRange range);
+    uint32_t       getLargestFreeRange(const RangeAllocator& allocator);
+
+    // Where a mesh lives inside the pool, Chunks are already offset so they can go straight into vkCmdDrawIndexed
+    struct MeshAllocation {
+        GeometryRange           Vertices;
+        GeometryRange           Indices;
+        std::vector<IndexChunk> Chunks;
+        bool                    Live = false;
+    };
+
+    // Handles stay valid through compaction (the ranges behind them don't, so always look them up again)
+    using MeshHandle = uint32_t;
+
+    // One vertex buffer and one index buffer shared by every mesh:
+    //  . Bound once per frame, every draw just picks its range with firstIndex/vertexOffset
+    //  . Every mesh has to use the same vertex layout and index type as the pool
+    // With a PositionStride the positions get a buffer (and binding 0) of their own, everything else goes on binding 1
+    //  . Depth-only passes then bind just the positions and don't drag the rest of the vertex through the cache
+    //  . Both streams share the same vertex ranges, so one vertexOffset works for both
+    struct GeometryPool {
+        uint32_t    VertexStride   = 0;
+        uint32_t    PositionStride = 0; // 0 means interleaved, positions live in the vertex stream with everything else
+        VkIndexType IndexType      = VK_INDEX_TYPE_UINT32;
+
+        VkBuffer       VertexBuffer   = VK_NULL_HANDLE;
+        VkDeviceMemory VertexMemory   = VK_NULL_HANDLE;
+        VkBuffer       PositionBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory PositionMemory = VK_NULL_HANDLE;
+        VkBuffer       IndexBuffer    = VK_NULL_HANDLE;
+        VkDeviceMemory IndexMemory    = VK_NULL_HANDLE;
+
+        RangeAllocator Vertices;
+        RangeAllocator Indices;
+
+        std::vector<MeshAllocation> Meshes;
+        std::vector<MeshHandle>     FreeHandles;
+    };
+
+    GeometryPool createGeometryPool(
+        VkDevice         device,
+        VkPhysicalDevice physical_device,
+        uint32_t         vertex_stride,
+        uint32_t         vertex_capacity,
+        uint32_t         index_capacity,
+        VkIndexType      index_type      = VK_INDEX_TYPE_UINT32,
+        uint32_t         position_stride = 0
+    );
+
+    void destroyGeometryPool(VkDevice device, GeometryPool& pool);
+
+    // Copies the mesh in through a staging buffer (blocking), the indices have to be packed as the pool's IndexType
+    //  . positions is only for split pools, and has to hold exactly as many vertices as vertices does
+    MeshHandle uploadMesh(
+        VkDevice                   device,
+        VkPhysicalDevice           physical_device,
+        VkCommandPool              command_pool,
+        VkQueue                    queue,
+        GeometryPool&              pool,
+        std::span<const std::byte> vertices,
+        const IndexData&           indices,
+        std::span<const std::byte> positions = {}
+    );
+
+    // The ranges are reused right away, so the GPU can't still be drawing the mesh
+    void freeMesh(GeometryPool& pool, MeshHandle mesh);
+
+    // Packs every live mesh to the front of fresh buffers (GPU copy), so the free space becomes one hole again
+    //  . Nothing can be in flight that uses the pool, the old buffers are destroyed straight away
+    void compactGeometryPool(
+        VkDevice         device,
+        VkPhysicalDevice physical_device,
+        VkCommandPool    command_pool,
+        VkQueue          queue,
+        GeometryPool&    pool
+    );
+
+    void bindGeometryPool(VkCommandBuffer command_buffer, const GeometryPool& pool);
+    void drawMesh(VkCommandBuffer command_buffer, const GeometryPool& pool, MeshHandle mesh, uint32_t instance_count = 1, uint32_t first_instance = 0);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vulkan_core.h>
+
+namespace VulkanUtilities {
+    // VK_SYSTEM_ALLOCATION_SCOPE_COMMAND through VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE
+    inline constexpr uint32_t HOST_ALLOCATION_SCOPE_COUNT = 5;
+    inline constexpr size_t   HOST_ARENA_SIZE             = 64 * 1024; // Per thread, command scope allocations that don't fit go to the heap
+
+    struct HostAllocationScopeStatistics {
+        uint64_t Allocations      = 0; // Reallocations count as one too, they always move
+        uint64_t ArenaAllocations = 0; // Part of the above that a thread's arena served
+        uint64_t Frees            = 0;
+        uint64_t TotalBytes       = 0;
+        uint64_t LiveBytes        = 0;
+        uint64_t PeakLiveBytes    = 0;
+    };
+
+    struct HostAllocatorStatistics {
+        std::array<HostAllocationScopeStatistics, HOST_ALLOCATION_SCOPE_COUNT> Scopes{};
+
+        // The driver only reports these (executable memory it allocated itself), they never go through the callbacks
+        uint64_t InternalAllocations = 0;
+        uint64_t InternalBytes       = 0;
+    };
+
+    // One set of callbacks for the whole process, everything has to be destroyed with the callbacks it was created with
+    // so it's switched on once, before the instance exists, and never off again
+    //  . Command scope allocations only live for the Vulkan call that made them, those bump a per-thread arena that rewinds once it's empty
+    //  . Everything else goes to the heap, with a small header in front to remember its size and scope
+    //  . Every scope is counted (atomically, drivers allocate from whatever thread the call came from)
+    void enableHostAllocator();
+
+    // Null (the driver's own allocator) until enableHostAllocator() was called, what every vkCreate*/vkDestroy* call passes
+    const VkAllocationCallbacks* getAllocationCallbacks();
+
+    // A snapshot, the counters keep going
+    HostAllocatorStatistics getHostAllocatorStatistics();
+
+    const char* getAllocationScopeName(VkSystemAllocationScope scope);
+}
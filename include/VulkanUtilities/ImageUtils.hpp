@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan_core.h>
+
+namespace VulkanUtilities {
+    void createImage(
+        VkDevice              device,
+        VkPhysicalDevice      physical_device,
+        uint32_t              width,
+        uint32_t              height,
+        uint32_t              mip_levels,
+        VkFormat              format,
+        VkImageUsageFlags     usage_flags,
+        VkMemoryPropertyFlags property_flags,
+        VkImage&              image,
+        VkDeviceMemory&       memory
+    );
+
+    VkImageView createImageView(
+        VkDevice           device,
+        VkImage            image,
+        VkFormat           format,
+        VkImageAspectFlags aspect_flags,
+        uint32_t           base_mip_level = 0,
+        uint32_t           mip_levels     = 1
+    );
+
+    // First candidate whose optimal tiling supports every feature, throws when there is none
+    VkFormat findSupportedFormat(VkPhysicalDevice device, const std::vector<VkFormat>& candidates, VkFormatFeatureFlags features);
+
+    // Depth formats we can both render to and sample from (the depth pyramid reads the depth buffer), best first
+    inline const std::vector<VkFormat> DEPTH_FORMAT_CANDIDATES = {
+        VK_FORMAT_D32_SFLOAT,
+        VK_FORMAT_D32_SFLOAT_S8_UINT,
+        VK_FORMAT_D24_UNORM_S8_UINT
+    };
+
+    VkFormat           findDepthFormat(VkPhysicalDevice device);
+    bool               hasStencilComponent(VkFormat format);
+    VkImageAspectFlags getDepthAspectFlags(VkFormat format); // Depth, plus stencil for the combined formats
+
+    // Full mip chain down to 1x1
+    uint32_t getMipLevelCount(uint32_t width, uint32_t height);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <vulkan_core.h>
+
+namespace VulkanUtilities {
+    // Every vertex of a 16-bit chunk has to be reachable from its VertexOffset with a uint16_t (primitive restart isn't used, so 0xFFFF is fine)
+    inline constexpr uint32_t MAX_16_BIT_INDEXED_VERTICES   = 65536;
+    inline constexpr uint32_t MIN_TRIANGLES_PER_INDEX_CHUNK = 1024; // On average, splitting falls back to 32-bit indices below this
+
+    // One vkCmdDrawIndexed worth of indices, VertexOffset is added to every index by the GPU (a.k.a. base vertex)
+    struct IndexChunk {
+        uint32_t FirstIndex;
+        uint32_t IndexCount;
+        int32_t  VertexOffset;
+    };
+
+    // Indices packed into whatever type they ended up as, ready for upload
+    struct IndexData {
+        VkIndexType             Type       = VK_INDEX_TYPE_UINT16;
+        uint32_t                IndexCount = 0;
+        std::vector<std::byte>  Data;
+        std::vector<IndexChunk> Chunks;
+    };
+
+    uint32_t    getIndexSize(VkIndexType type);
+    VkIndexType selectIndexType(uint32_t vertex_count);
+
+    // 16-bit when the mesh has few enough vertices, otherwise:
+    //  . split_large_meshes = false: 32-bit indices, one chunk
+    //  . split_large_meshes = true:  16-bit indices, cut into chunks (on triangle boundaries) whose vertices all fit in a 65536 vertex window
+    // Splitting only pays off when the vertices are in roughly the order the indices use them (see MeshUtilities::optimizeVertexFetch),
+    // when it doesn't (a triangle spanning more than 65536 vertices, or tiny chunks) this falls back to 32-bit
+    IndexData packIndices(std::span<const uint32_t> indices, uint32_t vertex_count, bool split_large_meshes = false);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan_core.h>
+
+#include "VulkanUtilities/ShaderUtils.hpp"
+
+namespace VulkanUtilities {
+    // Which fixed function fields get set on the command buffer instead of being baked in (see DynamicState.hpp)
+    inline constexpr uint32_t DYNAMIC_PIPELINE_STATE_RASTERIZATION = 1 << 0; // Cull mode, front face, topology within its class (VK_EXT_extended_dynamic_state)
+    inline constexpr uint32_t DYNAMIC_PIPELINE_STATE_DEPTH         = 1 << 1; // Depth test, write and compare op (VK_EXT_extended_dynamic_state)
+    inline constexpr uint32_t DYNAMIC_PIPELINE_STATE_BLEND         = 1 << 2; // Blend enable and color write mask (VK_EXT_extended_dynamic_state3)
+
+    // The fixed function fields extended dynamic state can take off the pipeline
+    struct FixedFunctionState {
+        VkPrimitiveTopology Topology  = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VkCullModeFlags     CullMode  = VK_CULL_MODE_BACK_BIT;
+        VkFrontFace         FrontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+        VkBool32    DepthTest    = VK_TRUE;
+        VkBool32    DepthWrite   = VK_TRUE;
+        VkCompareOp DepthCompare = VK_COMPARE_OP_LESS;
+
+        VkBool32              BlendEnable    = VK_FALSE; // Straight alpha blending when enabled
+        VkColorComponentFlags ColorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    };
+
+    // Everything a graphics pipeline is built from, as plain values (so it can be hashed, compared and handed to another thread)
+    //  . Shaders are SPIR-V paths, an empty FragmentShader makes a depth only pipeline
+    //  . Viewport and scissor are always dynamic, so they're not in here
+    //  . Fields covered by DynamicState are left out of the hash and comparisons, descriptions that only differ there share a pipeline
+    //  . So is Name, whichever description compiled the pipeline first names it
+    struct GraphicsPipelineDescription {
+        VkPipelineLayout Layout     = VK_NULL_HANDLE;
+        VkRenderPass     RenderPass = VK_NULL_HANDLE; // Any compatible render pass works with the result
+        uint32_t         Subpass    = 0;
+
+        std::string           VertexShader;
+        std::string           FragmentShader;
+        std::vector<uint32_t> FragmentConstants; // See SpecializationConstants
+
+        std::vector<VkVertexInputBindingDescription>   VertexBindings;
+        std::vector<VkVertexInputAttributeDescription> VertexAttributes;
+
+        FixedFunctionState FixedFunction;
+        uint32_t           DynamicState = 0; // DYNAMIC_PIPELINE_STATE_* bits, the device has to have the extensions enabled
+
+        std::string Name; // Debug name, the shader paths are used when it's empty
+    };
+
+    // The VK_EXT_graphics_pipeline_library parts, used to hash or compare just the fields one part is built from
+    inline constexpr VkGraphicsPipelineLibraryFlagsEXT GRAPHICS_PIPELINE_ALL_PARTS = VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT
+                                                                                   | VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT
+                                                                                   | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT
+                                                                                   | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+    bool     equalGraphicsPipelineDescriptions(const GraphicsPipelineDescription& left, const GraphicsPipelineDescription& right, VkGraphicsPipelineLibraryFlagsEXT parts = GRAPHICS_PIPELINE_ALL_PARTS);
+    uint64_t hashGraphicsPipelineDescription(const GraphicsPipelineDescription& description, VkGraphicsPipelineLibraryFlagsEXT parts = GRAPHICS_PIPELINE_ALL_PARTS);
+
+    bool operator==(const GraphicsPipelineDescription& left, const GraphicsPipelineDescription& right);
+
+    // Every create info a description turns into, filled in place (they point at each other, so it can't be copied or moved)
+    //  . Shader modules are only created for the stages asked for, destroyGraphicsPipelineState() releases them again
+    struct GraphicsPipelineState {
+        VkShaderModule          VertexModule   = VK_NULL_HANDLE;
+        VkShaderModule          FragmentModule = VK_NULL_HANDLE;
+        SpecializationConstants FragmentConstants;
+
+        std::array<VkPipelineShaderStageCreateInfo, 2> Stages{};
+        uint32_t                                       StageCount = 0;
+
+        VkPipelineVertexInputStateCreateInfo   VertexInput{};
+        VkPipelineInputAssemblyStateCreateInfo InputAssembly{};
+        VkPipelineViewportStateCreateInfo      Viewport{};
+        VkPipelineRasterizationStateCreateInfo Rasterization{};
+        VkPipelineMultisampleStateCreateInfo   Multisample{};
+        VkPipelineDepthStencilStateCreateInfo  DepthStencil{};
+        VkPipelineColorBlendAttachmentState    ColorBlendAttachment{};
+        VkPipelineColorBlendStateCreateInfo    ColorBlend{};
+
+        std::array<VkDynamicState, 10>   DynamicStates{};
+        VkPipelineDynamicStateCreateInfo Dynamic{};
+
+        GraphicsPipelineState() = default;
+
+        GraphicsPipelineState(const GraphicsPipelineState&)            = delete;
+        GraphicsPipelineState& operator=(const GraphicsPipelineState&) = delete;
+    };
+
+    // Only the shaders and dynamic states of the given parts are filled in, the rest of the fixed function state always is
+    //  . The fragment shader is skipped for depth only descriptions
+    //  . Nothing is left to destroy when it throws
+    void populateGraphicsPipelineState(VkDevice device, GraphicsPipelineState& state, const GraphicsPipelineDescription& description, VkGraphicsPipelineLibraryFlagsEXT parts = GRAPHICS_PIPELINE_ALL_PARTS);
+    void destroyGraphicsPipelineState(VkDevice device, GraphicsPipelineState& state);
+
+    // Compiles straight away on the calling thread (safe to call from several threads at once)
+    VkPipeline createGraphicsPipeline(VkDevice device, const GraphicsPipelineDescription& description);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vulkan_core.h>
+
+#include "VulkanUtilities/PipelineDescription.hpp"
+
+// VK_EXT_graphics_pipeline_library, a pipeline gets built as four separately compiled parts that are linked together at the end
+//  . Linking without VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT (a "fast link") is meant to be cheap enough to do at draw time
+//  . An optimized link redoes the cross stage work and should end up close to a monolithic pipeline, so it's done in the background
+
+namespace VulkanUtilities {
+    // Takes the features queried with both extensions available (VK_KHR_pipeline_library is a dependency, it adds VkPipelineLibraryCreateInfoKHR)
+    bool isGraphicsPipelineLibrarySupported(const VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT& features);
+    void populateGraphicsPipelineLibraryFeatures(VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT& features);
+
+    inline constexpr std::array<VkGraphicsPipelineLibraryFlagBitsEXT, 4> GRAPHICS_PIPELINE_LIBRARY_PARTS = {
+        VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+        VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+    };
+
+    // In GRAPHICS_PIPELINE_LIBRARY_PARTS order
+    using PipelineLibraryParts = std::array<VkPipeline, GRAPHICS_PIPELINE_LIBRARY_PARTS.size()>;
+
+    // Only the fields that part is built from are read (see hashGraphicsPipelineDescription())
+    VkPipeline createPipelineLibraryPart(VkDevice device, const GraphicsPipelineDescription& description, VkGraphicsPipelineLibraryFlagBitsEXT part);
+    VkPipeline linkPipelineLibraries(VkDevice device, const GraphicsPipelineDescription& description, const PipelineLibraryParts& parts, bool optimize);
+
+    struct PipelineLibraryEntry {
+        GraphicsPipelineDescription Description;
+        VkPipeline                  Library = VK_NULL_HANDLE;
+    };
+
+    struct PipelineLibraryStatistics {
+        uint32_t Hits   = 0;
+        uint32_t Misses = 0;
+
+        double CompileMilliseconds = 0.0; // Summed over every part compile
+    };
+
+    // Parts shared between pipelines, keyed by a hash of just the fields each part is built from
+    //  . Variants mostly differ in one part (the fragment shader, for specialization constants), the other three get reused
+    struct PipelineLibraryCache {
+        std::unordered_map<uint64_t, PipelineLibraryEntry> Parts;
+        PipelineLibraryStatistics                          Statistics;
+
+        std::mutex Mutex;
+    };
+
+    // Compiles whichever parts are missing on the calling thread (safe to call from several threads at once)
+    PipelineLibraryParts getPipelineLibraryParts(VkDevice device, PipelineLibraryCache& cache, const GraphicsPipelineDescription& description);
+
+    PipelineLibraryStatistics getPipelineLibraryStatistics(PipelineLibraryCache& cache);
+
+    // Pipelines linked from the parts don't need them anymore, so this can go before they do
+    void destroyPipelineLibraryCache(VkDevice device, PipelineLibraryCache& cache);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan_core.h>
+
+#include "ThreadPool.hpp"
+#include "VulkanUtilities/PipelineDescription.hpp"
+#include "VulkanUtilities/PipelineLibrary.hpp"
+
+namespace VulkanUtilities {
+    struct PipelineRegistryEntry {
+        GraphicsPipelineDescription Description;
+        VkPipeline                  Pipeline   = VK_NULL_HANDLE; // Null while it's still compiling
+        bool                        Failed     = false;          // requestPipeline() logs it once and keeps handing out the fallback, getPipeline() throws
+        bool                        Optimized  = false;          // False while a fast-linked pipeline waits on its optimized link
+        bool                        Optimizing = false;          // A worker has the optimized link, getPipeline() waits for it
+    };
+
+    struct PipelineRegistryStatistics {
+        uint32_t Hits      = 0; // Ready straight away
+        uint32_t Misses    = 0; // Had to be compiled (in the background or not)
+        uint32_t Fallbacks = 0; // Handed out the fallback because the real one wasn't ready yet
+
+        uint32_t FastLinks      = 0;
+        uint32_t OptimizedLinks = 0;
+
+        double CompileMilliseconds = 0.0; // Summed over every compile, so more than wall time with several workers
+        double LinkMilliseconds    = 0.0; // Part of the above with pipeline libraries, the rest is compiling the parts
+    };
+
+    // Every graphics pipeline, keyed by a hash of its description, owns them all (destroyPipelineRegistry() is the only place they go)
+    //  . Lookups of ready pipelines just take the lock and hash the description
+    //  . Misses compile on a pool of background threads when the caller can live with a fallback for a few frames
+    //  . With pipeline libraries a miss only compiles the parts it doesn't share with anything yet and fast-links them,
+    //    the optimized link replaces that pipeline once a worker is done with it
+    struct PipelineRegistry {
+        VkDevice Device = VK_NULL_HANDLE;
+
+        std::unordered_map<uint64_t, PipelineRegistryEntry> Entries;
+        PipelineRegistryStatistics                          Statistics;
+
+        std::mutex              Mutex;
+        std::condition_variable Compiled;
+
+        std::unique_ptr<StandardUtilities::ThreadPool> Workers;
+        std::unique_ptr<PipelineLibraryCache>          Libraries; // Null unless VK_EXT_graphics_pipeline_library is enabled
+
+        // Fast-linked pipelines an optimized link replaced, a command buffer in flight may still use them
+        std::vector<VkPipeline> Retired;
+
+        // Bumped whenever an entry gets its pipeline (or loses it to a failure, or has it swapped for the optimized one)
+        std::atomic<uint64_t> Generation = 0;
+    };
+
+    // use_libraries needs VK_EXT_graphics_pipeline_library enabled on the device
+    void createPipelineRegistry(PipelineRegistry& registry, VkDevice device, uint32_t worker_count = StandardUtilities::ThreadPool::defaultThreadCount(), bool use_libraries = false);
+
+    // Waits for whatever is still compiling (or linking), then destroys every pipeline
+    void destroyPipelineRegistry(PipelineRegistry& registry);
+
+    // Blocking, compiles on the calling thread on a miss (or waits when a worker already has it)
+    //  . Always hands back the final pipeline, with pipeline libraries that's the optimized link (the caller may keep it forever)
+    VkPipeline getPipeline(PipelineRegistry& registry, const GraphicsPipelineDescription& description);
+
+    // Never blocks on a compile, a miss gets queued on the workers and fallback comes back until it's done
+    VkPipeline requestPipeline(PipelineRegistry& registry, const GraphicsPipelineDescription& description, VkPipeline fallback);
+
+    void waitForPipelines(PipelineRegistry& registry);
+
+    // Whatever requestPipeline() handed out can be kept until this changes, it may have been the fallback or a fast-linked pipeline
+    uint64_t getPipelineRegistryGeneration(const PipelineRegistry& registry);
+
+    PipelineRegistryStatistics getPipelineRegistryStatistics(PipelineRegistry& registry);
+}
@@ -5,4 +5,14 @@
 
 namespace VulkanUtilities {
     VkShaderModule createShaderModule(VkDevice device, const std::vector<char>& shader);
+
+    // Every constant is 32 bits wide (VkBool32, int, uint or float bits), constant_id N reads Values[N]
+    //  . Info points into the vectors, so it survives a move but not a copy
+    struct SpecializationConstants {
+        std::vector<uint32_t>                 Values;
+        std::vector<VkSpecializationMapEntry> Entries;
+        VkSpecializationInfo                  Info{};
+    };
+
+    SpecializationConstants createSpecializationConstants(std::vector<uint32_t> values);
 }
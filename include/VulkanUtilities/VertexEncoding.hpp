@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vulkan_core.h>
+
+#include <glm/glm.hpp>
+
+namespace VulkanUtilities {
+    // Packed vertex attribute types (each knows its VkFormat, so they drop straight into a VertexLayout)
+    //  . R16G16B16_SFLOAT barely has any vertex fetch support, so 3D positions go in four halves (w = 1)
+    struct Half2 {
+        uint16_t Values[2];
+        static constexpr VkFormat Format = VK_FORMAT_R16G16_SFLOAT;
+    };
+
+    struct Half4 {
+        uint16_t Values[4];
+        static constexpr VkFormat Format = VK_FORMAT_R16G16B16A16_SFLOAT;
+    };
+
+    struct ColorUnorm8 {
+        uint8_t Values[4];
+        static constexpr VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM;
+    };
+
+    // Used for both UVs (as long as they stay within -1..1, tiling ones want Half2) and octahedral normals
+    //  . Octahedral decode in a shader: n = vec3(e, 1 - |e.x| - |e.y|); if (n.z < 0) n.xy = (1 - |n.yx|) * sign(n.xy); normalize(n)
+    struct Snorm16x2 {
+        int16_t Values[2];
+        static constexpr VkFormat Format = VK_FORMAT_R16G16_SNORM;
+    };
+
+    // Scalar conversions (also used for the leftovers the SIMD loops don't cover), all of them round to nearest even
+    uint16_t  floatToHalf(float value);
+    float     halfToFloat(uint16_t value);
+    uint8_t   floatToUnorm8(float value);
+    int16_t   floatToSnorm16(float value);
+    float     snorm16ToFloat(int16_t value);
+    glm::vec2 encodeOctahedral(glm::vec3 normal);
+    glm::vec3 decodeOctahedral(glm::vec2 encoded);
+
+    // Stream encoders, SSE2 (and F16C when the compiler is allowed to use it) four elements at a time
+    //  . Destination spans have to be at least as long as the source
+    void encodeHalf4(std::span<const glm::vec3> source, std::span<Half4> destination);
+    void encodeHalf2(std::span<const glm::vec2> source, std::span<Half2> destination);
+    void encodeColorsUnorm8(std::span<const glm::vec4> source, std::span<ColorUnorm8> destination);
+    void encodeSnorm16x2(std::span<const glm::vec2> source, std::span<Snorm16x2> destination);
+    void encodeOctahedralNormals(std::span<const glm::vec3> source, std::span<Snorm16x2> destination);
+
+    // Plain per-element versions of the above, kept around as the reference (and to benchmark against), the SIMD ones match them exactly
+    void encodeHalf4Scalar(std::span<const glm::vec3> source, std::span<Half4> destination);
+    void encodeHalf2Scalar(std::span<const glm::vec2> source, std::span<Half2> destination);
+    void encodeColorsUnorm8Scalar(std::span<const glm::vec4> source, std::span<ColorUnorm8> destination);
+    void encodeSnorm16x2Scalar(std::span<const glm::vec2> source, std::span<Snorm16x2> destination);
+    void encodeOctahedralNormalsScalar(std::span<const glm::vec3> source, std::span<Snorm16x2> destination);
+}
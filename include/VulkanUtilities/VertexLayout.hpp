@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vulkan_core.h>
+
+#include <glm/glm.hpp>
+
+namespace VulkanUtilities {
+    // Maps a C++ field type to the VkFormat the vertex shader reads it as
+    //  . Packed types (see VertexEncoding.hpp) carry their own "static constexpr VkFormat Format"
+    template <typename Type>
+    struct VertexFormatOf;
+
+    template <typename Type>
+        requires requires { Type::Format; }
+    struct VertexFormatOf<Type> { static constexpr VkFormat Value = Type::Format; };
+
+    template <> struct VertexFormatOf<float>     { static constexpr VkFormat Value = VK_FORMAT_R32_SFLOAT; };
+    template <> struct VertexFormatOf<glm::vec2> { static constexpr VkFormat Value = VK_FORMAT_R32G32_SFLOAT; };
+    template <> struct VertexFormatOf<glm::vec3> { static constexpr VkFormat Value = VK_FORMAT_R32G32B32_SFLOAT; };
+    template <> struct VertexFormatOf<glm::vec4> { static constexpr VkFormat Value = VK_FORMAT_R32G32B32A32_SFLOAT; };
+
+    template <typename Type, size_t FieldOffset>
+    struct VertexField {
+        using FieldType = Type;
+
+        static constexpr VkFormat Format = VertexFormatOf<Type>::Value;
+        static constexpr uint32_t Offset = static_cast<uint32_t>(FieldOffset);
+    };
+
+    // Describes a vertex struct from its field list, locations are handed out in field order:
+    //  . using Layout = VertexLayout<Vertex, VERTEX_FIELD(Vertex, Position), VERTEX_FIELD(Vertex, Color)>;
+    // So the attribute descriptions can't drift away from the struct anymore
+    template <typename Vertex, typename... Fields>
+    struct VertexLayout {
+        static constexpr uint32_t AttributeCount = sizeof...(Fields);
+
+        static constexpr VkVertexInputBindingDescription getBindingDescription(
+            const uint32_t          binding    = 0,
+            const VkVertexInputRate input_rate = VK_VERTEX_INPUT_RATE_VERTEX
+        ) {
+            return { binding, static_cast<uint32_t>(sizeof(Vertex)), input_rate };
+        }
+
+        static constexpr std::array<VkVertexInputAttributeDescription, AttributeCount> getAttributeDescriptions(
+            const uint32_t binding        = 0,
+            const uint32_t first_location = 0
+        ) {
+            std::array<VkVertexInputAttributeDescription, AttributeCount> descriptions{};
+
+            uint32_t index = 0;
+            ((descriptions[index] = { first_location + index, binding, Fields::Format, Fields::Offset }, index++), ...);
+
+            return descriptions;
+        }
+    };
+}
+
+#define VERTEX_FIELD(VertexType, Member) VulkanUtilities::VertexField<decltype(VertexType::Member), offsetof(VertexType, Member)>
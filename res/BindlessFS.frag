@@ -0,0 +1,38 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Bindless variant of HelloTriangleFS, the material comes out of the global descriptor arrays in set 1
+//  . Set 1 matches VulkanUtilities::BindlessTable (storage buffers, sampled images, samplers)
+//  . The materials always live in the first storage buffer (BINDLESS_MATERIAL_BUFFER_SLOT)
+
+struct Material {
+    vec4 tint;
+    uint textureIndex;
+    uint samplerIndex;
+    uint padding0;
+    uint padding1;
+};
+
+layout(set = 1, binding = 0) readonly buffer MaterialBuffer {
+    Material materials[];
+} storage_buffers[];
+
+layout(set = 1, binding = 1) uniform texture2D textures[];
+layout(set = 1, binding = 2) uniform sampler   samplers[];
+
+layout(push_constant) uniform ObjectPushConstants {
+    mat4 model;
+    uint materialIndex;
+} object;
+
+layout(location = 0) out vec4 outColor;
+
+layout(location = 0) in vec3 fragColor;
+
+void main() {
+    Material material = storage_buffers[0].materials[object.materialIndex];
+
+    // Textures hook in here once the vertices carry UVs:
+    //  . texture(sampler2D(textures[nonuniformEXT(material.textureIndex)], samplers[nonuniformEXT(material.samplerIndex)]), uv)
+    outColor = vec4(fragColor, 1.0) * material.tint;
+}
\ No newline at end of file
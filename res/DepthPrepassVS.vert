@@ -0,0 +1,21 @@
+#version 450
+
+// Same transform as HelloTriangleVS.vert, both are invariant so the EQUAL test in the main pass matches bit for bit
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+layout(push_constant) uniform ObjectPushConstants {
+    mat4 model;
+    uint materialIndex;
+} object;
+
+layout(location = 0) in vec2 inPosition;
+
+invariant gl_Position;
+
+void main() {
+    gl_Position = ubo.proj * ubo.view * object.model * vec4(inPosition, 0.0, 1.0);
+}
\ No newline at end of file
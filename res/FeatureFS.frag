@@ -0,0 +1,89 @@
+#version 450
+
+// HelloTriangleFS with a few optional (and deliberately expensive) features, written as an ubershader:
+//  . Unspecialized every constant stays FEATURES_FROM_UNIFORM, so the shader branches and loops on ubo.features at runtime
+//  . A specialized pipeline bakes the values in, the driver can then drop the dead branches and unroll the loops
+// The constant ids match HelloTriangle::getFeatureConstants()
+
+const uint FEATURES_FROM_UNIFORM = 0xFFFFFFFFu;
+
+layout(constant_id = 0) const uint FEATURE_FLAGS = FEATURES_FROM_UNIFORM;
+layout(constant_id = 1) const uint LIGHT_COUNT   = FEATURES_FROM_UNIFORM;
+layout(constant_id = 2) const uint NOISE_OCTAVES = FEATURES_FROM_UNIFORM;
+
+// Same bits as HelloTriangle::SHADER_FEATURE_*
+const uint FEATURE_TINT     = 1u;
+const uint FEATURE_LIGHTING = 2u;
+const uint FEATURE_NOISE    = 4u;
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4  view;
+    mat4  proj;
+    uvec4 features; // x = flags, y = light count, z = noise octaves
+} ubo;
+
+layout(push_constant) uniform ObjectPushConstants {
+    mat4 model;
+    uint materialIndex;
+} object;
+
+layout(location = 0) out vec4 outColor;
+
+layout(location = 0) in vec3 fragColor;
+
+uint featureFlags() { return FEATURE_FLAGS == FEATURES_FROM_UNIFORM ? ubo.features.x : FEATURE_FLAGS; }
+uint lightCount()   { return LIGHT_COUNT   == FEATURES_FROM_UNIFORM ? ubo.features.y : LIGHT_COUNT; }
+uint noiseOctaves() { return NOISE_OCTAVES == FEATURES_FROM_UNIFORM ? ubo.features.z : NOISE_OCTAVES; }
+
+float hash(vec2 p) {
+    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
+}
+
+float valueNoise(vec2 p) {
+    vec2 cell = floor(p);
+    vec2 f    = fract(p);
+    vec2 u    = f * f * (3.0 - 2.0 * f);
+
+    return mix(mix(hash(cell),               hash(cell + vec2(1.0, 0.0)), u.x),
+               mix(hash(cell + vec2(0.0, 1.0)), hash(cell + vec2(1.0, 1.0)), u.x), u.y);
+}
+
+void main() {
+    vec3 color = fragColor;
+
+    if ((featureFlags() & FEATURE_TINT) != 0u) {
+        float material = float(object.materialIndex);
+        color *= 0.5 + 0.5 * vec3(hash(vec2(material, 0.0)), hash(vec2(material, 1.0)), hash(vec2(material, 2.0)));
+    }
+
+    // Point lights on a golden angle spiral (in pixels), there's no light buffer to read them from
+    if ((featureFlags() & FEATURE_LIGHTING) != 0u) {
+        vec3 light = vec3(0.1);
+
+        for (uint i = 0u; i < lightCount(); i++) {
+            float angle    = float(i) * 2.399963;
+            vec2  position = vec2(400.0, 300.0) + 300.0 * sqrt(float(i + 1u) / float(lightCount())) * vec2(cos(angle), sin(angle));
+            vec2  offset   = position - gl_FragCoord.xy;
+
+            light += vec3(0.5 + 0.5 * hash(vec2(float(i), 3.0))) * 10000.0 / (dot(offset, offset) + 10000.0);
+        }
+
+        color *= light;
+    }
+
+    if ((featureFlags() & FEATURE_NOISE) != 0u) {
+        float noise     = 0.0;
+        float amplitude = 0.5;
+        vec2  p         = gl_FragCoord.xy / 64.0;
+
+        for (uint i = 0u; i < noiseOctaves(); i++) {
+            noise     += amplitude * valueNoise(p);
+            p         *= 2.0;
+            amplitude *= 0.5;
+        }
+
+        color *= 0.75 + 0.5 * noise;
+    }
+
+    outColor = vec4(color, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#version 450
+
+// Vertex shader for the GPU-driven path, the Model matrix comes out of the object buffer the culling pass read
+//  . The culling pass puts the object index in firstInstance, which ends up in gl_InstanceIndex
+
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+struct GpuObject {
+    mat4 model;
+    vec4 boundingSphere;
+    uint indexCount;
+    uint firstIndex;
+    int  vertexOffset;
+    uint materialIndex;
+};
+
+layout(set = 1, binding = 0) readonly buffer ObjectBuffer {
+    GpuObject objects[];
+};
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+
+layout(location = 0) out vec3 fragColor;
+
+void main() {
+    gl_Position = ubo.proj * ubo.view * objects[gl_InstanceIndex].model * vec4(inPosition, 0.0, 1.0);
+    fragColor = inColor;
+}
\ No newline at end of file
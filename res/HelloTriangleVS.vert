@@ -1,17 +1,24 @@
 #version 450
 
 layout(binding = 0) uniform UniformBufferObject {
-    mat4 model;
     mat4 view;
     mat4 proj;
 } ubo;
 
+layout(push_constant) uniform ObjectPushConstants {
+    mat4 model;
+    uint materialIndex;
+} object;
+
 layout(location = 0) in vec2 inPosition;
 layout(location = 1) in vec3 inColor;
 
 layout(location = 0) out vec3 fragColor;
 
+// Has to match DepthPrepassVS.vert exactly for the EQUAL depth test
+invariant gl_Position;
+
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 0.0, 1.0);
+    gl_Position = ubo.proj * ubo.view * object.model * vec4(inPosition, 0.0, 1.0);
     fragColor = inColor;
 }
\ No newline at end of file
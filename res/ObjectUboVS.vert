@@ -0,0 +1,22 @@
+#version 450
+
+// Same as HelloTriangleVS, but the Model matrix comes from a dynamic uniform buffer (used for benchmarking against push constants)
+
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+layout(binding = 1) uniform ObjectUniformBuffer {
+    mat4 model;
+} object;
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+
+layout(location = 0) out vec3 fragColor;
+
+void main() {
+    gl_Position = ubo.proj * ubo.view * object.model * vec4(inPosition, 0.0, 1.0);
+    fragColor = inColor;
+}
\ No newline at end of file
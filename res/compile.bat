@@ -1,3 +1,10 @@
 C:/VulkanSDK/1.3.275.0/Bin/glslc.exe HelloTriangleVS.vert -o vert.spv
 C:/VulkanSDK/1.3.275.0/Bin/glslc.exe HelloTriangleFS.frag -o frag.spv
+C:/VulkanSDK/1.3.275.0/Bin/glslc.exe ObjectUboVS.vert -o object_ubo_vert.spv
+C:/VulkanSDK/1.3.275.0/Bin/glslc.exe BindlessFS.frag -o bindless_frag.spv
+C:/VulkanSDK/1.3.275.0/Bin/glslc.exe CullObjectsCS.comp -o cull_comp.spv
+C:/VulkanSDK/1.3.275.0/Bin/glslc.exe GpuDrivenVS.vert -o gpu_driven_vert.spv
+C:/VulkanSDK/1.3.275.0/Bin/glslc.exe DepthPyramidCS.comp -o depth_pyramid_comp.spv
+C:/VulkanSDK/1.3.275.0/Bin/glslc.exe DepthPrepassVS.vert -o depth_prepass_vert.spv
+C:/VulkanSDK/1.3.275.0/Bin/glslc.exe FeatureFS.frag -o feature_frag.spv
 pause
\ No newline at end of file
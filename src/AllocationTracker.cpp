@@ -0,0 +1,164 @@
+#include "AllocationTracker.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace StandardUtilities {
+    struct AllocationTrackingState {
+        bool             Armed     = false;
+        bool             Recording = false; // Guards against anything the recording itself might end up calling
+        AllocationReport Report{};
+    };
+
+    static thread_local AllocationTrackingState tracking_state;
+
+    static void recordSite(AllocationReport& report, const void* address, const uint64_t bytes) {
+        for (uint32_t i = 0; i < report.SiteCount; i++) {
+            if (report.Sites[i].Address == address) {
+                report.Sites[i].Count++;
+                report.Sites[i].Bytes += bytes;
+                return;
+            }
+        }
+
+        if (report.SiteCount == MAX_ALLOCATION_SITES) {
+            report.DroppedSites++;
+            return;
+        }
+
+        report.Sites[report.SiteCount++] = { address, 1, bytes };
+    }
+
+    static void recordAllocation(const size_t size, const void* caller) {
+        AllocationTrackingState& state = tracking_state;
+
+        if (!state.Armed || state.Recording)
+            return;
+
+        state.Recording = true;
+
+        state.Report.Allocations++;
+        state.Report.Bytes += size;
+        recordSite(state.Report, caller, size);
+
+        state.Recording = false;
+    }
+
+    static void recordFree(const void* memory) {
+        if (memory && tracking_state.Armed)
+            tracking_state.Report.Frees++;
+    }
+
+    void armAllocationTracking() {
+        tracking_state.Report = {};
+        tracking_state.Armed  = true;
+    }
+
+    AllocationReport disarmAllocationTracking() {
+        tracking_state.Armed = false;
+        return tracking_state.Report;
+    }
+
+    void accumulateAllocationReport(AllocationReport& total, const AllocationReport& report) {
+        total.Allocations  += report.Allocations;
+        total.Frees        += report.Frees;
+        total.Bytes        += report.Bytes;
+        total.DroppedSites += report.DroppedSites;
+
+        for (uint32_t i = 0; i < report.SiteCount; i++) {
+            const auto& [address, count, bytes] = report.Sites[i];
+
+            recordSite(total, address, bytes);
+
+            // recordSite() counted it once, the rest of the count comes on top
+            for (uint32_t j = 0; j < total.SiteCount; j++)
+                if (total.Sites[j].Address == address)
+                    total.Sites[j].Count += count - 1;
+        }
+    }
+
+    static void* allocate(const size_t size) {
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    static void* allocateAligned(const size_t size, const size_t alignment) {
+#ifdef _WIN32
+        return _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+        // aligned_alloc wants the size to be a multiple of the alignment
+        return std::aligned_alloc(alignment, ((size == 0 ? 1 : size) + alignment - 1) / alignment * alignment);
+#endif
+    }
+
+    static void freeAligned(void* memory) {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+
+    static void* trackedNew(const size_t size, const void* caller) {
+        recordAllocation(size, caller);
+
+        if (void* memory = allocate(size))
+            return memory;
+
+        throw std::bad_alloc{};
+    }
+
+    static void* trackedNewAligned(const size_t size, const std::align_val_t alignment, const void* caller) {
+        recordAllocation(size, caller);
+
+        if (void* memory = allocateAligned(size, static_cast<size_t>(alignment)))
+            return memory;
+
+        throw std::bad_alloc{};
+    }
+
+    static void trackedDelete(void* memory) {
+        recordFree(memory);
+        std::free(memory);
+    }
+
+    static void trackedDeleteAligned(void* memory) {
+        recordFree(memory);
+        freeAligned(memory);
+    }
+}
+
+// The replacements, the caller's return address is taken here so it points at whoever used new
+using namespace StandardUtilities;
+
+void* operator new  (const size_t size) { return trackedNew(size, __builtin_return_address(0)); }
+void* operator new[](const size_t size) { return trackedNew(size, __builtin_return_address(0)); }
+
+void* operator new  (const size_t size, const std::align_val_t alignment) { return trackedNewAligned(size, alignment, __builtin_return_address(0)); }
+void* operator new[](const size_t size, const std::align_val_t alignment) { return trackedNewAligned(size, alignment, __builtin_return_address(0)); }
+
+void* operator new  (const size_t size, const std::nothrow_t&) noexcept {
+    recordAllocation(size, __builtin_return_address(0));
+    return allocate(size);
+}
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept {
+    recordAllocation(size, __builtin_return_address(0));
+    return allocate(size);
+}
+
+void operator delete  (void* memory) noexcept         { trackedDelete(memory); }
+void operator delete[](void* memory) noexcept         { trackedDelete(memory); }
+void operator delete  (void* memory, size_t) noexcept { trackedDelete(memory); }
+void operator delete[](void* memory, size_t) noexcept { trackedDelete(memory); }
+
+void operator delete  (void* memory, const std::nothrow_t&) noexcept { trackedDelete(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { trackedDelete(memory); }
+
+void operator delete  (void* memory, std::align_val_t) noexcept         { trackedDeleteAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept         { trackedDeleteAligned(memory); }
+void operator delete  (void* memory, size_t, std::align_val_t) noexcept { trackedDeleteAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { trackedDeleteAligned(memory); }
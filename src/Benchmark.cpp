@@ -0,0 +1,34 @@
+#include "Benchmark.hpp"
+
+#include "spdlog/spdlog.h"
+
+namespace Benchmark {
+    double Result::averageMilliseconds() const {
+        return Iterations == 0 ? 0.0 : TotalMilliseconds / static_cast<double>(Iterations);
+    }
+
+    Stopwatch::Stopwatch() : start_time(Clock::now()) { }
+
+    void Stopwatch::restart() {
+        start_time = Clock::now();
+    }
+
+    double Stopwatch::elapsedMilliseconds() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start_time).count();
+    }
+
+    void report(const Result& result) {
+        spdlog::info(" . [Benchmark] {}: {} iterations, {:.3f} ms total, {:.6f} ms average",
+            result.Name, result.Iterations, result.TotalMilliseconds, result.averageMilliseconds());
+    }
+
+    void report(const Result& baseline, const Result& candidate) {
+        report(baseline);
+        report(candidate);
+
+        const double candidate_average = candidate.averageMilliseconds();
+
+        if (candidate_average > 0.0)
+            spdlog::info(" . [Benchmark] {} vs {}: {:.2f}x", candidate.Name, baseline.Name, baseline.averageMilliseconds() / candidate_average);
+    }
+}
@@ -1,8 +1,10 @@
 #include "HelloTriangle.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <set>
 #include <fstream>
+#include <cstdio>
 #include <cstring>
 
 #define GLFW_INCLUDE_VULKAN
@@ -10,17 +12,20 @@
 #include "spdlog/spdlog.h"
 
 #include "StandardUtils.hpp"
+#include "TaskGraph.hpp"
 #include "VulkanUtilities/BufferUtils.hpp"
+#include "VulkanUtilities/CullingUtils.hpp"
+#include "VulkanUtilities/DebugNames.hpp"
 #include "VulkanUtilities/DebugUtils.hpp"
+#include "VulkanUtilities/DeviceSelection.hpp"
 #include "VulkanUtilities/ExtensionUtils.hpp"
+#include "VulkanUtilities/ImageUtils.hpp"
 #include "VulkanUtilities/ShaderUtils.hpp"
 
 namespace HelloTriangle {
     bool  QueueFamilyIndices::isComplete() const { return GraphicsFamilyQueue.has_value() && PresentationFamilyQueue.has_value(); }
 
     std::array<VkVertexInputAttributeDescription, 2> Vertex::getAttributeDescriptions() {
-        std::array<VkVertexInputAttributeDescription, 2> descriptions{};
-
         // Basically:
         //  . Binding:  Which bound vertex array will the data for this attribute come from
         //  . Location: Which location (in the shader) is this data bound to
@@ -30,36 +35,36 @@ namespace HelloTriangle {
         // For a list of the Formats, check here for a refresher:
         //  . https://vulkan-tutorial.com/Vertex_buffers/Vertex_input_description
 
-        descriptions[0].binding  = 0;
-        descriptions[0].location = 0;
-        descriptions[0].format   = VK_FORMAT_R32G32_SFLOAT;
-        descriptions[0].offset   = offsetof(Vertex, Position);
-
-        descriptions[1].binding  = 0;
-        descriptions[1].location = 1;
-        descriptions[1].format   = VK_FORMAT_R32G32B32_SFLOAT;
-        descriptions[1].offset   = offsetof(Vertex, Color);
+        // Locations go in field order and the formats come from the field types (see VulkanUtilities::VertexFormatOf)
+        //  . The attribute stream carries on from the location the position stream stopped at
+        const auto position  = PositionInputLayout::getAttributeDescriptions(0, 0);
+        const auto attribute = AttributeInputLayout::getAttributeDescriptions(1, PositionInputLayout::AttributeCount);
 
-        return descriptions;
+        return { position[0], attribute[0] };
     }
 
-    VkVertexInputBindingDescription Vertex::getBindingDescription() {
-        VkVertexInputBindingDescription description{};
-
-        description.binding   = 0;
-        description.stride    = sizeof(Vertex);
-        description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX; // VK_VERTEX_INPUT_RATE_INSTANCE for instanced rendering
-
-        return description;
+    std::array<VkVertexInputBindingDescription, 2> Vertex::getBindingDescriptions() {
+        return {
+            PositionInputLayout::getBindingDescription(0, VK_VERTEX_INPUT_RATE_VERTEX), // VK_VERTEX_INPUT_RATE_INSTANCE for instanced rendering
+            AttributeInputLayout::getBindingDescription(1, VK_VERTEX_INPUT_RATE_VERTEX)
+        };
     }
 
-    uint32_t helloTriangle() {
+    uint32_t helloTriangle(const int argc, char** argv) {
         try {
+            startup_stopwatch.restart();
+
+            parseArguments(argc, argv);
+            createScene();
+
             initWindow();
             initVulkan();
             mainLoop();
             cleanup();
         } catch (const std::exception& e) {
+            // Whatever validation said before things went wrong is usually the interesting part
+            VulkanUtilities::stopDebugMessageLog();
+
             spdlog::error(" . Problem: {}", e.what());
             return EXIT_FAILURE;
         }
@@ -67,6 +72,71 @@ namespace HelloTriangle {
         return EXIT_SUCCESS;
     }
 
+    void parseArguments(const int argc, char** argv) {
+        // Usage: VulkanLearning [--benchmark <name>] [--device <name|uuid>] [--bindless] [--gpu-driven] [--occlusion-culling] [--depth-prepass] [--pipeline-library] [--dynamic-state] [--no-capability-cache] [--serial-init] [--system-allocator] [--validation <level>]
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+
+            if (argument == "--benchmark" && i + 1 < argc)
+                benchmark_name = argv[++i];
+            else if (argument == "--device" && i + 1 < argc)
+                device_selector = argv[++i];
+            else if (argument == "--bindless")
+                use_bindless = true;
+            else if (argument == "--gpu-driven")
+                use_gpu_driven = true;
+            else if (argument == "--occlusion-culling")
+                use_gpu_driven = use_occlusion_culling = true;
+            else if (argument == "--depth-prepass")
+                use_depth_prepass = depth_prepass_enabled = true;
+            else if (argument == "--pipeline-library")
+                use_pipeline_libraries = true;
+            else if (argument == "--dynamic-state")
+                use_dynamic_state = true;
+            else if (argument == "--no-capability-cache")
+                use_capability_cache = false;
+            else if (argument == "--serial-init")
+                use_serial_init = true;
+            else if (argument == "--system-allocator")
+                use_host_allocator = false;
+            else if (argument == "--validation" && i + 1 < argc)
+                validation_level = parseValidationLevel(argv[++i]);
+            else
+                spdlog::warn(" . Unknown argument: {}", argument);
+        }
+    }
+
+    ValidationLevel parseValidationLevel(const std::string& name) {
+        if (name == "off")
+            return ValidationLevel::Off;
+
+        if (name == "core")
+            return ValidationLevel::Core;
+
+        if (name == "sync")
+            return ValidationLevel::Synchronization;
+
+        if (name == "best-practices")
+            return ValidationLevel::BestPractices;
+
+        if (name == "gpu-assisted")
+            return ValidationLevel::GpuAssisted;
+
+        throw std::runtime_error{"Unknown validation level: " + name};
+    }
+
+    const char* getValidationLevelName(const ValidationLevel level) {
+        switch (level) {
+            case ValidationLevel::Off:             return "off";
+            case ValidationLevel::Core:            return "core";
+            case ValidationLevel::Synchronization: return "sync";
+            case ValidationLevel::BestPractices:   return "best-practices";
+            case ValidationLevel::GpuAssisted:     return "gpu-assisted";
+        }
+
+        return "unknown";
+    }
+
     // Method Implementations
     void initWindow() {
         // Lets just assume everything works with GLFW for now...
@@ -79,29 +149,122 @@ namespace HelloTriangle {
         window = glfwCreateWindow(width, height, "Hello Triangle - Vulkan", nullptr, nullptr);
         glfwSetFramebufferSizeCallback(window, framebufferResized);
     }
+    // Every creation step is a task that only waits on what it actually reads, independent ones run side by side on a pool:
+    //  . Pipelines compile while the swapchain, its images and the depth buffer are created (the render pass only needs the formats)
+    //  . Buffers get created and uploaded meanwhile too
+    //  . Everything that records into vk_command_pool and submits to vk_graphics_queue is chained, neither one is thread safe
+    // --serial-init runs the same tasks one after the other on this thread, to compare against
     void initVulkan() {
-        createInstance();
-        setupDebugMessenger();
-        createSurface();
-        selectPhysicalDevice();
-        createLogicalDevice();
-        createSwapChain();
-        createImageViews();
-        createRenderPass();
-        createDescriptorSetLayout();
-        createGraphicsPipeline();
-        createFramebuffers();
-        createCommandPool();
-        createVertexBuffer();
-        createIndexBuffer();
-        createUniformBuffers();
-        createDescriptorPool();
-        createDescriptorSets();
+        const Benchmark::Stopwatch init_stopwatch{};
+
+        // Before anything exists, whatever gets created has to be destroyed with the same callbacks
+        if (use_host_allocator)
+            VulkanUtilities::enableHostAllocator();
+
+        vk_allocator = VulkanUtilities::getAllocationCallbacks();
+
+        // The callback only queues messages, this thread logs them
+        if (validation_level != ValidationLevel::Off)
+            VulkanUtilities::startDebugMessageLog();
+
+        StandardUtilities::TaskGraph graph;
+
+        using StandardUtilities::addTask;
+
+        const uint32_t instance        = addTask(graph, "Instance",        {},                  createInstance);
+        addTask(graph, "Debug messenger", { instance }, setupDebugMessenger);
+        const uint32_t surface         = addTask(graph, "Surface",         { instance },        createSurface);
+        const uint32_t physical_device = addTask(graph, "Physical device", { surface },         selectPhysicalDevice);
+        const uint32_t logical_device  = addTask(graph, "Logical device",  { physical_device }, createLogicalDevice);
+        const uint32_t formats         = addTask(graph, "Formats",         { physical_device }, chooseAttachmentFormats);
+
+        // chooseSwapExtent() asks GLFW for the framebuffer size, which only works from the main thread
+        const uint32_t swapchain       = addTask(graph, "Swapchain",       { logical_device, formats }, createSwapChain, true);
+        const uint32_t image_views     = addTask(graph, "Image views",     { swapchain },               createImageViews);
+        const uint32_t depth_resources = addTask(graph, "Depth resources", { swapchain },               createDepthResources);
+        const uint32_t render_pass     = addTask(graph, "Render pass",     { logical_device, formats }, createRenderPass);
+        const uint32_t set_layouts     = addTask(graph, "Set layouts",     { logical_device },          createDescriptorSetLayout);
+        const uint32_t pipelines       = addTask(graph, "Pipelines",       { render_pass, set_layouts }, createGraphicsPipeline);
+        addTask(graph, "Framebuffers", { image_views, depth_resources, render_pass }, createFramebuffers);
+
+        // The upload chain, see above
+        const uint32_t command_pool    = addTask(graph, "Command pool",    { logical_device },        createCommandPool);
+        const uint32_t geometry        = addTask(graph, "Geometry",        { command_pool },          createGeometry);
+        const uint32_t material_buffer = addTask(graph, "Material buffer", { geometry, set_layouts }, createMaterialBuffer);
+        const uint32_t depth_pyramid   = addTask(graph, "Depth pyramid",   { material_buffer, depth_resources, pipelines }, [] {
+            if (use_gpu_driven)
+                createDepthPyramidResources();
+        });
+        const uint32_t gpu_buffers     = addTask(graph, "GPU buffers",     { depth_pyramid, set_layouts }, [] {
+            if (use_gpu_driven) {
+                createGpuDrivenBuffers();
+                object_data_path = ObjectDataPath::GpuDriven;
+            }
+        });
+        addTask(graph, "Command buffers", { gpu_buffers }, createCommandBuffers);
+
+        const uint32_t uniform_buffers        = addTask(graph, "Uniform buffers",        { logical_device }, createUniformBuffers);
+        const uint32_t object_uniform_buffers = addTask(graph, "Object uniform buffers", { logical_device }, createObjectUniformBuffers);
+        const uint32_t descriptor_allocators  = addTask(graph, "Descriptor allocators",  { logical_device }, createDescriptorAllocators);
+        addTask(graph, "Descriptor sets", { descriptor_allocators, set_layouts, uniform_buffers, object_uniform_buffers }, createDescriptorSets);
+        addTask(graph, "Sync objects", { logical_device }, createSyncObjects);
+
+        std::unique_ptr<StandardUtilities::ThreadPool> workers;
+        if (!use_serial_init)
+            workers = std::make_unique<StandardUtilities::ThreadPool>();
+
+        const auto timings = StandardUtilities::runTaskGraph(graph, workers.get());
+
+        vulkan_init_milliseconds = init_stopwatch.elapsedMilliseconds();
+
+        logStartupTimeline(timings, vulkan_init_milliseconds);
+
+        // How much of startup went to asking the devices what they can do, run with --no-capability-cache to compare
+        spdlog::info("Vulkan initialized in {:.2f}ms on {} worker threads (0 is --serial-init), {:.1f}% of it on device capability queries",
+            vulkan_init_milliseconds, workers ? workers->threadCount() : 0, 100.0 * device_capabilities.QueryMilliseconds / vulkan_init_milliseconds);
+    }
+
+    // One bar per task, scaled to the whole of initVulkan(), so what overlapped (and what everything waited on) is easy to see
+    void logStartupTimeline(const std::vector<StandardUtilities::TaskTiming>& timings, const double total_milliseconds) {
+        constexpr uint32_t bar_width = 60;
+
+        spdlog::info("Startup timeline:");
+
+        auto sorted = timings;
+        std::ranges::sort(sorted, {}, &StandardUtilities::TaskTiming::StartMilliseconds);
+
+        for (const auto& [name, start, end, thread] : sorted) {
+            const auto first = static_cast<uint32_t>(start / total_milliseconds * bar_width);
+            const auto last  = std::max(first + 1, static_cast<uint32_t>(end / total_milliseconds * bar_width));
+
+            std::string bar(bar_width, ' ');
+            std::fill(bar.begin() + first, bar.begin() + std::min(last, bar_width), '#');
+
+            spdlog::info(" . |{}| {:>8.2f} - {:>8.2f}ms  thread {}  {}", bar, start, end, thread, name);
+        }
+    }
+
+    void logHostAllocatorStatistics(const VulkanUtilities::HostAllocatorStatistics& statistics) {
+        spdlog::info("Vulkan host allocations:");
+
+        for (uint32_t scope = 0; scope < VulkanUtilities::HOST_ALLOCATION_SCOPE_COUNT; scope++) {
+            const auto& [allocations, arena_allocations, frees, total_bytes, live_bytes, peak_live_bytes] = statistics.Scopes[scope];
+
+            spdlog::info(" . {:<8} {} allocations ({} from the arenas), {} frees, {}KB total, {}KB peak, {} bytes still live",
+                VulkanUtilities::getAllocationScopeName(static_cast<VkSystemAllocationScope>(scope)), allocations, arena_allocations, frees,
+                total_bytes / 1024, peak_live_bytes / 1024, live_bytes);
+        }
 
-        createCommandBuffers();
-        createSyncObjects();
+        spdlog::info(" . {} internal allocations reported by the driver, {}KB", statistics.InternalAllocations, statistics.InternalBytes / 1024);
     }
+
     void mainLoop() {
+        if (!benchmark_name.empty()) {
+            runBenchmark(benchmark_name);
+            vkDeviceWaitIdle(vk_logical_device);
+            return;
+        }
+
         while (!glfwWindowShouldClose(window)) {
             glfwPollEvents();
             drawFrame();
@@ -110,47 +273,79 @@ namespace HelloTriangle {
         vkDeviceWaitIdle(vk_logical_device);
     }
     void cleanup() {
-        if (enable_validation_layers) {
-            VulkanUtilities::destroyDebugUtilsMessengerEXT(vk_instance, vk_debug_messenger, nullptr);
+        if (validation_level != ValidationLevel::Off) {
+            VulkanUtilities::destroyDebugUtilsMessengerEXT(vk_instance, vk_debug_messenger, vk_allocator);
         }
 
         cleanupSwapChain();
 
-        //vkDestroySemaphore(vk_logical_device, image_available_semaphore, nullptr);
-        //vkDestroySemaphore(vk_logical_device, render_finished_semaphore, nullptr);
-        //vkDestroyFence(vk_logical_device, in_flight_fence, nullptr);
+        //vkDestroySemaphore(vk_logical_device, image_available_semaphore, vk_allocator);
+        //vkDestroySemaphore(vk_logical_device, render_finished_semaphore, vk_allocator);
+        //vkDestroyFence(vk_logical_device, in_flight_fence, vk_allocator);
 
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-            vkDestroySemaphore (vk_logical_device, image_available_semaphores[i], nullptr);
-            vkDestroySemaphore (vk_logical_device, render_finished_semaphores[i], nullptr);
-            vkDestroyFence     (vk_logical_device, in_flight_fences[i], nullptr);
+            vkDestroySemaphore (vk_logical_device, image_available_semaphores[i], vk_allocator);
+            vkDestroySemaphore (vk_logical_device, render_finished_semaphores[i], vk_allocator);
+            vkDestroyFence     (vk_logical_device, in_flight_fences[i], vk_allocator);
         }
 
-        vkDestroyDescriptorPool(vk_logical_device, vk_descriptor_pool, nullptr);
-        vkDestroyDescriptorSetLayout(vk_logical_device, vk_descriptor_set_layout, nullptr);
+        VulkanUtilities::destroyDescriptorSetCache(vk_logical_device, descriptor_set_cache);
+
+        VulkanUtilities::destroyTypedDescriptorTemplate(vk_logical_device, scene_descriptor_template);
+        vkDestroyDescriptorSetLayout(vk_logical_device, vk_descriptor_set_layout, vk_allocator);
+
+        if (use_bindless) {
+            VulkanUtilities::destroyBindlessTable(vk_logical_device, bindless_table);
 
-        vkDestroyCommandPool(vk_logical_device, vk_command_pool, nullptr);
+            vkDestroyBuffer(vk_logical_device, vk_material_buffer, vk_allocator);
+            vkFreeMemory(vk_logical_device, vk_material_memory, vk_allocator);
+        }
+
+        vkDestroyCommandPool(vk_logical_device, vk_command_pool, vk_allocator);
 
-        vkDestroyBuffer(vk_logical_device, vk_vertex_buffer, nullptr);
-        vkFreeMemory(vk_logical_device, vk_vertex_memory, nullptr);
+        VulkanUtilities::destroyGeometryPool(vk_logical_device, geometry_pool);
 
-        vkDestroyBuffer(vk_logical_device, vk_index_buffer, nullptr);
-        vkFreeMemory(vk_logical_device, vk_index_memory, nullptr);
+        if (use_gpu_driven) {
+            destroyGpuDrivenBuffers();
+            destroyGpuDrivenPipelines();
+        }
 
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-            vkDestroyBuffer(vk_logical_device, vk_uniform_buffers[i], nullptr);
-            vkFreeMemory(vk_logical_device, vk_uniform_memorys[i], nullptr);
+            vkDestroyBuffer(vk_logical_device, vk_uniform_buffers[i], vk_allocator);
+            vkFreeMemory(vk_logical_device, vk_uniform_memorys[i], vk_allocator);
+
+            vkDestroyBuffer(vk_logical_device, vk_object_uniform_buffers[i], vk_allocator);
+            vkFreeMemory(vk_logical_device, vk_object_uniform_memorys[i], vk_allocator);
         }
 
-        //vkDestroyDescriptorPool(vk_logical_device, vk_descriptor_pool, nullptr);
-        //vkDestroyDescriptorSetLayout(vk_logical_device, vk_descriptor_set_layout, nullptr);
+        //vkDestroyDescriptorPool(vk_logical_device, vk_descriptor_pool, vk_allocator);
+        //vkDestroyDescriptorSetLayout(vk_logical_device, vk_descriptor_set_layout, vk_allocator);
+
+        vkDestroyRenderPass(vk_logical_device, vk_render_pass, vk_allocator);
 
-        vkDestroyRenderPass(vk_logical_device, vk_render_pass, nullptr);
-        vkDestroyPipeline(vk_logical_device, vk_pipeline, nullptr);
-        vkDestroyPipelineLayout(vk_logical_device, vk_pipeline_layout, nullptr);
-        vkDestroyDevice(vk_logical_device, nullptr);
-        vkDestroySurfaceKHR(vk_instance, vk_surface, nullptr);
-        vkDestroyInstance(vk_instance, nullptr);
+        if (use_gpu_driven) {
+            vkDestroyRenderPass(vk_logical_device, vk_early_render_pass, vk_allocator);
+            vkDestroyRenderPass(vk_logical_device, vk_late_render_pass, vk_allocator);
+        }
+
+        // Every graphics pipeline (variants still compiling included) belongs to the registry
+        VulkanUtilities::destroyPipelineRegistry(pipeline_registry);
+
+        vkDestroyPipelineLayout(vk_logical_device, vk_pipeline_layout, vk_allocator);
+
+        if (use_bindless) {
+            vkDestroyPipelineLayout(vk_logical_device, vk_bindless_pipeline_layout, vk_allocator);
+        }
+        vkDestroyDevice(vk_logical_device, vk_allocator);
+        vkDestroySurfaceKHR(vk_instance, vk_surface, vk_allocator);
+        vkDestroyInstance(vk_instance, vk_allocator);
+
+        if (validation_level != ValidationLevel::Off)
+            VulkanUtilities::stopDebugMessageLog();
+
+        // Everything is gone by now, so anything still live in a scope is something the driver never gave back
+        if (vk_allocator)
+            logHostAllocatorStatistics(VulkanUtilities::getHostAllocatorStatistics());
 
         glfwDestroyWindow(window);
         glfwTerminate();
@@ -161,6 +356,8 @@ namespace HelloTriangle {
     }
 
     void drawFrame() {
+        const Benchmark::Stopwatch frame_stopwatch{};
+
         vkWaitForFences(vk_logical_device, 1, &in_flight_fences[current_frame], VK_TRUE, UINT64_MAX);
 
         uint32_t image_index = 0;
@@ -177,10 +374,18 @@ namespace HelloTriangle {
         // This has been moved down here to prevent dealocks for when VK_ERROR_OUT_OF_DATE_KHR occurs
         vkResetFences(vk_logical_device, 1, &in_flight_fences[current_frame]);
 
+        // The uniform buffer update also moves the scene objects, so it has to happen before recording (push constants are baked in)
+        updateUniformBuffer(current_frame);
+
+        if (object_data_path == ObjectDataPath::UniformBuffer)
+            updateObjectUniformBuffer(current_frame);
+
+        const Benchmark::Stopwatch record_stopwatch{};
+
         vkResetCommandBuffer(vk_command_buffers[current_frame], 0);
         recordCommandBuffer(vk_command_buffers[current_frame], image_index);
 
-        updateUniformBuffer(current_frame);
+        last_frame_statistics.RecordMilliseconds = record_stopwatch.elapsedMilliseconds();
 
         VkSubmitInfo submit_info{};
         submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -221,13 +426,99 @@ namespace HelloTriangle {
             throw std::runtime_error{"Failed to present the swapchain image"};
 
         current_frame = (current_frame + 1) % MAX_FRAMES_IN_FLIGHT;
+
+        last_frame_statistics.FrameMilliseconds = frame_stopwatch.elapsedMilliseconds();
+
+        if (!first_frame_presented) {
+            first_frame_presented = true;
+            spdlog::info("Time to first frame: {:.2f}ms", startup_stopwatch.elapsedMilliseconds());
+        }
+    }
+
+    void createScene() {
+        // Some benchmarks bring their own (much bigger) scenes
+        if (!benchmark_name.empty() && createBenchmarkScene(benchmark_name))
+            return;
+
+        scene_objects.clear();
+        scene_objects.push_back({ glm::vec3(0.0f), 1.0f, glm::mat4(1.0f), 0 });
+
+        materials.clear();
+        materials.push_back({ glm::vec4(1.0f), VulkanUtilities::BINDLESS_INVALID_INDEX, VulkanUtilities::BINDLESS_INVALID_INDEX, {} });
+    }
+
+    // Lays the objects out in a square grid that fits in the same space the single rectangle used to
+    void createGridScene(const uint32_t object_count) {
+        scene_objects.clear();
+        scene_objects.reserve(object_count);
+
+        materials.clear();
+        materials.reserve(object_count);
+
+        const auto  side    = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(object_count))));
+        const float spacing = 2.0f / static_cast<float>(side);
+
+        for (uint32_t i = 0; i < object_count; i++) {
+            const glm::vec3 position{
+                -1.0f + spacing * (static_cast<float>(i % side) + 0.5f),
+                -1.0f + spacing * (static_cast<float>(i / side) + 0.5f),
+                0.0f
+            };
+
+            scene_objects.push_back({ position, spacing * 0.8f, glm::mat4(1.0f), i });
+
+            // Every object gets its own material, which is the case bindless is meant for
+            const float shade = static_cast<float>(i) / static_cast<float>(object_count);
+            materials.push_back({ glm::vec4(shade, 1.0f - shade, 0.5f, 1.0f), VulkanUtilities::BINDLESS_INVALID_INDEX, VulkanUtilities::BINDLESS_INVALID_INDEX, {} });
+        }
+    }
+
+    // Stacks grids on top of each other (down Z, away from the camera), every layer covers the whole area so only the top one should really be visible
+    void createLayeredScene(const uint32_t object_count, const uint32_t layers) {
+        const uint32_t per_layer = std::max(object_count / layers, 1u);
+
+        createGridScene(per_layer * layers);
+
+        const auto  side    = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(per_layer))));
+        const float spacing = 2.0f / static_cast<float>(side);
+
+        for (uint32_t i = 0; i < scene_objects.size(); i++) {
+            const uint32_t layer = i / per_layer;
+            const uint32_t cell  = i % per_layer;
+
+            scene_objects[i].Position = {
+                -1.0f + spacing * (static_cast<float>(cell % side) + 0.5f),
+                -1.0f + spacing * (static_cast<float>(cell / side) + 0.5f),
+                -LAYERED_SCENE_SPACING * static_cast<float>(layer)
+            };
+
+            // Touching edges, no gaps to see the next layer through
+            scene_objects[i].Scale = spacing;
+        }
+    }
+
+    void updateSceneObjects(const float time) {
+        const glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+
+        for (auto& object : scene_objects) {
+            object.Transform = glm::translate(glm::mat4(1.0f), object.Position) * rotation;
+            object.Transform = glm::scale(object.Transform, glm::vec3(object.Scale));
+        }
     }
 
     // Vulkan stuff
     void createInstance() {
-        if (enable_validation_layers && !checkValidationLayerSupport())
+        if (validation_level != ValidationLevel::Off && !checkValidationLayerSupport())
             throw std::runtime_error{"Some requested validation layers were not available!"};
 
+        // An older layer without VK_EXT_validation_features can still do the core checks
+        if (validation_level > ValidationLevel::Core && !checkValidationFeaturesSupport()) {
+            spdlog::warn("The validation layer can't do {} validation, falling back to core", getValidationLevelName(validation_level));
+            validation_level = ValidationLevel::Core;
+        }
+
+        spdlog::info("Validation: {}", getValidationLevelName(validation_level));
+
         VkApplicationInfo vk_app_info{};
 
         vk_app_info.sType              = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -235,7 +526,7 @@ namespace HelloTriangle {
         vk_app_info.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         vk_app_info.pEngineName        = "No Engine";
         vk_app_info.engineVersion      = VK_MAKE_VERSION(1, 0, 0);
-        vk_app_info.apiVersion         = VK_VERSION_1_0;
+        vk_app_info.apiVersion         = VK_API_VERSION_1_2; // Needed for vkGetPhysicalDeviceFeatures2 (descriptor indexing queries)
 
         uint32_t available_extension_count = 0;
         vkEnumerateInstanceExtensionProperties(nullptr, &available_extension_count, nullptr);
@@ -251,13 +542,23 @@ namespace HelloTriangle {
         uint32_t     layer_count = 0;
         const char** layers      = nullptr;
 
-        if (enable_validation_layers) {
+        if (validation_level != ValidationLevel::Off) {
             layer_count = static_cast<uint32_t>(VK_VALIDATION_LAYERS.size());;
             layers = VK_VALIDATION_LAYERS.data();
         }
 
         auto extensions = getRequiredExtensions();
 
+        // Object names and labels only need the extension, capture tools tend to provide it without the layer
+        const auto extension_available = [&available_extensions](const char* name) {
+            return std::ranges::any_of(available_extensions, [name](const VkExtensionProperties& extension) { return strcmp(extension.extensionName, name) == 0; });
+        };
+
+        if (VulkanUtilities::DEBUG_NAMES_ENABLED && validation_level == ValidationLevel::Off && extension_available(VK_EXT_DEBUG_UTILS_EXTENSION_NAME))
+            extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+
+        const bool debug_utils = std::ranges::any_of(extensions, [](const char* name) { return strcmp(name, VK_EXT_DEBUG_UTILS_EXTENSION_NAME) == 0; });
+
         VkInstanceCreateInfo vk_create_info{};
 
         vk_create_info.sType                   = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -268,13 +569,27 @@ namespace HelloTriangle {
         vk_create_info.ppEnabledLayerNames     = layers;
 
         VkDebugUtilsMessengerCreateInfoEXT debug_create_info{};
-        if (enable_validation_layers) {
+        if (validation_level != ValidationLevel::Off) {
             populateDebugMessengerCreateInfo(debug_create_info);
             vk_create_info.pNext = &debug_create_info;
         }
 
-        if (const VkResult create_result = vkCreateInstance(&vk_create_info, nullptr, &vk_instance); create_result != VK_SUCCESS)
+        const std::vector<VkValidationFeatureEnableEXT> validation_features = getValidationFeatures(validation_level);
+
+        VkValidationFeaturesEXT validation_features_info{};
+        if (!validation_features.empty()) {
+            validation_features_info.sType                         = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT;
+            validation_features_info.enabledValidationFeatureCount = static_cast<uint32_t>(validation_features.size());
+            validation_features_info.pEnabledValidationFeatures    = validation_features.data();
+
+            debug_create_info.pNext = &validation_features_info;
+        }
+
+        if (const VkResult create_result = vkCreateInstance(&vk_create_info, vk_allocator, &vk_instance); create_result != VK_SUCCESS)
             throw std::runtime_error{"Failed to create Vulkan Instance!"};
+
+        if (debug_utils)
+            VulkanUtilities::loadDebugUtilsFunctions(vk_instance);
     }
 
     bool checkValidationLayerSupport() {
@@ -301,6 +616,37 @@ namespace HelloTriangle {
         return true;
     }
 
+    // The layer implements the extension itself, so it's the layer's extensions that get asked
+    bool checkValidationFeaturesSupport() {
+        uint32_t extension_count = 0;
+        vkEnumerateInstanceExtensionProperties(VK_VALIDATION_LAYERS[0], &extension_count, nullptr);
+
+        std::vector<VkExtensionProperties> extensions{extension_count};
+        vkEnumerateInstanceExtensionProperties(VK_VALIDATION_LAYERS[0], &extension_count, extensions.data());
+
+        return std::ranges::any_of(extensions, [](const VkExtensionProperties& extension) {
+            return strcmp(extension.extensionName, VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME) == 0;
+        });
+    }
+
+    // On top of the core checks, which are always on while the layer is
+    std::vector<VkValidationFeatureEnableEXT> getValidationFeatures(const ValidationLevel level) {
+        switch (level) {
+            case ValidationLevel::Synchronization:
+                return { VK_VALIDATION_FEATURE_ENABLE_SYNCHRONIZATION_VALIDATION_EXT };
+
+            case ValidationLevel::BestPractices:
+                return { VK_VALIDATION_FEATURE_ENABLE_BEST_PRACTICES_EXT };
+
+            // Reserving the binding slot keeps the instrumentation from failing when every descriptor set slot is in use
+            case ValidationLevel::GpuAssisted:
+                return { VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_EXT, VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_RESERVE_BINDING_SLOT_EXT };
+
+            default:
+                return {};
+        }
+    }
+
     std::vector<const char*> getRequiredExtensions() {
         uint32_t     glfw_extension_count = 0;
         const char** glfw_extensions      = nullptr;
@@ -309,82 +655,116 @@ namespace HelloTriangle {
 
         std::vector<const char*> extensions{glfw_extensions, glfw_extensions + glfw_extension_count};
 
-        if (enable_validation_layers) {
+        if (validation_level != ValidationLevel::Off) {
             extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
         }
 
+        if (validation_level > ValidationLevel::Core)
+            extensions.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
+
         return extensions;
     }
 
     void setupDebugMessenger() {
-        if (!enable_validation_layers)
+        if (validation_level == ValidationLevel::Off)
             return;
 
         VkDebugUtilsMessengerCreateInfoEXT create_info;
         populateDebugMessengerCreateInfo(create_info);
 
-        if (VulkanUtilities::createDebugUtilsMessengerEXT(vk_instance, &create_info, nullptr, &vk_debug_messenger) != VK_SUCCESS)
+        if (VulkanUtilities::createDebugUtilsMessengerEXT(vk_instance, &create_info, vk_allocator, &vk_debug_messenger) != VK_SUCCESS)
             throw std::runtime_error{"Failed to setup debug messenger!"};
     }
 
+    // Every device gets ranked (see VulkanUtilities::PhysicalDeviceScore) and the best suitable one wins, unless --device picks one
     void selectPhysicalDevice() {
-        uint32_t device_count = 0;
-        vkEnumeratePhysicalDevices(vk_instance, &device_count, nullptr);
+        device_capabilities = VulkanUtilities::queryDeviceCapabilities(vk_instance, vk_surface, use_capability_cache ? DEVICE_CAPABILITY_CACHE_PATH : "");
+
+        spdlog::info("Device capabilities queried in {:.2f}ms ({} from the disk cache, {} written to it)",
+            device_capabilities.QueryMilliseconds, device_capabilities.DiskHits, device_capabilities.DiskMisses);
 
-        if (device_count == 0)
+        const auto candidates = VulkanUtilities::rankPhysicalDevices(vk_instance, isDeviceSuitable, countOptionalDeviceFeatures);
+
+        if (candidates.empty())
             throw std::runtime_error{"Failed to find a GPU with Vulkan support."};
 
-        std::vector<VkPhysicalDevice> devices{device_count};
-        vkEnumeratePhysicalDevices(vk_instance, &device_count, devices.data());
+        spdlog::info("Physical devices, best first:");
+
+        for (const auto& candidate : candidates) {
+            const auto& score = candidate.Score;
 
-        for (const auto device : devices) {
-            if (isDeviceSuitable(device)) {
-                vk_physical_device = device;
+            spdlog::info(" . [{}] {} ({}, {}) - {}, {} optional features, {}MB local, {} max 2D image{}",
+                candidate.Index, candidate.Name, VulkanUtilities::getDeviceTypeName(candidate.Type), candidate.Uuid,
+                candidate.Suitable ? "suitable" : "unsuitable", score.OptionalFeatures, score.LocalMemoryMB, score.MaxImageDimension2D,
+                VulkanUtilities::matchesDeviceSelector(candidate, device_selector) ? " <- --device" : "");
+        }
+
+        for (const auto& candidate : candidates) {
+            if (!candidate.Suitable)
+                continue;
+
+            if (device_selector.empty() || VulkanUtilities::matchesDeviceSelector(candidate, device_selector)) {
+                vk_physical_device = candidate.Device;
+                spdlog::info(" . Using {}", candidate.Name);
                 break;
             }
         }
 
+        if (vk_physical_device == VK_NULL_HANDLE && !device_selector.empty())
+            throw std::runtime_error{"No suitable GPU matches --device " + device_selector + "!"};
+
         if (vk_physical_device == VK_NULL_HANDLE)
             throw std::runtime_error{"Failed to find a GPU with Suitable Vulkan support."};
+
+        const VulkanUtilities::DeviceCapabilities& capabilities = getDeviceCapabilities(vk_physical_device);
+
+        if (use_bindless && !capabilities.DescriptorIndexing) {
+            spdlog::warn(" . Descriptor indexing isn't supported by this device, bindless mode is disabled");
+            use_bindless = false;
+        }
+
+        if (use_gpu_driven && !capabilities.DrawIndirectCount) {
+            spdlog::warn(" . Indirect count draws aren't supported by this device, GPU-driven mode is disabled");
+            use_gpu_driven = false;
+        }
+
+        // The culling pass is what reads the depth pyramid
+        use_occlusion_culling = use_occlusion_culling && use_gpu_driven;
+
+        if (use_pipeline_libraries && !capabilities.GraphicsPipelineLibrary) {
+            spdlog::warn(" . Graphics pipeline libraries aren't supported by this device, pipelines are built in one piece");
+            use_pipeline_libraries = false;
+        }
+
+        if (use_dynamic_state) {
+            dynamic_pipeline_state = capabilities.DynamicPipelineState;
+
+            if (dynamic_pipeline_state == 0)
+                spdlog::warn(" . Extended dynamic state isn't supported by this device, every fixed function combination gets its own pipeline");
+        }
     }
 
-    // There other approaches to picking the device rather than "is this device suitable", such as:
-    // . Using a multimap and giving the available devices a "score" and choosing the highest scoring device.
-    // (which can be seen at https://vulkan-tutorial.com/Drawing_a_triangle/Setup/Physical_devices_and_queue_families)
+    // How many of the optional features the launch options asked for a device has, a device without them still works (the option just gets turned off)
+    uint32_t countOptionalDeviceFeatures(const VkPhysicalDevice device) {
+        const VulkanUtilities::DeviceCapabilities& capabilities = getDeviceCapabilities(device);
+
+        uint32_t count = 0;
+
+        count += use_bindless           && capabilities.DescriptorIndexing;
+        count += use_gpu_driven         && capabilities.DrawIndirectCount;
+        count += use_pipeline_libraries && capabilities.GraphicsPipelineLibrary;
+        count += use_dynamic_state      && capabilities.DynamicPipelineState != 0;
+
+        return count;
+    }
 
     // A bunch of fancy checks can be done in here to make sure this device is capable of doing what I want
     bool isDeviceSuitable(const VkPhysicalDevice device) {
-        // Contains things like:
-        //  . Name
-        //  . Type
-        //  . Supported Vulkan Version
-        VkPhysicalDeviceProperties device_properties;
-        vkGetPhysicalDeviceProperties(device, &device_properties);
-
-        // Queries optional features like:
-        //  . 64-bit floats
-        //  . Multi-viewport rendering
-        //  . Texture compression
-        VkPhysicalDeviceFeatures device_features;
-        vkGetPhysicalDeviceFeatures(device, &device_features);
-
-        // This basically means:
-        //  . The GPU is a dedicated GPU (not an integrated GPU on the CPU [like the one my laptop has])
-        //  . The GPU supports Geometry Shaders
-        // In this situation both are required
-        //return device_properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU && device_features.geometryShader;
-
-        // For now, just accept the first device (I only have one in this laptop anyways)
-        // As stated by the tutorial: "Because we're just starting out, Vulkan support is the only thing we need and therefore we'll settle for just any GPU"
-        //return true;
+        const VulkanUtilities::DeviceCapabilities& capabilities = getDeviceCapabilities(device);
 
         const bool extensions_supported = checkDeviceExtensionSupport(device);
 
-        bool swapchain_adaquate = false;
-        if (extensions_supported) {
-            auto [Capabilities, SurfaceFormats, PresentModes] = querySwapChainSupport(device);
-            swapchain_adaquate = !SurfaceFormats.empty() && !PresentModes.empty();
-        }
+        const bool swapchain_adaquate = extensions_supported && !capabilities.SurfaceFormats.empty() && !capabilities.PresentModes.empty();
 
         // Its now time for QueueFamilies!
         const QueueFamilyIndices indices = findQueueFamilies(device);
@@ -392,18 +772,9 @@ namespace HelloTriangle {
     }
 
     bool checkDeviceExtensionSupport(VkPhysicalDevice device) {
-        uint32_t extension_count = 0;
-        vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
-
-        std::vector<VkExtensionProperties> available_extensions{extension_count};
-        vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, available_extensions.data());
-
-        std::set<std::string> required_extensions{VK_REQUIRED_EXTENSIONS.begin(), VK_REQUIRED_EXTENSIONS.end()};
-
-        for (const auto& [extensionName, specVersion] : available_extensions)
-            required_extensions.erase(extensionName);
+        const VulkanUtilities::DeviceCapabilities& capabilities = getDeviceCapabilities(device);
 
-        return required_extensions.empty();
+        return std::ranges::all_of(VK_REQUIRED_EXTENSIONS, [&capabilities](const char* extension) { return VulkanUtilities::hasDeviceExtension(capabilities, extension); });
     }
 
     void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& create_info) {
@@ -417,21 +788,14 @@ namespace HelloTriangle {
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device) {
         QueueFamilyIndices indices;
 
-        uint32_t queue_count = 0;
-        vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_count, nullptr);
+        const VulkanUtilities::DeviceCapabilities& capabilities = getDeviceCapabilities(device);
 
-        std::vector<VkQueueFamilyProperties> queue_properties{queue_count};
-        vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_count, queue_properties.data());
-
-        auto i = 0;
-        for (const auto& [queueFlags, queueCount, timestampValidBits, minImageTransferGranularity] : queue_properties) {
+        uint32_t i = 0;
+        for (const auto& [queueFlags, queueCount, timestampValidBits, minImageTransferGranularity] : capabilities.QueueFamilies) {
             if (queueFlags & VK_QUEUE_GRAPHICS_BIT)
                 indices.GraphicsFamilyQueue = i;
 
-            VkBool32 presentation_supported = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, vk_surface, &presentation_supported);
-
-            if (presentation_supported)
+            if (capabilities.PresentSupport[i])
                 indices.PresentationFamilyQueue = i;
 
             if (indices.isComplete())
@@ -463,60 +827,121 @@ namespace HelloTriangle {
 
         VkPhysicalDeviceFeatures features{};
 
+        // GPU-assisted validation writes what it finds to a buffer from the instrumented shaders, every stage needs to be allowed to
+        if (validation_level == ValidationLevel::GpuAssisted) {
+            const VkPhysicalDeviceFeatures& supported = getDeviceCapabilities(vk_physical_device).Features;
+
+            features.vertexPipelineStoresAndAtomics = supported.vertexPipelineStoresAndAtomics;
+            features.fragmentStoresAndAtomics       = supported.fragmentStoresAndAtomics;
+        }
+
+        std::vector<const char*> extensions{VK_REQUIRED_EXTENSIONS.begin(), VK_REQUIRED_EXTENSIONS.end()};
+
+        // The culling pass writes one indirect command per visible object, with the object index in firstInstance
+        if (use_gpu_driven) {
+            extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+            features.multiDrawIndirect         = VK_TRUE;
+            features.drawIndirectFirstInstance = VK_TRUE;
+        }
+
+        // Optional feature structs get pushed onto the front of the pNext chain
+        void* feature_chain = nullptr;
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing_features{};
+        if (use_bindless) {
+            extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+            VulkanUtilities::populateDescriptorIndexingFeatures(indexing_features);
+
+            indexing_features.pNext = feature_chain;
+            feature_chain           = &indexing_features;
+        }
+
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT library_features{};
+        if (use_pipeline_libraries) {
+            extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+            extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+            VulkanUtilities::populateGraphicsPipelineLibraryFeatures(library_features);
+
+            library_features.pNext = feature_chain;
+            feature_chain          = &library_features;
+        }
+
+        VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamic_state_features{};
+        if (dynamic_pipeline_state & (VulkanUtilities::DYNAMIC_PIPELINE_STATE_RASTERIZATION | VulkanUtilities::DYNAMIC_PIPELINE_STATE_DEPTH)) {
+            extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+            VulkanUtilities::populateExtendedDynamicStateFeatures(dynamic_state_features);
+
+            dynamic_state_features.pNext = feature_chain;
+            feature_chain                = &dynamic_state_features;
+        }
+
+        VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state_3_features{};
+        if (dynamic_pipeline_state & VulkanUtilities::DYNAMIC_PIPELINE_STATE_BLEND) {
+            extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+            VulkanUtilities::populateExtendedDynamicState3Features(dynamic_state_3_features);
+
+            dynamic_state_3_features.pNext = feature_chain;
+            feature_chain                  = &dynamic_state_3_features;
+        }
+
         VkDeviceCreateInfo device_create_info{};
 
         device_create_info.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        device_create_info.pNext                   = feature_chain;
         device_create_info.pQueueCreateInfos       = queue_create_infos.data();
         device_create_info.queueCreateInfoCount    = static_cast<uint32_t>(queue_create_infos.size());
         device_create_info.pEnabledFeatures        = &features;
-        device_create_info.enabledExtensionCount   = static_cast<uint32_t>(VK_REQUIRED_EXTENSIONS.size());
-        device_create_info.ppEnabledExtensionNames = VK_REQUIRED_EXTENSIONS.data();
+        device_create_info.enabledExtensionCount   = static_cast<uint32_t>(extensions.size());
+        device_create_info.ppEnabledExtensionNames = extensions.data();
 
         // Used in older implementations, they are global now (and most will ignore them)
         // Just here for legacy compatability reasons
-        if (enable_validation_layers) {
+        if (validation_level != ValidationLevel::Off) {
             device_create_info.enabledLayerCount   = static_cast<uint32_t>(VK_VALIDATION_LAYERS.size());
             device_create_info.ppEnabledLayerNames = VK_VALIDATION_LAYERS.data();
         } else
             device_create_info.enabledLayerCount = 0;
 
-        if (vkCreateDevice(vk_physical_device, &device_create_info, nullptr, &vk_logical_device) != VK_SUCCESS)
+        if (vkCreateDevice(vk_physical_device, &device_create_info, vk_allocator, &vk_logical_device) != VK_SUCCESS)
             throw std::runtime_error{"Failed to create Logical Device!"};
 
         vkGetDeviceQueue(vk_logical_device, indices.GraphicsFamilyQueue.value(),     0, &vk_graphics_queue);
         vkGetDeviceQueue(vk_logical_device, indices.PresentationFamilyQueue.value(), 0, &vk_presentation_queue);
+
+        dynamic_state_commands = VulkanUtilities::loadDynamicStateCommands(vk_logical_device, dynamic_pipeline_state);
+
+        if (use_gpu_driven)
+            VulkanUtilities::loadDrawIndirectCountFunctions(vk_logical_device);
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_DEVICE, vk_logical_device,     "Logical device");
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_QUEUE,  vk_graphics_queue,     "Graphics queue");
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_QUEUE,  vk_presentation_queue, "Presentation queue");
     }
 
     void createSurface() {
-        if (glfwCreateWindowSurface(vk_instance, window, nullptr, &vk_surface) != VK_SUCCESS)
+        if (glfwCreateWindowSurface(vk_instance, window, vk_allocator, &vk_surface) != VK_SUCCESS)
             throw std::runtime_error{"Failed to create window surface!"};
     }
 
+    // The surface capabilities (current extent mostly) change with the window, so they're the only thing queried again on every swapchain rebuild
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device) {
         SwapChainSupportDetails details{};
 
         vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, vk_surface, &details.Capabilities);
 
-        uint32_t format_count = 0;
-        vkGetPhysicalDeviceSurfaceFormatsKHR(device, vk_surface, &format_count, nullptr);
-
-        if (format_count != 0) {
-            details.SurfaceFormats.resize(format_count);
-            vkGetPhysicalDeviceSurfaceFormatsKHR(device, vk_surface, &format_count, details.SurfaceFormats.data());
-        }
-
-        uint32_t present_count = 0;
-        vkGetPhysicalDeviceSurfacePresentModesKHR(device, vk_surface, &present_count, nullptr);
-
-        if (present_count != 0) {
-            details.PresentModes.resize(present_count);
-            vkGetPhysicalDeviceSurfacePresentModesKHR(device, vk_surface, &present_count, details.PresentModes.data());
-        }
+        const VulkanUtilities::DeviceCapabilities& capabilities = getDeviceCapabilities(device);
 
+        details.SurfaceFormats = capabilities.SurfaceFormats;
+        details.PresentModes   = capabilities.PresentModes;
 
         return details;
     }
 
+    const VulkanUtilities::DeviceCapabilities& getDeviceCapabilities(const VkPhysicalDevice device) {
+        return VulkanUtilities::getDeviceCapabilities(device_capabilities, device);
+    }
+
     VkSurfaceFormatKHR chooseSwapSurfaceFomat(const std::vector<VkSurfaceFormatKHR>& available_formats) {
         for (const auto& available_format : available_formats) {
             if (available_format.format     == VK_FORMAT_B8G8R8A8_SRGB &&
@@ -559,9 +984,16 @@ namespace HelloTriangle {
         return actual_extent;
     }
 
+    // Both only depend on the device, so the render pass (and with it every pipeline) doesn't have to wait on the swapchain
+    void chooseAttachmentFormats() {
+        vk_swapchain_image_format = chooseSwapSurfaceFomat(getDeviceCapabilities(vk_physical_device).SurfaceFormats).format;
+        vk_depth_format           = VulkanUtilities::findDepthFormat(vk_physical_device);
+    }
+
     void createSwapChain() {
         SwapChainSupportDetails support_details = querySwapChainSupport(vk_physical_device);
 
+        // Has to be the format chooseAttachmentFormats() picked, the render pass was built with it
         VkSurfaceFormatKHR surface_format = chooseSwapSurfaceFomat(support_details.SurfaceFormats);
         VkPresentModeKHR   present_mode   = choosePresentMode(support_details.PresentModes);
         VkExtent2D         extent         = chooseSwapExtent(support_details.Capabilities);
@@ -600,15 +1032,19 @@ namespace HelloTriangle {
         create_info.clipped        = VK_TRUE;
         create_info.oldSwapchain   = VK_NULL_HANDLE;
 
-        if (vkCreateSwapchainKHR(vk_logical_device, &create_info, nullptr, &vk_swapchain) != VK_SUCCESS)
+        if (vkCreateSwapchainKHR(vk_logical_device, &create_info, vk_allocator, &vk_swapchain) != VK_SUCCESS)
             throw std::runtime_error{"Failed to create the Swapchain!"};
 
         vkGetSwapchainImagesKHR(vk_logical_device, vk_swapchain, &image_count, nullptr);
         vk_swapchain_images.resize(image_count);
         vkGetSwapchainImagesKHR(vk_logical_device, vk_swapchain, &image_count, vk_swapchain_images.data());
 
-        vk_swapchain_image_format = surface_format.format;
-        vk_swapchain_extent       = extent;
+        vk_swapchain_extent = extent;
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_SWAPCHAIN_KHR, vk_swapchain, "Swapchain");
+
+        for (uint32_t i = 0; i < image_count; i++)
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_IMAGE, vk_swapchain_images[i], "Swapchain image", i);
     }
 
     void createImageViews() {
@@ -633,217 +1069,291 @@ namespace HelloTriangle {
             create_info.subresourceRange.baseArrayLayer = 0;
             create_info.subresourceRange.layerCount     = 1;
 
-            if (vkCreateImageView(vk_logical_device, &create_info, nullptr, &vk_swapchain_image_views[i]) != VK_SUCCESS)
+            if (vkCreateImageView(vk_logical_device, &create_info, vk_allocator, &vk_swapchain_image_views[i]) != VK_SUCCESS)
                 throw std::runtime_error{"Failed to create Image Views!"};
+
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_IMAGE_VIEW, vk_swapchain_image_views[i], "Swapchain image view", static_cast<uint32_t>(i));
         }
     }
 
     void createGraphicsPipeline() {
-        const auto vertex_bytecode   = StandardUtilities::readFile("res/vert.spv");
-        const auto fragment_bytecode = StandardUtilities::readFile("res/frag.spv");
+        VulkanUtilities::createPipelineRegistry(pipeline_registry, vk_logical_device, StandardUtilities::ThreadPool::defaultThreadCount(), use_pipeline_libraries);
 
-        VkShaderModule vertex_shader_module   = VulkanUtilities::createShaderModule(vk_logical_device, vertex_bytecode);
-        VkShaderModule fragment_shader_module = VulkanUtilities::createShaderModule(vk_logical_device, fragment_bytecode);
+        // Per-object data comes in through push constants (the fragment shader reads the material index in bindless mode)
+        VkPushConstantRange push_constant_range{};
 
-        VkPipelineShaderStageCreateInfo vertex_create_info{};
+        push_constant_range.stageFlags = OBJECT_PUSH_CONSTANT_STAGES;
+        push_constant_range.offset     = 0;
+        push_constant_range.size       = sizeof(ObjectPushConstants);
 
-        vertex_create_info.sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        vertex_create_info.stage               = VK_SHADER_STAGE_VERTEX_BIT;
-        vertex_create_info.module              = vertex_shader_module;
-        vertex_create_info.pName               = "main";
-        vertex_create_info.pSpecializationInfo = nullptr; // Default value, but really good for constant values!
+        VkPipelineLayoutCreateInfo pipeline_layout_info{};
 
-        VkPipelineShaderStageCreateInfo fragment_create_info{};
+        pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_info.setLayoutCount         = 1;
+        pipeline_layout_info.pSetLayouts            = &vk_descriptor_set_layout;
+        pipeline_layout_info.pushConstantRangeCount = 1;
+        pipeline_layout_info.pPushConstantRanges    = &push_constant_range;
 
-        fragment_create_info.sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        fragment_create_info.stage               = VK_SHADER_STAGE_FRAGMENT_BIT;
-        fragment_create_info.module              = fragment_shader_module;
-        fragment_create_info.pName               = "main";
-        fragment_create_info.pSpecializationInfo = nullptr; // Default value, but really good for constant values!
+        if (vkCreatePipelineLayout(vk_logical_device, &pipeline_layout_info, vk_allocator, &vk_pipeline_layout) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create Pipeline Layout!"};
 
-        VkPipelineShaderStageCreateInfo shader_stages[] = { vertex_create_info, fragment_create_info };
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_PIPELINE_LAYOUT, vk_pipeline_layout, "Scene pipeline layout");
 
-        auto vertex_binding_description    = Vertex::getBindingDescription();
-        auto vertex_attribute_descriptions = Vertex::getAttributeDescriptions();
+        // Both pipelines share the layout, they only differ in where the vertex shader reads the Model matrix from
+        vk_pipeline            = buildGraphicsPipeline(vk_pipeline_layout, "res/vert.spv",            "res/frag.spv", DepthMode::Test, "Scene pipeline");
+        vk_object_ubo_pipeline = buildGraphicsPipeline(vk_pipeline_layout, "res/object_ubo_vert.spv", "res/frag.spv", DepthMode::Test, "Object UBO pipeline");
 
-        VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+        if (use_feature_shader)
+            vk_feature_pipeline = buildGraphicsPipeline(vk_pipeline_layout, "res/vert.spv", "res/feature_frag.spv", DepthMode::Test, "Feature ubershader pipeline");
 
-        vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertex_input_info.vertexBindingDescriptionCount   = 1;
-        vertex_input_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertex_attribute_descriptions.size());
-        vertex_input_info.pVertexBindingDescriptions      = &vertex_binding_description;
-        vertex_input_info.pVertexAttributeDescriptions    = vertex_attribute_descriptions.data();
+        // Same layout again, the prepass pushes the same constants the main pass does
+        if (use_depth_prepass) {
+            vk_depth_prepass_pipeline = buildGraphicsPipeline(vk_pipeline_layout, "res/depth_prepass_vert.spv", "",             DepthMode::Prepass, "Depth prepass pipeline");
+            vk_depth_equal_pipeline   = buildGraphicsPipeline(vk_pipeline_layout, "res/vert.spv",               "res/frag.spv", DepthMode::Equal,   "Depth equal pipeline");
+        }
 
-        VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+        if (use_gpu_driven)
+            createGpuDrivenPipelines();
 
-        input_assembly.sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        input_assembly.topology               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        input_assembly.primitiveRestartEnable = VK_FALSE;
+        if (!use_bindless)
+            return;
 
-        VkViewport viewport{};
+        // Set 0 stays the same (so it is compatible with the normal layout), set 1 is the bindless table
+        const VkDescriptorSetLayout bindless_set_layouts[] = { vk_descriptor_set_layout, bindless_table.Layout };
 
-        viewport.x        = 0.0f;
-        viewport.y        = 0.0f;
-        viewport.width    = static_cast<float>(vk_swapchain_extent.width);
-        viewport.height   = static_cast<float>(vk_swapchain_extent.height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
+        pipeline_layout_info.setLayoutCount = 2;
+        pipeline_layout_info.pSetLayouts    = bindless_set_layouts;
 
-        VkRect2D scissor{};
-        scissor.offset = {0, 0};
-        scissor.extent   = vk_swapchain_extent;
+        if (vkCreatePipelineLayout(vk_logical_device, &pipeline_layout_info, vk_allocator, &vk_bindless_pipeline_layout) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create the bindless Pipeline Layout!"};
 
-        // There some other stuff about Dynamic states for Scissor and Viewport, but im sticking static for now
-        //  . https://vulkan-tutorial.com/en/Drawing_a_triangle/Graphics_pipeline_basics/Fixed_functions
-        VkPipelineViewportStateCreateInfo viewport_state{};
-
-        viewport_state.sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-        viewport_state.viewportCount = 1;
-        viewport_state.pViewports    = &viewport;
-        viewport_state.scissorCount  = 1;
-        viewport_state.pScissors     = &scissor;
-
-        VkPipelineRasterizationStateCreateInfo rasterizer{};
-
-        rasterizer.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizer.depthClampEnable        = VK_FALSE;
-        rasterizer.rasterizerDiscardEnable = VK_FALSE;
-        rasterizer.polygonMode             = VK_POLYGON_MODE_FILL;
-        rasterizer.lineWidth               = 1.0f; // Required for line modes (dont forget this, it broke it earlier)
-        rasterizer.cullMode                = VK_CULL_MODE_BACK_BIT;           //rasterizer.cullMode  = VK_CULL_MODE_BACK_BIT;
-        rasterizer.frontFace               = VK_FRONT_FACE_COUNTER_CLOCKWISE; //rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-        rasterizer.depthBiasEnable         = VK_FALSE;
-        rasterizer.depthBiasConstantFactor = 0.0f; // Optional
-        rasterizer.depthBiasClamp          = 0.0f; // Optional
-        rasterizer.depthBiasSlopeFactor    = 0.0f; // Optional
-
-        VkPipelineMultisampleStateCreateInfo multisampling{};
-
-        multisampling.sType                 = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-        multisampling.sampleShadingEnable   = VK_FALSE;
-        multisampling.rasterizationSamples  = VK_SAMPLE_COUNT_1_BIT;
-        multisampling.minSampleShading      = 1.0f;     // Optional
-        multisampling.pSampleMask           = nullptr;  // Optional
-        multisampling.alphaToCoverageEnable = VK_FALSE; // Optional
-        multisampling.alphaToOneEnable      = VK_FALSE; // Optional
-
-        // Not doing Depth or Stencil testing (yet), so ignore it for now
-
-        VkPipelineColorBlendAttachmentState color_blend_attachment{};
-
-        color_blend_attachment.colorWriteMask      = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        color_blend_attachment.blendEnable         = VK_FALSE;
-        color_blend_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;  // Optional
-        color_blend_attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-        color_blend_attachment.colorBlendOp        = VK_BLEND_OP_ADD;      // Optional
-        color_blend_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;  // Optional
-        color_blend_attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-        color_blend_attachment.alphaBlendOp        = VK_BLEND_OP_ADD;      // Optional
-
-        VkPipelineColorBlendStateCreateInfo color_blending{};
-
-        color_blending.sType             = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        color_blending.logicOpEnable     = VK_FALSE;
-        color_blending.logicOp           = VK_LOGIC_OP_COPY; // Optional
-        color_blending.attachmentCount   = 1;
-        color_blending.pAttachments      = &color_blend_attachment;
-        color_blending.blendConstants[0] = 0.0f; // Optional
-        color_blending.blendConstants[1] = 0.0f; // Optional
-        color_blending.blendConstants[2] = 0.0f; // Optional
-        color_blending.blendConstants[3] = 0.0f; // Optional
-
-        std::vector<VkDynamicState> dynamic_states = {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR
-        };
-        VkPipelineDynamicStateCreateInfo dynamic_state{};
-        dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamic_state.dynamicStateCount = static_cast<uint32_t>(dynamic_states.size());
-        dynamic_state.pDynamicStates = dynamic_states.data();
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_PIPELINE_LAYOUT, vk_bindless_pipeline_layout, "Bindless pipeline layout");
 
-        VkPipelineLayoutCreateInfo pipeline_layout_info{};
+        vk_bindless_pipeline = buildGraphicsPipeline(vk_bindless_pipeline_layout, "res/vert.spv", "res/bindless_frag.spv", DepthMode::Test, "Bindless pipeline");
 
-        pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipeline_layout_info.setLayoutCount         = 1;
-        pipeline_layout_info.pSetLayouts            = &vk_descriptor_set_layout;
-        pipeline_layout_info.pushConstantRangeCount = 0;       // Optional
-        pipeline_layout_info.pPushConstantRanges    = nullptr; // Optional
+        if (use_depth_prepass)
+            vk_bindless_depth_equal_pipeline = buildGraphicsPipeline(vk_bindless_pipeline_layout, "res/vert.spv", "res/bindless_frag.spv", DepthMode::Equal, "Bindless depth equal pipeline");
+    }
 
-        if (vkCreatePipelineLayout(vk_logical_device, &pipeline_layout_info, nullptr, &vk_pipeline_layout) != VK_SUCCESS)
-            throw std::runtime_error{"Failed to create Pipeline Layout!"};
+    // Constant ids 0, 1 and 2 of FeatureFS.frag
+    std::vector<uint32_t> getFeatureConstants(const ShaderFeatures& features) {
+        return { features.Flags, features.LightCount, features.NoiseOctaves };
+    }
 
-        VkGraphicsPipelineCreateInfo graphics_pipeline_info{};
+    // A new combination compiles in the background, the ubershader (which branches on ubo.Features instead) draws until it's done
+    //  . Describing the pipeline allocates (paths, constants), so once the features stop changing the last answer is handed out instead
+    //  . That answer goes stale whenever the registry's generation moves on (the variant compiled, or got swapped for its optimized link)
+    VkPipeline getFeaturePipeline(const ShaderFeatures& features) {
+        const uint64_t generation = VulkanUtilities::getPipelineRegistryGeneration(pipeline_registry);
 
-        graphics_pipeline_info.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        graphics_pipeline_info.stageCount          = 2;
-        graphics_pipeline_info.pStages             = shader_stages;
-        graphics_pipeline_info.pVertexInputState   = &vertex_input_info;
-        graphics_pipeline_info.pInputAssemblyState = &input_assembly;
-        graphics_pipeline_info.pViewportState      = &viewport_state;
-        graphics_pipeline_info.pRasterizationState = &rasterizer;
-        graphics_pipeline_info.pMultisampleState   = &multisampling;
-        graphics_pipeline_info.pDepthStencilState  = nullptr; // Optional
-        graphics_pipeline_info.pColorBlendState    = &color_blending;
-        graphics_pipeline_info.pDynamicState       = &dynamic_state;
-        graphics_pipeline_info.layout              = vk_pipeline_layout;
-        graphics_pipeline_info.renderPass          = vk_render_pass;
-        graphics_pipeline_info.subpass             = 0;
-        graphics_pipeline_info.basePipelineHandle  = VK_NULL_HANDLE; // Optional
-        graphics_pipeline_info.basePipelineIndex   = -1;             // Optional
+        if (last_feature_pipeline != VK_NULL_HANDLE && features == last_feature_request && generation == last_feature_generation)
+            return last_feature_pipeline;
 
-        if (vkCreateGraphicsPipelines(vk_logical_device, VK_NULL_HANDLE, 1, &graphics_pipeline_info, nullptr, &vk_pipeline) != VK_SUCCESS)
-            throw std::runtime_error{"Failed to create the Graphics Pipeline!"};
+        auto description = describeGraphicsPipeline(vk_pipeline_layout, "res/vert.spv", "res/feature_frag.spv", DepthMode::Test, getFeatureConstants(features));
 
+        if constexpr (VulkanUtilities::DEBUG_NAMES_ENABLED) {
+            char name[VulkanUtilities::DEBUG_NAME_LENGTH];
+            std::snprintf(name, sizeof(name), "Feature pipeline (flags %#x, %u lights, %u noise octaves)", features.Flags, features.LightCount, features.NoiseOctaves);
 
-        // Ending
-        vkDestroyShaderModule(vk_logical_device, vertex_shader_module,   nullptr);
-        vkDestroyShaderModule(vk_logical_device, fragment_shader_module, nullptr);
+            description.Name = name;
+        }
+
+        last_feature_request    = features;
+        last_feature_generation = generation; // Read before asking, a compile landing in between just means one more lookup
+        last_feature_pipeline   = VulkanUtilities::requestPipeline(pipeline_registry, description, vk_feature_pipeline);
+
+        return last_feature_pipeline;
+    }
+
+    // The fragment shader is skipped (and its path ignored) for DepthMode::Prepass, there is nothing for it to write
+    VulkanUtilities::GraphicsPipelineDescription describeGraphicsPipeline(
+        const VkPipelineLayout       layout,
+        const std::string&           vertex_shader_path,
+        const std::string&           fragment_shader_path,
+        const DepthMode              depth_mode,
+        std::vector<uint32_t>        fragment_constants
+    ) {
+        const bool depth_only = depth_mode == DepthMode::Prepass;
+
+        VulkanUtilities::GraphicsPipelineDescription description{};
+
+        description.Layout     = layout;
+        description.RenderPass = vk_render_pass;
+
+        description.VertexShader      = vertex_shader_path;
+        description.FragmentShader    = depth_only ? std::string{} : fragment_shader_path;
+        description.FragmentConstants = std::move(fragment_constants);
+
+        // Depth only passes just declare the position stream (binding 0 and location 0 come first in both)
+        const auto vertex_binding_descriptions   = Vertex::getBindingDescriptions();
+        const auto vertex_attribute_descriptions = Vertex::getAttributeDescriptions();
+
+        const size_t vertex_stream_count    = depth_only ? 1 : vertex_binding_descriptions.size();
+        const size_t vertex_attribute_count = depth_only ? PositionInputLayout::AttributeCount : vertex_attribute_descriptions.size();
+
+        description.VertexBindings.assign(vertex_binding_descriptions.begin(), vertex_binding_descriptions.begin() + vertex_stream_count);
+        description.VertexAttributes.assign(vertex_attribute_descriptions.begin(), vertex_attribute_descriptions.begin() + vertex_attribute_count);
+
+        // With extended dynamic state the Test and Equal pipelines come out as the same one
+        description.FixedFunction = getFixedFunctionState(depth_mode);
+        description.DynamicState  = dynamic_pipeline_state;
+
+        return description;
+    }
+
+    // The EQUAL pass only shades what the prepass left in the depth buffer, so it has nothing to write
+    VulkanUtilities::FixedFunctionState getFixedFunctionState(const DepthMode depth_mode) {
+        VulkanUtilities::FixedFunctionState state{};
+
+        state.DepthWrite   = depth_mode == DepthMode::Equal ? VK_FALSE : VK_TRUE;
+        state.DepthCompare = depth_mode == DepthMode::Equal ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS;
+
+        if (depth_mode == DepthMode::Prepass)
+            state.ColorWriteMask = 0;
+
+        return state;
+    }
+
+    // Has to follow every bind of a pipeline described with dynamic_pipeline_state, nothing to do without it
+    void setFixedFunctionState(const VkCommandBuffer buffer, const DepthMode depth_mode) {
+        if (dynamic_pipeline_state != 0)
+            VulkanUtilities::cmdSetFixedFunctionState(dynamic_state_commands, buffer, dynamic_pipeline_state, getFixedFunctionState(depth_mode));
+    }
+
+    // Goes through the registry, so asking for the same pipeline twice hands back the first one (under the first name)
+    VkPipeline buildGraphicsPipeline(const VkPipelineLayout layout, const std::string& vertex_shader_path, const std::string& fragment_shader_path, const DepthMode depth_mode, const char* name) {
+        auto description = describeGraphicsPipeline(layout, vertex_shader_path, fragment_shader_path, depth_mode);
+
+        description.Name = name;
+
+        return VulkanUtilities::getPipeline(pipeline_registry, description);
+    }
+
+    VkPipeline buildComputePipeline(const VkPipelineLayout layout, const std::string& compute_shader_path) {
+        const auto compute_bytecode = StandardUtilities::readFile(compute_shader_path);
+
+        VkShaderModule compute_shader_module = VulkanUtilities::createShaderModule(vk_logical_device, compute_bytecode);
+
+        VkComputePipelineCreateInfo compute_pipeline_info{};
+
+        compute_pipeline_info.sType        = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        compute_pipeline_info.stage.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        compute_pipeline_info.stage.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
+        compute_pipeline_info.stage.module = compute_shader_module;
+        compute_pipeline_info.stage.pName  = "main";
+        compute_pipeline_info.layout       = layout;
+
+        VkPipeline pipeline;
+        if (vkCreateComputePipelines(vk_logical_device, VK_NULL_HANDLE, 1, &compute_pipeline_info, vk_allocator, &pipeline) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create the Compute Pipeline!"};
+
+        vkDestroyShaderModule(vk_logical_device, compute_shader_module, vk_allocator);
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_PIPELINE, pipeline, compute_shader_path.c_str());
+
+        return pipeline;
     }
 
     void createRenderPass() {
+        vk_render_pass = buildRenderPass(VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_ATTACHMENT_STORE_OP_DONT_CARE);
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_RENDER_PASS, vk_render_pass, "Scene render pass");
+
+        // Occlusion culling splits the frame around the depth pyramid build, the early pass has to keep its depth around for it
+        if (use_gpu_driven) {
+            vk_early_render_pass = buildRenderPass(VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_ATTACHMENT_STORE_OP_STORE);
+            vk_late_render_pass  = buildRenderPass(VK_ATTACHMENT_LOAD_OP_LOAD,  VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,          VK_ATTACHMENT_STORE_OP_DONT_CARE);
+
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_RENDER_PASS, vk_early_render_pass, "Early render pass");
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_RENDER_PASS, vk_late_render_pass,  "Late render pass");
+        }
+    }
+
+    // Color + depth, one subpass. Loading means both attachments come in the way an earlier pass left them (color attachment / depth attachment optimal)
+    VkRenderPass buildRenderPass(const VkAttachmentLoadOp load_op, const VkImageLayout color_final_layout, const VkAttachmentStoreOp depth_store_op) {
+        const bool load = load_op == VK_ATTACHMENT_LOAD_OP_LOAD;
+
         VkAttachmentDescription color_attachment{};
 
         color_attachment.format         = vk_swapchain_image_format;
         color_attachment.samples        = VK_SAMPLE_COUNT_1_BIT;
-        color_attachment.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        color_attachment.loadOp         = load_op;
         color_attachment.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
         color_attachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        color_attachment.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-        color_attachment.finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        color_attachment.initialLayout  = load ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        color_attachment.finalLayout    = color_final_layout;
+
+        VkAttachmentDescription depth_attachment{};
+
+        depth_attachment.format         = vk_depth_format;
+        depth_attachment.samples        = VK_SAMPLE_COUNT_1_BIT;
+        depth_attachment.loadOp         = load_op;
+        depth_attachment.storeOp        = depth_store_op;
+        depth_attachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depth_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depth_attachment.initialLayout  = load ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        depth_attachment.finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
         VkAttachmentReference color_attachment_reference{};
 
         color_attachment_reference.attachment = 0;
         color_attachment_reference.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+        VkAttachmentReference depth_attachment_reference{};
+
+        depth_attachment_reference.attachment = 1;
+        depth_attachment_reference.layout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
         VkSubpassDescription subpass_description{};
 
-        subpass_description.pipelineBindPoint    = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        subpass_description.colorAttachmentCount = 1;
-        subpass_description.pColorAttachments    = &color_attachment_reference;
+        subpass_description.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass_description.colorAttachmentCount    = 1;
+        subpass_description.pColorAttachments       = &color_attachment_reference;
+        subpass_description.pDepthStencilAttachment = &depth_attachment_reference;
 
+        // There is only one depth image, so the previous pass's depth writes have to be done before this one touches it
         VkSubpassDependency dependency{};
 
         dependency.srcSubpass    = VK_SUBPASS_EXTERNAL;
         dependency.dstSubpass    = 0;
-        dependency.srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.srcAccessMask = 0;
-        dependency.dstStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependency.srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                   VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        const std::array<VkAttachmentDescription, 2> attachments = { color_attachment, depth_attachment };
 
         VkRenderPassCreateInfo render_pass_info{};
 
         render_pass_info.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        render_pass_info.attachmentCount = 1;
-        render_pass_info.pAttachments    = &color_attachment;
+        render_pass_info.attachmentCount = static_cast<uint32_t>(attachments.size());
+        render_pass_info.pAttachments    = attachments.data();
         render_pass_info.subpassCount    = 1;
         render_pass_info.pSubpasses      = &subpass_description;
         render_pass_info.dependencyCount = 1;
         render_pass_info.pDependencies   = &dependency;
 
-        if (vkCreateRenderPass(vk_logical_device, &render_pass_info, nullptr, &vk_render_pass) != VK_SUCCESS)
+        VkRenderPass render_pass;
+        if (vkCreateRenderPass(vk_logical_device, &render_pass_info, vk_allocator, &render_pass) != VK_SUCCESS)
             throw std::runtime_error{"Failed to create the Render Pass!"};
+
+        return render_pass;
+    }
+
+    // One depth image is enough, only one frame is ever being rasterized at a time
+    void createDepthResources() {
+        VulkanUtilities::createImage(vk_logical_device, vk_physical_device, vk_swapchain_extent.width, vk_swapchain_extent.height, 1, vk_depth_format,
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vk_depth_image, vk_depth_memory);
+
+        vk_depth_image_view   = VulkanUtilities::createImageView(vk_logical_device, vk_depth_image, vk_depth_format, VulkanUtilities::getDepthAspectFlags(vk_depth_format));
+        vk_depth_sampled_view = VulkanUtilities::createImageView(vk_logical_device, vk_depth_image, vk_depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_IMAGE,         vk_depth_image,        "Depth image");
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_DEVICE_MEMORY, vk_depth_memory,       "Depth memory");
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_IMAGE_VIEW,    vk_depth_image_view,   "Depth attachment view");
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_IMAGE_VIEW,    vk_depth_sampled_view, "Depth sampled view");
     }
 
     void createFramebuffers() {
@@ -851,20 +1361,22 @@ namespace HelloTriangle {
 
 
         for (size_t i = 0; i < vk_swapchain_image_views.size(); i++) {
-            VkImageView attachments[] = { vk_swapchain_image_views[i] };
+            const std::array<VkImageView, 2> attachments = { vk_swapchain_image_views[i], vk_depth_image_view };
 
             VkFramebufferCreateInfo framebuffer_info{};
 
             framebuffer_info.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;;
             framebuffer_info.renderPass      = vk_render_pass;
-            framebuffer_info.attachmentCount = 1;
-            framebuffer_info.pAttachments    = attachments;
+            framebuffer_info.attachmentCount = static_cast<uint32_t>(attachments.size());
+            framebuffer_info.pAttachments    = attachments.data();
             framebuffer_info.width           = vk_swapchain_extent.width;
             framebuffer_info.height          = vk_swapchain_extent.height;
             framebuffer_info.layers          = 1;
 
-            if (vkCreateFramebuffer(vk_logical_device, &framebuffer_info, nullptr, &vk_swapchain_framebuffers[i]) != VK_SUCCESS)
+            if (vkCreateFramebuffer(vk_logical_device, &framebuffer_info, vk_allocator, &vk_swapchain_framebuffers[i]) != VK_SUCCESS)
                 throw std::runtime_error{"Failed to create framebuffer!"};
+
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_FRAMEBUFFER, vk_swapchain_framebuffers[i], "Swapchain framebuffer", static_cast<uint32_t>(i));
         }
     }
 
@@ -877,8 +1389,10 @@ namespace HelloTriangle {
         create_info.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
         create_info.queueFamilyIndex = indices.GraphicsFamilyQueue.value();
 
-        if (vkCreateCommandPool(vk_logical_device, &create_info, nullptr, &vk_command_pool) != VK_SUCCESS)
+        if (vkCreateCommandPool(vk_logical_device, &create_info, vk_allocator, &vk_command_pool) != VK_SUCCESS)
             throw std::runtime_error{"Failed to create Command Pool!"};
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_COMMAND_POOL, vk_command_pool, "Graphics command pool");
     }
 
     void createCommandBuffers() {
@@ -893,6 +1407,9 @@ namespace HelloTriangle {
 
         if (vkAllocateCommandBuffers(vk_logical_device, &allocate_info, vk_command_buffers.data()) != VK_SUCCESS)
             throw std::runtime_error{"Failed to create Command Buffer!"};
+
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_COMMAND_BUFFER, vk_command_buffers[i], "Frame command buffer", i);
     }
 
     void createSyncObjects() {
@@ -908,11 +1425,17 @@ namespace HelloTriangle {
         fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-            if (vkCreateSemaphore(vk_logical_device, &semaphore_info, nullptr, &image_available_semaphores[i]) != VK_SUCCESS ||
-                vkCreateSemaphore(vk_logical_device, &semaphore_info, nullptr, &render_finished_semaphores[i]) != VK_SUCCESS ||
-                vkCreateFence(vk_logical_device, &fence_info, nullptr, &in_flight_fences[i]) != VK_SUCCESS
+            if (vkCreateSemaphore(vk_logical_device, &semaphore_info, vk_allocator, &image_available_semaphores[i]) != VK_SUCCESS ||
+                vkCreateSemaphore(vk_logical_device, &semaphore_info, vk_allocator, &render_finished_semaphores[i]) != VK_SUCCESS ||
+                vkCreateFence(vk_logical_device, &fence_info, vk_allocator, &in_flight_fences[i]) != VK_SUCCESS
                 )
                 throw std::runtime_error("failed to create frame syncronization objects!");
+
+            const auto frame = static_cast<uint32_t>(i);
+
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_SEMAPHORE, image_available_semaphores[i], "Image available", frame);
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_SEMAPHORE, render_finished_semaphores[i], "Render finished", frame);
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_FENCE,     in_flight_fences[i],           "In flight",       frame);
         }
     }
 
@@ -926,22 +1449,152 @@ namespace HelloTriangle {
         if (vkBeginCommandBuffer(buffer, &begin_info) != VK_SUCCESS)
             throw std::runtime_error{"Failed to begin command Buffer"};
 
+        const bool gpu_driven = object_data_path == ObjectDataPath::GpuDriven;
+
+        if (gpu_driven && use_occlusion_culling) {
+            recordOcclusionCulledFrame(buffer, image_index);
+        } else if (gpu_driven) {
+            // Culling is a compute pass, so it has to go before the render pass starts
+            recordCullingPass(buffer, CullingPhase::All);
+
+            {
+                const VulkanUtilities::DebugLabelScope label{ buffer, "Scene" };
+
+                beginSceneRenderPass(buffer, vk_render_pass, image_index, vk_gpu_driven_pipeline);
+                recordGpuDrivenDraws(buffer, CullingPhase::All);
+                vkCmdEndRenderPass(buffer);
+            }
+
+            recordDrawCountReadback(buffer);
+        } else {
+            const bool push_constants = object_data_path == ObjectDataPath::PushConstants;
+            const bool bindless       = use_bindless && push_constants;
+            const bool prepass        = depth_prepass_enabled && push_constants;
+
+            const VkPipelineLayout pipeline_layout = bindless ? vk_bindless_pipeline_layout : vk_pipeline_layout;
+            VkPipeline             pipeline        = prepass
+                ? (bindless ? vk_bindless_depth_equal_pipeline : vk_depth_equal_pipeline)
+                : (bindless ? vk_bindless_pipeline : push_constants ? vk_pipeline : vk_object_ubo_pipeline);
+
+            // There are no bindless or EQUAL flavours of the feature shader
+            if (use_feature_shader && push_constants && !bindless && !prepass)
+                pipeline = specialize_features ? getFeaturePipeline(shader_features) : vk_feature_pipeline;
+
+            // The prepass only ever uses the plain layout, it doesn't read materials
+            queued_pipelines[QUEUE_PIPELINE_DEPTH_PREPASS] = { vk_depth_prepass_pipeline, vk_pipeline_layout, DepthMode::Prepass };
+            queued_pipelines[QUEUE_PIPELINE_MAIN]          = { pipeline, pipeline_layout, prepass ? DepthMode::Equal : DepthMode::Test };
+
+            buildRenderQueue(prepass);
+
+            // The queue binds its own pipelines, the prepass runs inside the same render pass
+            const VulkanUtilities::DebugLabelScope label{ buffer, prepass ? "Scene (depth prepass)" : "Scene" };
+
+            beginSceneRenderPass(buffer, vk_render_pass, image_index, VK_NULL_HANDLE);
+            recordRenderQueue(buffer, push_constants, bindless);
+            vkCmdEndRenderPass(buffer);
+        }
+
+        if (vkEndCommandBuffer(buffer) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to record command buffer!"};
+    }
+
+    // One draw per object and pass, sorted so everything sharing a pipeline (then material) ends up next to each other
+    //  . Depth is view space distance, front to back, so early-z gets to reject as much as it can
+    void buildRenderQueue(const bool prepass) {
+        Rendering::resetRenderQueue(render_queue);
+
+        for (uint32_t i = 0; i < scene_objects.size(); i++) {
+            const SceneObject& object = scene_objects[i];
+            const float        depth  = -(scene_camera.View * glm::vec4(object.Position, 1.0f)).z;
+
+            // Depth first, then every pixel only runs the fragment shader for the surface that ends up visible
+            if (prepass)
+                Rendering::submitDraw(render_queue, Rendering::makeSortKey(QUEUE_PASS_DEPTH_PREPASS, QUEUE_PIPELINE_DEPTH_PREPASS, 0, depth), i);
+
+            Rendering::submitDraw(render_queue, Rendering::makeSortKey(QUEUE_PASS_OPAQUE, QUEUE_PIPELINE_MAIN, object.MaterialIndex, depth), i);
+        }
+
+        const Benchmark::Stopwatch sort_stopwatch{};
+
+        Rendering::sortRenderQueue(render_queue);
+
+        last_frame_statistics.SortMilliseconds = sort_stopwatch.elapsedMilliseconds();
+    }
+
+    // Walks the sorted queue and only binds what actually changed since the last draw
+    //  . Every mesh lives in the geometry pool, which beginSceneRenderPass() already bound once for the whole pass
+    void recordRenderQueue(const VkCommandBuffer buffer, const bool push_constants, const bool bindless) {
+        Rendering::BoundState state{};
+        VkPipelineLayout      bound_layout = VK_NULL_HANDLE;
+
+        for (const auto& [key, object_index] : render_queue.Items) {
+            const uint32_t pipeline_index  = Rendering::getSortKeyPipeline(key);
+            const auto&    [pipeline, layout, depth_mode] = queued_pipelines[pipeline_index];
+
+            if (Rendering::bindIfChanged(state, state.Pipeline, pipeline_index)) {
+                vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                setFixedFunctionState(buffer, depth_mode);
+            }
+
+            // Sets bound through a different layout can't be trusted anymore, so they all go again
+            if (layout != bound_layout) {
+                bound_layout        = layout;
+                state.DescriptorSet = Rendering::UNBOUND;
+                state.Material      = Rendering::UNBOUND;
+            }
+
+            // The UBO path needs a new dynamic offset every draw, the push constant path binds offset 0 once
+            const uint32_t dynamic_offset = push_constants ? 0 : static_cast<uint32_t>(object_index * vk_object_uniform_stride);
+
+            if (Rendering::bindIfChanged(state, state.DescriptorSet, dynamic_offset))
+                vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &vk_descriptor_sets[current_frame], 1, &dynamic_offset);
+
+            // Every material lives in the bindless table, so it's one bind per layout no matter what the key says
+            if (bindless && layout == vk_bindless_pipeline_layout && Rendering::bindIfChanged(state, state.Material, 0))
+                vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &bindless_table.Set, 0, nullptr);
+
+            if (push_constants) {
+                const SceneObject&        object = scene_objects[object_index];
+                const ObjectPushConstants object_constants{ object.Transform, object.MaterialIndex };
+
+                vkCmdPushConstants(buffer, layout, OBJECT_PUSH_CONSTANT_STAGES, 0, sizeof(ObjectPushConstants), &object_constants);
+            }
+
+            // THIS IS IT! ITS TIME FOR THE TRIANGLE!!!!!!! [now a rectangle]
+            VulkanUtilities::drawMesh(buffer, geometry_pool, quad_mesh);
+        }
+
+        last_frame_statistics.Binds = state.Statistics;
+    }
+
+    // Begins one of the scene render passes and sets up everything the draws have in common (pipeline, viewport, geometry)
+    //  . The render passes only differ in load/store ops, so they all share the swapchain framebuffers
+    //  . A null pipeline leaves binding it to the caller
+    void beginSceneRenderPass(const VkCommandBuffer buffer, const VkRenderPass render_pass, const uint32_t image_index, const VkPipeline pipeline) {
         VkRenderPassBeginInfo render_begin_info{};
 
         render_begin_info.sType               = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        render_begin_info.renderPass          = vk_render_pass;
+        render_begin_info.renderPass          = render_pass;
         render_begin_info.framebuffer         = vk_swapchain_framebuffers[image_index];
         render_begin_info.renderArea.offset = {0, 0};
         render_begin_info.renderArea.extent   = vk_swapchain_extent;
 
-        const VkClearValue clear_value{{{0.0f, 0.0f, 0.0f, 1.0f}}};
+        // Ignored by the late pass, which loads both attachments
+        std::array<VkClearValue, 2> clear_values{};
+
+        clear_values[0].color        = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        clear_values[1].depthStencil = {1.0f, 0};
 
-        render_begin_info.clearValueCount = 1;
-        render_begin_info.pClearValues    = &clear_value;
+        render_begin_info.clearValueCount = static_cast<uint32_t>(clear_values.size());
+        render_begin_info.pClearValues    = clear_values.data();
 
         vkCmdBeginRenderPass(buffer, &render_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
-        vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_pipeline);
+        // Only the GPU-driven passes bind here, and they always draw with DepthMode::Test
+        if (pipeline != VK_NULL_HANDLE) {
+            vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            setFixedFunctionState(buffer, DepthMode::Test);
+        }
 
         VkViewport viewport{};
 
@@ -961,21 +1614,8 @@ namespace HelloTriangle {
 
         vkCmdSetScissor(buffer, 0, 1, &scissor);
 
-        const VkBuffer     vertex_buffers[] { vk_vertex_buffer };
-        const VkDeviceSize offsets[] = {0};
-
-        vkCmdBindVertexBuffers(buffer, 0, 1, vertex_buffers, offsets);
-        vkCmdBindIndexBuffer(buffer, vk_index_buffer, 0, VK_INDEX_TYPE_UINT16);
-
-        vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_pipeline_layout, 0, 1, &vk_descriptor_sets[current_frame], 0, nullptr);
-
-        // THIS IS IT! ITS TIME FOR THE TRIANGLE!!!!!!! [now a rectangle]
-        vkCmdDrawIndexed(buffer, static_cast<uint32_t>(INDICES.size()), 1, 0, 0, 0);
-
-        vkCmdEndRenderPass(buffer);
-
-        if (vkEndCommandBuffer(buffer) != VK_SUCCESS)
-            throw std::runtime_error{"Failed to record command buffer!"};
+        // Every mesh lives in the geometry pool, so one bind covers all the draws
+        VulkanUtilities::bindGeometryPool(buffer, geometry_pool);
     }
 
     void recreateSwapChain() {
@@ -993,41 +1633,61 @@ namespace HelloTriangle {
 
         createSwapChain();
         createImageViews();
+        createDepthResources();
         createFramebuffers();
+
+        // The pyramid follows the depth buffer's size, and the culling sets point at it
+        if (use_gpu_driven) {
+            createDepthPyramidResources();
+            writeCullingPyramidDescriptors();
+        }
     }
 
     void cleanupSwapChain() {
+        if (use_gpu_driven)
+            destroyDepthPyramidResources();
+
+        vkDestroyImageView(vk_logical_device, vk_depth_sampled_view, vk_allocator);
+        vkDestroyImageView(vk_logical_device, vk_depth_image_view, vk_allocator);
+        vkDestroyImage(vk_logical_device, vk_depth_image, vk_allocator);
+        vkFreeMemory(vk_logical_device, vk_depth_memory, vk_allocator);
+
         for (const auto framebuffer : vk_swapchain_framebuffers)
-            vkDestroyFramebuffer(vk_logical_device, framebuffer, nullptr);
+            vkDestroyFramebuffer(vk_logical_device, framebuffer, vk_allocator);
 
         for (const auto view : vk_swapchain_image_views)
-            vkDestroyImageView(vk_logical_device, view, nullptr);
+            vkDestroyImageView(vk_logical_device, view, vk_allocator);
 
-        vkDestroySwapchainKHR(vk_logical_device, vk_swapchain, nullptr);
+        vkDestroySwapchainKHR(vk_logical_device, vk_swapchain, vk_allocator);
     }
 
-    void createVertexBuffer() {
-        const VkDeviceSize memory_size = sizeof(VERTICES[0]) * VERTICES.size();
+    void createGeometry() {
+        geometry_pool = VulkanUtilities::createGeometryPool(vk_logical_device, vk_physical_device, sizeof(VertexAttributes), GEOMETRY_POOL_VERTICES, GEOMETRY_POOL_INDICES, VK_INDEX_TYPE_UINT16, sizeof(VertexPosition));
 
-        VkBuffer       staging_buffer;
-        VkDeviceMemory staging_memory;
-        VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, memory_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, staging_buffer, staging_memory);
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, geometry_pool.VertexBuffer,   "Geometry pool vertices");
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, geometry_pool.PositionBuffer, "Geometry pool positions");
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, geometry_pool.IndexBuffer,    "Geometry pool indices");
 
-        void* data;
-        vkMapMemory(vk_logical_device, staging_memory, 0, memory_size, 0, &data);
-        memcpy(data, VERTICES.data(), memory_size);
-        vkUnmapMemory(vk_logical_device, staging_memory);
+        const auto index_data = VulkanUtilities::packIndices(INDICES, static_cast<uint32_t>(VERTICES.size()), SPLIT_LARGE_MESHES);
 
-        VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, memory_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vk_vertex_buffer, vk_vertex_memory);
+        std::vector<VertexPosition>   positions;
+        std::vector<VertexAttributes> attributes;
 
-        VulkanUtilities::copyBuffer(vk_logical_device, vk_command_pool, vk_graphics_queue, staging_buffer, vk_vertex_buffer, memory_size);
+        for (const auto& [position, color] : VERTICES) {
+            positions.push_back({ position });
+            attributes.push_back({ color });
+        }
 
-        vkDestroyBuffer(vk_logical_device, staging_buffer, nullptr);
-        vkFreeMemory(vk_logical_device, staging_memory, nullptr);
+        quad_mesh = VulkanUtilities::uploadMesh(vk_logical_device, vk_physical_device, vk_command_pool, vk_graphics_queue, geometry_pool,
+            std::as_bytes(std::span{ attributes }), index_data, std::as_bytes(std::span{ positions }));
     }
 
-    void createIndexBuffer() {
-        const VkDeviceSize memory_size = sizeof(INDICES[0]) * INDICES.size();
+    // Materials are only read through the bindless table, so without it there is nothing to upload
+    void createMaterialBuffer() {
+        if (!use_bindless)
+            return;
+
+        const VkDeviceSize memory_size = sizeof(materials[0]) * materials.size();
 
         VkBuffer       staging_buffer;
         VkDeviceMemory staging_memory;
@@ -1035,34 +1695,64 @@ namespace HelloTriangle {
 
         void* data;
         vkMapMemory(vk_logical_device, staging_memory, 0, memory_size, 0, &data);
-        memcpy(data, INDICES.data(), memory_size);
+        memcpy(data, materials.data(), memory_size);
         vkUnmapMemory(vk_logical_device, staging_memory);
 
-        VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, memory_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vk_index_buffer, vk_index_memory);
+        VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, memory_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vk_material_buffer, vk_material_memory);
+
+        VulkanUtilities::copyBuffer(vk_logical_device, vk_command_pool, vk_graphics_queue, staging_buffer, vk_material_buffer, memory_size);
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, vk_material_buffer, "Material buffer");
 
-        VulkanUtilities::copyBuffer(vk_logical_device, vk_command_pool, vk_graphics_queue, staging_buffer, vk_index_buffer, memory_size);
+        vkDestroyBuffer(vk_logical_device, staging_buffer, vk_allocator);
+        vkFreeMemory(vk_logical_device, staging_memory, vk_allocator);
 
-        vkDestroyBuffer(vk_logical_device, staging_buffer, nullptr);
-        vkFreeMemory(vk_logical_device, staging_memory, nullptr);
+        if (VulkanUtilities::registerBindlessStorageBuffer(vk_logical_device, bindless_table, vk_material_buffer, 0, memory_size) != BINDLESS_MATERIAL_BUFFER_SLOT)
+            throw std::runtime_error{"The material buffer has to be the first bindless storage buffer!"};
     }
 
     void createDescriptorSetLayout() {
-        VkDescriptorSetLayoutBinding ubo_binding{};
+        if (use_bindless)
+            bindless_table = VulkanUtilities::createBindlessTable(vk_logical_device, vk_physical_device, {});
 
-        ubo_binding.binding            = 0;
-        ubo_binding.descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        ubo_binding.descriptorCount    = 1;
-        ubo_binding.stageFlags         = VK_SHADER_STAGE_VERTEX_BIT;
-        ubo_binding.pImmutableSamplers = nullptr;
+        if (use_gpu_driven)
+            createCullingSetLayout();
+
+        const auto bindings = getSceneDescriptorBindings();
 
         VkDescriptorSetLayoutCreateInfo create_info{};
 
         create_info.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        create_info.bindingCount = 1;
-        create_info.pBindings    = &ubo_binding;
+        create_info.bindingCount = static_cast<uint32_t>(bindings.size());
+        create_info.pBindings    = bindings.data();
 
-        if (vkCreateDescriptorSetLayout(vk_logical_device, &create_info, nullptr, &vk_descriptor_set_layout) != VK_SUCCESS)
+        if (vkCreateDescriptorSetLayout(vk_logical_device, &create_info, vk_allocator, &vk_descriptor_set_layout) != VK_SUCCESS)
             throw std::runtime_error{"Failed to create descriptor set layout!"};
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, vk_descriptor_set_layout, "Scene set layout");
+
+        // The template is generated from the same bindings, so SceneDescriptorData has to mirror them
+        scene_descriptor_template = VulkanUtilities::createTypedDescriptorTemplate<SceneDescriptorData>(vk_logical_device, vk_descriptor_set_layout, bindings);
+    }
+
+    std::vector<VkDescriptorSetLayoutBinding> getSceneDescriptorBindings() {
+        std::vector<VkDescriptorSetLayoutBinding> bindings{2};
+
+        // Binding 0: View + Projection + Features (UniformBufferObject)
+        bindings[0].binding            = 0;
+        bindings[0].descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        bindings[0].descriptorCount    = 1;
+        bindings[0].stageFlags         = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT; // FeatureFS.frag reads Features
+        bindings[0].pImmutableSamplers = nullptr;
+
+        // Binding 1: Per-object Model matrices, only read by the UBO path (the offset changes per draw)
+        bindings[1].binding            = 1;
+        bindings[1].descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        bindings[1].descriptorCount    = 1;
+        bindings[1].stageFlags         = VK_SHADER_STAGE_VERTEX_BIT;
+        bindings[1].pImmutableSamplers = nullptr;
+
+        return bindings;
     }
 
     void createUniformBuffers() {
@@ -1077,6 +1767,33 @@ namespace HelloTriangle {
                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, vk_uniform_buffers[i], vk_uniform_memorys[i]);
 
             vkMapMemory(vk_logical_device, vk_uniform_memorys[i], 0, buffer_size, 0, &vk_uniform_buffers_mapped[i]);
+
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, vk_uniform_buffers[i], "Scene uniform buffer", static_cast<uint32_t>(i));
+        }
+    }
+
+    // Dynamic uniform buffer offsets have to be multiples of minUniformBufferOffsetAlignment, so every Model matrix gets padded out to that
+    void createObjectUniformBuffers() {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(vk_physical_device, &properties);
+
+        const VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment;
+
+        vk_object_uniform_stride = (sizeof(glm::mat4) + alignment - 1) & ~(alignment - 1);
+
+        const VkDeviceSize buffer_size = vk_object_uniform_stride * std::max<size_t>(scene_objects.size(), 1);
+
+        vk_object_uniform_buffers.resize(MAX_FRAMES_IN_FLIGHT);
+        vk_object_uniform_memorys.resize(MAX_FRAMES_IN_FLIGHT);
+        vk_object_uniform_buffers_mapped.resize(MAX_FRAMES_IN_FLIGHT);
+
+        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, buffer_size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, vk_object_uniform_buffers[i], vk_object_uniform_memorys[i]);
+
+            vkMapMemory(vk_logical_device, vk_object_uniform_memorys[i], 0, buffer_size, 0, &vk_object_uniform_buffers_mapped[i]);
+
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, vk_object_uniform_buffers[i], "Object uniform buffer", static_cast<uint32_t>(i));
         }
     }
 
@@ -1086,68 +1803,55 @@ namespace HelloTriangle {
         const auto  current_time = std::chrono::high_resolution_clock::now();
         const float time         = std::chrono::duration<float, std::chrono::seconds::period>(current_time - start_time).count();
 
+        // GPU-driven objects are static, their transforms were uploaded with the object buffer
+        if (object_data_path != ObjectDataPath::GpuDriven)
+            updateSceneObjects(time);
+
         UniformBufferObject ubo{};
 
-        ubo.Model      = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
         ubo.View       = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
         ubo.Projection = glm::perspective(glm::radians(45.0f), vk_swapchain_extent.width / static_cast<float>(vk_swapchain_extent.height), 0.1f, 10.0f);
 
         ubo.Projection[1][1] *= -1.0f;
 
-        memcpy(vk_uniform_buffers_mapped[current_image], &ubo, sizeof(ubo));
-    }
+        ubo.Features = glm::uvec4{ shader_features.Flags, shader_features.LightCount, shader_features.NoiseOctaves, 0 };
 
-    void createDescriptorPool() {
-        VkDescriptorPoolSize pool_size{};
+        memcpy(vk_uniform_buffers_mapped[current_image], &ubo, sizeof(ubo));
 
-        pool_size.type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        pool_size.descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+        scene_camera = ubo;
+    }
 
-        VkDescriptorPoolCreateInfo create_info{};
+    void updateObjectUniformBuffer(const uint32_t current_image) {
+        auto* destination = static_cast<std::byte*>(vk_object_uniform_buffers_mapped[current_image]);
 
-        create_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        create_info.poolSizeCount = 1;
-        create_info.pPoolSizes    = &pool_size;
-        create_info.maxSets       = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+        for (size_t i = 0; i < scene_objects.size(); i++)
+            memcpy(destination + i * vk_object_uniform_stride, &scene_objects[i].Transform, sizeof(glm::mat4));
+    }
 
-        if (vkCreateDescriptorPool(vk_logical_device, &create_info, nullptr, &vk_descriptor_pool) != VK_SUCCESS)
-            throw std::runtime_error{"Failed to create Descriptor Pool!"};
+    // Persistent sets go through the cache (allocated once per unique set of bindings)
+    //  . It grows by chaining pools, so running out of descriptors isn't a thing anymore
+    void createDescriptorAllocators() {
+        descriptor_set_cache = VulkanUtilities::createDescriptorSetCache(MAX_FRAMES_IN_FLIGHT);
     }
 
     void createDescriptorSets() {
-        std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, vk_descriptor_set_layout);
-
-        VkDescriptorSetAllocateInfo allocate_info{};
-
-        allocate_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocate_info.descriptorPool     = vk_descriptor_pool;
-        allocate_info.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-        allocate_info.pSetLayouts        = layouts.data();
-
         vk_descriptor_sets.resize(MAX_FRAMES_IN_FLIGHT);
-        if (vkAllocateDescriptorSets(vk_logical_device, &allocate_info, vk_descriptor_sets.data()) != VK_SUCCESS)
-            throw std::runtime_error{"Failed to allocate Descriptor Sets!"};
 
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-            VkDescriptorBufferInfo buffer_info{};
+            VulkanUtilities::DescriptorBinding camera_binding{};
 
-            buffer_info.buffer = vk_uniform_buffers[i];
-            buffer_info.offset = 0;
-            buffer_info.range  = sizeof(UniformBufferObject);
+            camera_binding.Binding    = 0;
+            camera_binding.Type       = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            camera_binding.BufferInfo = { vk_uniform_buffers[i], 0, sizeof(UniformBufferObject) };
 
-            VkWriteDescriptorSet descriptor_write{};
+            VulkanUtilities::DescriptorBinding object_binding{};
 
-            descriptor_write.sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptor_write.dstSet           = vk_descriptor_sets[i];
-            descriptor_write.dstBinding       = 0;
-            descriptor_write.dstArrayElement  = 0;
-            descriptor_write.descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptor_write.descriptorCount  = 1;
-            descriptor_write.pBufferInfo      = &buffer_info;
-            descriptor_write.pImageInfo       = nullptr; // Optional
-            descriptor_write.pTexelBufferView = nullptr; // Optional
+            object_binding.Binding    = 1;
+            object_binding.Type       = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            object_binding.BufferInfo = { vk_object_uniform_buffers[i], 0, sizeof(glm::mat4) };
 
-            vkUpdateDescriptorSets(vk_logical_device, 1, &descriptor_write, 0, nullptr);
+            vk_descriptor_sets[i] = VulkanUtilities::getOrCreateDescriptorSet(vk_logical_device, descriptor_set_cache, vk_descriptor_set_layout,
+                { camera_binding, object_binding }, scene_descriptor_template.Template);
         }
     }
 }
\ No newline at end of file
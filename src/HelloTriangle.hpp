@@ -1,33 +1,214 @@
 #pragma once
+#include <array>
 #include <cstdint>
 #include <optional>
+#include <string>
 #include <vector>
 #include <vulkan/vulkan_core.h>
 
 #include "GLFW/glfw3.h"
 
 #define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE // Vulkan clip space, otherwise everything in front of z = 0 gets clipped (and the depth buffer wastes half its range)
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <chrono>
 
+#include "Benchmark.hpp"
+#include "RenderQueue.hpp"
+#include "TaskGraph.hpp"
+#include "VulkanUtilities/BindlessUtils.hpp"
+#include "VulkanUtilities/DescriptorAllocator.hpp"
+#include "VulkanUtilities/DescriptorTemplates.hpp"
+#include "VulkanUtilities/DeviceCapabilities.hpp"
+#include "VulkanUtilities/DynamicState.hpp"
+#include "VulkanUtilities/DepthPyramid.hpp"
+#include "VulkanUtilities/GeometryPool.hpp"
+#include "VulkanUtilities/HostAllocator.hpp"
+#include "VulkanUtilities/IndexBuffer.hpp"
+#include "VulkanUtilities/PipelineRegistry.hpp"
+#include "VulkanUtilities/ShaderUtils.hpp"
+#include "VulkanUtilities/VertexLayout.hpp"
+
 // Initial Learning of Vulkan (Chapter 1)
 
 namespace HelloTriangle {
     // Structures
+    // What meshes are written as, it gets split into the two streams below on upload
     struct Vertex {
         glm::vec2 Position;
         glm::vec3 Color;
 
-        static VkVertexInputBindingDescription                  getBindingDescription();
+        static std::array<VkVertexInputBindingDescription, 2>   getBindingDescriptions();
         static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions();
     };
 
+    // On the GPU positions get their own stream (binding 0), so depth-only passes never fetch the rest (binding 1)
+    struct VertexPosition {
+        glm::vec2 Position;
+    };
+
+    struct VertexAttributes {
+        glm::vec3 Color;
+    };
+
+    // Attribute descriptions are generated from these, so adding a field to Vertex means adding it to one of the streams too
+    using PositionInputLayout  = VulkanUtilities::VertexLayout<VertexPosition,   VERTEX_FIELD(VertexPosition, Position)>;
+    using AttributeInputLayout = VulkanUtilities::VertexLayout<VertexAttributes, VERTEX_FIELD(VertexAttributes, Color)>;
+
+    // Per-frame data shared by every draw (the per-object Model matrix lives in ObjectPushConstants now)
     struct UniformBufferObject {
+        alignas(16) glm::mat4  View;
+        alignas(16) glm::mat4  Projection;
+        alignas(16) glm::uvec4 Features; // ShaderFeatures, for the unspecialized FeatureFS.frag (x = flags, y = lights, z = octaves)
+    };
+
+    // Optional FeatureFS.frag features, either read from the uniform buffer or baked into a pipeline variant
+    inline constexpr uint32_t SHADER_FEATURE_TINT     = 1 << 0;
+    inline constexpr uint32_t SHADER_FEATURE_LIGHTING = 1 << 1;
+    inline constexpr uint32_t SHADER_FEATURE_NOISE    = 1 << 2;
+
+    struct ShaderFeatures {
+        uint32_t Flags        = 0;
+        uint32_t LightCount   = 0;
+        uint32_t NoiseOctaves = 0;
+
+        bool operator==(const ShaderFeatures&) const = default;
+    };
+
+    // Small per-draw data pushed straight into the command buffer with vkCmdPushConstants
+    //  . Only 128 bytes are guaranteed by the spec, so keep this tiny
+    struct ObjectPushConstants {
+        alignas(16) glm::mat4 Model;
+        alignas(4)  uint32_t  MaterialIndex;
+    };
+
+    static_assert(sizeof(ObjectPushConstants) <= 128, "Push constants must fit in the guaranteed 128 bytes!");
+
+    // Laid out to match the std430 Material struct in BindlessFS.frag
+    //  . TextureIndex/SamplerIndex are slots in the bindless arrays (BINDLESS_INVALID_INDEX when unused)
+    struct Material {
+        alignas(16) glm::vec4 Tint;
+        uint32_t              TextureIndex;
+        uint32_t              SamplerIndex;
+        uint32_t              Padding[2];
+    };
+
+    // Packed descriptor data for the scene set, one member per binding (see VulkanUtilities::TypedDescriptorTemplate)
+    struct SceneDescriptorData {
+        VkDescriptorBufferInfo Camera;  // Binding 0
+        VkDescriptorBufferInfo Objects; // Binding 1
+    };
+
+    struct SceneObject {
+        glm::vec3 Position;
+        float     Scale;
+        glm::mat4 Transform; // Rebuilt from Position/Scale every frame by updateSceneObjects()
+        uint32_t  MaterialIndex;
+    };
+
+    // How the per-object data (Model matrix) reaches the vertex shader
+    //  . PushConstants: vkCmdPushConstants per draw (the default)
+    //  . UniformBuffer: one dynamic-offset UBO slot per object, rebinding the descriptor set per draw
+    //  . GpuDriven:     a storage buffer of GpuObjects, culled and drawn by the GPU (see HelloTriangleGpuDriven.cpp)
+    enum class ObjectDataPath {
+        PushConstants,
+        UniformBuffer,
+        GpuDriven
+    };
+
+    // Laid out to match the std430 GpuObject struct in CullObjectsCS.comp and GpuDrivenVS.vert
+    //  . The draw arguments are a mesh chunk's, the culling pass copies them into the indirect command
+    struct GpuObject {
         alignas(16) glm::mat4 Model;
-        alignas(16) glm::mat4 View;
-        alignas(16) glm::mat4 Projection;
+        alignas(16) glm::vec4 BoundingSphere; // World space (objects are static on the GPU-driven path)
+        uint32_t              IndexCount;
+        uint32_t              FirstIndex;
+        int32_t               VertexOffset;
+        uint32_t              MaterialIndex;
+    };
+
+    static_assert(sizeof(GpuObject) == 96, "GpuObject has to match the shader side std430 layout!");
+
+    // How a graphics pipeline uses the depth buffer
+    //  . Test:    LESS + write, the normal case
+    //  . Prepass: LESS + write, no fragment shader and no color writes (fills the depth buffer up front)
+    //  . Equal:   EQUAL without writes, after a prepass only the visible surface of every pixel gets shaded
+    enum class DepthMode {
+        Test,
+        Prepass,
+        Equal
+    };
+
+    // Which objects a culling dispatch looks at (PHASE_* in CullObjectsCS.comp)
+    //  . All:   every object, frustum only (occlusion culling off)
+    //  . Early: objects visible last frame, frustum only, drawn before the depth pyramid is built
+    //  . Late:  every object, frustum + depth pyramid, draws the ones the early phase missed
+    enum class CullingPhase : uint32_t {
+        All,
+        Early,
+        Late
+    };
+
+    // How much the validation layer checks, picked at startup with --validation (each level has the core checks too)
+    //  . Synchronization, best practices and GPU-assisted are VkValidationFeaturesEXT switched on at instance creation
+    //  . GPU-assisted instruments every shader and takes a descriptor set slot for itself, frames get a lot slower
+    enum class ValidationLevel {
+        Off,
+        Core,
+        Synchronization,
+        BestPractices,
+        GpuAssisted
+    };
+
+#ifdef NDEBUG
+    inline constexpr ValidationLevel DEFAULT_VALIDATION_LEVEL = ValidationLevel::Off;
+#else
+    inline constexpr ValidationLevel DEFAULT_VALIDATION_LEVEL = ValidationLevel::Core;
+#endif
+
+    // The frustum planes are pulled out of ViewProjection in the shader, there is no room for both in 128 bytes
+    struct CullingPushConstants {
+        glm::mat4 ViewProjection;
+        glm::vec2 PyramidSize;
+        uint32_t  ObjectCount;
+        uint32_t  Phase;
+        uint32_t  PyramidLevels;
+    };
+
+    static_assert(sizeof(CullingPushConstants) <= 128, "Push constants must fit in the guaranteed 128 bytes!");
+
+    struct DepthPyramidPushConstants {
+        glm::ivec2 SourceSize;
+        glm::ivec2 DestinationSize;
+    };
+
+    // Draws the culling passes let through, read back from the GPU a couple of frames late
+    struct GpuDrawCounts {
+        uint32_t Early; // Or everything, without occlusion culling
+        uint32_t Late;
+    };
+
+    // Sort time and binds are only filled in by the CPU recorded path (the render queue)
+    struct FrameStatistics {
+        double RecordMilliseconds = 0.0;
+        double FrameMilliseconds  = 0.0;
+        double SortMilliseconds   = 0.0;
+
+        Rendering::BindStatistics Binds;
+    };
+
+    // What the pipeline field of a render queue sort key points at (see queued_pipelines)
+    struct QueuedPipeline {
+        VkPipeline       Pipeline;
+        VkPipelineLayout Layout;
+        DepthMode        Depth; // What setFixedFunctionState() sets after the bind
+    };
+
+    struct FrameBenchmarkResult {
+        Benchmark::Result Record;
+        Benchmark::Result Frame;
     };
 
     struct QueueFamilyIndices {
@@ -51,8 +232,39 @@ namespace HelloTriangle {
 
     inline bool framebuffer_resized = false;
 
+    inline Benchmark::Stopwatch startup_stopwatch{};      // Restarted first thing in helloTriangle()
+    inline double               vulkan_init_milliseconds = 0.0; // How long initVulkan() took, for the benchmarks
+    inline bool                 first_frame_presented = false;
+
+    // Launch Options (parsed from the command line)
+    inline std::string benchmark_name;
+    inline std::string device_selector; // Part of a device name or its UUID, overrides the ranking in selectPhysicalDevice()
+    inline bool        use_bindless           = false; // Cleared again if the device can't do descriptor indexing
+    inline bool        use_gpu_driven         = false; // Cleared again if the device can't do indirect count draws
+    inline bool        use_occlusion_culling  = false; // Implies use_gpu_driven, the culling pass is what reads the depth pyramid
+    inline bool        use_depth_prepass      = false; // Creates the prepass pipelines, only used on the push constant path
+    inline bool        depth_prepass_enabled  = false; // Can be flipped at runtime once the pipelines exist (benchmarks do)
+    inline bool        use_feature_shader     = false; // FeatureFS.frag instead of the plain fragment shader (push constant path only, benchmarks turn it on)
+    inline bool        specialize_features    = false; // Bake shader_features into a pipeline variant instead of branching on the uniform
+    inline bool        use_pipeline_libraries = false; // Build pipelines from VK_EXT_graphics_pipeline_library parts, cleared again if the device can't
+    inline bool        use_dynamic_state      = false; // Set whatever fixed function state extended dynamic state allows on the command buffer
+    inline bool        use_capability_cache   = true;  // Read/write DEVICE_CAPABILITY_CACHE_PATH, --no-capability-cache queries every device from scratch
+    inline bool        use_serial_init        = false; // Run initVulkan()'s tasks one after the other instead of on a pool
+    inline bool        use_host_allocator     = true;  // VulkanUtilities::enableHostAllocator(), --system-allocator leaves it to the driver
+
+    inline ValidationLevel validation_level = DEFAULT_VALIDATION_LEVEL; // --validation <off|core|sync|best-practices|gpu-assisted>
+
     // Vulkan Constants
     inline constexpr uint32_t                 MAX_FRAMES_IN_FLIGHT = 2;
+    inline constexpr VkShaderStageFlags       OBJECT_PUSH_CONSTANT_STAGES   = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    inline constexpr uint32_t                 BINDLESS_MATERIAL_BUFFER_SLOT = 0; // BindlessFS.frag expects the materials in the first storage buffer
+    inline constexpr bool                     SPLIT_LARGE_MESHES            = true; // Meshes over 65536 vertices get 16-bit chunks instead of 32-bit indices
+    inline constexpr uint32_t                 GEOMETRY_POOL_VERTICES        = 1 << 20;
+    inline constexpr uint32_t                 GEOMETRY_POOL_INDICES         = 1 << 22;
+    inline constexpr uint32_t                 CULLING_WORKGROUP_SIZE        = 64; // local_size_x in CullObjectsCS.comp
+    inline constexpr uint32_t                 DEPTH_PYRAMID_WORKGROUP_SIZE  = 8;  // local_size_x/y in DepthPyramidCS.comp
+    inline constexpr uint32_t                 CULLING_DRAW_REGIONS          = 2;  // Early/all and late, see CullObjectsCS.comp
+    inline constexpr const char*              DEVICE_CAPABILITY_CACHE_PATH  = "device_capabilities.cache";
     inline std::vector<const char*> VK_VALIDATION_LAYERS = {
         "VK_LAYER_KHRONOS_validation"
     };
@@ -68,15 +280,33 @@ namespace HelloTriangle {
         {{-0.5f,  0.5f}, {1.0f, 1.0f, 1.0f}}
     };
 
-    inline const std::vector<uint16_t> INDICES = { 0, 1, 2, 2, 3, 0 };
+    // Stored as 32-bit, createGeometry() packs them down to the geometry pool's 16-bit indices
+    inline const std::vector<uint32_t> INDICES = { 0, 1, 2, 2, 3, 0 };
+
+    inline constexpr float LAYERED_SCENE_SPACING = 0.05f; // Distance between the layers of createLayeredScene()
+
+    // Scene
+    inline std::vector<SceneObject> scene_objects;
+    inline std::vector<Material>    materials;
+    inline ObjectDataPath           object_data_path = ObjectDataPath::PushConstants;
+    inline FrameStatistics          last_frame_statistics{};
+    inline UniformBufferObject      scene_camera{}; // Last View/Projection written by updateUniformBuffer()
+
+    // Render queue (CPU recorded path), passes run in key order so the prepass has to come first
+    inline constexpr uint32_t QUEUE_PASS_DEPTH_PREPASS     = 0;
+    inline constexpr uint32_t QUEUE_PASS_OPAQUE            = 1;
+    inline constexpr uint32_t QUEUE_PIPELINE_DEPTH_PREPASS = 0;
+    inline constexpr uint32_t QUEUE_PIPELINE_MAIN          = 1;
+
+    inline Rendering::RenderQueue        render_queue;
+    inline std::array<QueuedPipeline, 2> queued_pipelines{}; // Refilled by recordCommandBuffer(), the main pipeline depends on the options
 
-#ifdef NDEBUG
-    const bool enable_validation_layers = false;
-#else
-    const bool enable_validation_layers = true;
-#endif
 
     // Vulkan Variables
+    inline VulkanUtilities::DeviceCapabilityDatabase device_capabilities{}; // Every physical device, queried once by selectPhysicalDevice()
+
+    inline const VkAllocationCallbacks* vk_allocator = nullptr; // Every vkCreate*/vkDestroy* gets this, null unless use_host_allocator
+
     inline VkInstance               vk_instance;
     inline VkDebugUtilsMessengerEXT vk_debug_messenger;
     inline VkSurfaceKHR             vk_surface;
@@ -86,13 +316,32 @@ namespace HelloTriangle {
     inline VkQueue                  vk_presentation_queue;
     inline VkSwapchainKHR           vk_swapchain;
     inline VkRenderPass             vk_render_pass;
+    inline VkRenderPass             vk_early_render_pass = VK_NULL_HANDLE; // Occlusion culling: clears, keeps depth for the pyramid
+    inline VkRenderPass             vk_late_render_pass  = VK_NULL_HANDLE; // Occlusion culling: loads what the early pass drew, presents
     inline VkDescriptorSetLayout    vk_descriptor_set_layout;
     inline VkPipelineLayout         vk_pipeline_layout;
     inline VkPipeline               vk_pipeline;
+    inline VkPipeline               vk_object_ubo_pipeline;
+    inline VkPipelineLayout         vk_bindless_pipeline_layout = VK_NULL_HANDLE;
+    inline VkPipeline               vk_bindless_pipeline        = VK_NULL_HANDLE;
+    inline VkPipeline               vk_depth_prepass_pipeline        = VK_NULL_HANDLE;
+    inline VkPipeline               vk_depth_equal_pipeline          = VK_NULL_HANDLE;
+    inline VkPipeline               vk_bindless_depth_equal_pipeline = VK_NULL_HANDLE;
+    inline VkPipeline               vk_feature_pipeline              = VK_NULL_HANDLE; // Unspecialized, every feature comes from the uniform
+
+    inline ShaderFeatures                    shader_features{};
+    inline ShaderFeatures                    last_feature_request{};                   // getFeaturePipeline() skips the registry while this doesn't change
+    inline uint64_t                          last_feature_generation = 0;              // ... and neither does the registry's generation
+    inline VkPipeline                        last_feature_pipeline   = VK_NULL_HANDLE; // May be the ubershader or a fast-linked variant
+    inline VulkanUtilities::PipelineRegistry pipeline_registry; // Owns every graphics pipeline above (and the feature variants)
+
+    inline uint32_t                              dynamic_pipeline_state = 0; // DYNAMIC_PIPELINE_STATE_* bits the device has, stays 0 without use_dynamic_state
+    inline VulkanUtilities::DynamicStateCommands dynamic_state_commands{};
     inline VkCommandPool            vk_command_pool;
 
-    inline VkDescriptorPool             vk_descriptor_pool;
-    inline std::vector<VkDescriptorSet> vk_descriptor_sets;
+    inline VulkanUtilities::DescriptorSetCache                           descriptor_set_cache{};
+    inline std::vector<VkDescriptorSet>                                  vk_descriptor_sets;
+    inline VulkanUtilities::TypedDescriptorTemplate<SceneDescriptorData> scene_descriptor_template{};
 
     inline std::vector<VkImage>       vk_swapchain_images;
     inline std::vector<VkImageView>   vk_swapchain_image_views;
@@ -100,33 +349,85 @@ namespace HelloTriangle {
     inline VkExtent2D                 vk_swapchain_extent;
     inline std::vector<VkFramebuffer> vk_swapchain_framebuffers;
 
+    inline VkFormat       vk_depth_format       = VK_FORMAT_UNDEFINED;
+    inline VkImage        vk_depth_image        = VK_NULL_HANDLE;
+    inline VkDeviceMemory vk_depth_memory       = VK_NULL_HANDLE;
+    inline VkImageView    vk_depth_image_view   = VK_NULL_HANDLE;
+    inline VkImageView    vk_depth_sampled_view = VK_NULL_HANDLE; // Depth aspect only, what the depth pyramid reads
+
     inline std::vector<VkCommandBuffer> vk_command_buffers;
 
     inline std::vector<VkSemaphore> image_available_semaphores;
     inline std::vector<VkSemaphore> render_finished_semaphores;
     inline std::vector<VkFence>     in_flight_fences;
 
-    inline VkBuffer       vk_vertex_buffer;
-    inline VkDeviceMemory vk_vertex_memory;
-    inline VkBuffer       vk_index_buffer;
-    inline VkDeviceMemory vk_index_memory;
+    inline VulkanUtilities::GeometryPool geometry_pool{};
+    inline VulkanUtilities::MeshHandle   quad_mesh;
 
     inline std::vector<VkBuffer>       vk_uniform_buffers;
     inline std::vector<VkDeviceMemory> vk_uniform_memorys;
     inline std::vector<void*>          vk_uniform_buffers_mapped;
 
+    inline std::vector<VkBuffer>       vk_object_uniform_buffers;
+    inline std::vector<VkDeviceMemory> vk_object_uniform_memorys;
+    inline std::vector<void*>          vk_object_uniform_buffers_mapped;
+    inline VkDeviceSize                vk_object_uniform_stride = 0;
+
+    inline VulkanUtilities::BindlessTable bindless_table{};
+    inline VkBuffer                       vk_material_buffer = VK_NULL_HANDLE;
+    inline VkDeviceMemory                 vk_material_memory = VK_NULL_HANDLE;
+
+    inline VkDescriptorSetLayout               vk_culling_set_layout         = VK_NULL_HANDLE;
+    inline VkPipelineLayout                    vk_culling_pipeline_layout    = VK_NULL_HANDLE;
+    inline VkPipeline                          vk_culling_pipeline           = VK_NULL_HANDLE;
+    inline VkPipelineLayout                    vk_gpu_driven_pipeline_layout = VK_NULL_HANDLE;
+    inline VkPipeline                          vk_gpu_driven_pipeline        = VK_NULL_HANDLE;
+    inline VkBuffer                            vk_gpu_object_buffer          = VK_NULL_HANDLE;
+    inline VkDeviceMemory                      vk_gpu_object_memory          = VK_NULL_HANDLE;
+    inline uint32_t                            gpu_object_count              = 0;
+    inline uint32_t                            gpu_max_draw_count            = 0; // gpu_object_count, clamped to maxDrawIndirectCount
+    inline std::vector<VkBuffer>               vk_draw_command_buffers;
+    inline std::vector<VkDeviceMemory>         vk_draw_command_memorys;
+    inline std::vector<VkBuffer>               vk_draw_count_buffers;
+    inline std::vector<VkDeviceMemory>         vk_draw_count_memorys;
+    inline VulkanUtilities::DescriptorAllocator culling_descriptor_allocator{};
+    inline std::vector<VkDescriptorSet>        vk_culling_descriptor_sets;
+    inline VkBuffer                            vk_visibility_buffer          = VK_NULL_HANDLE;
+    inline VkDeviceMemory                      vk_visibility_memory          = VK_NULL_HANDLE;
+    inline std::vector<VkBuffer>               vk_draw_count_readback_buffers;
+    inline std::vector<VkDeviceMemory>         vk_draw_count_readback_memorys;
+    inline std::vector<void*>                  vk_draw_count_readback_mapped;
+
+    inline VulkanUtilities::DepthPyramid        depth_pyramid{};
+    inline VkDescriptorSetLayout               vk_depth_pyramid_set_layout      = VK_NULL_HANDLE;
+    inline VkPipelineLayout                    vk_depth_pyramid_pipeline_layout = VK_NULL_HANDLE;
+    inline VkPipeline                          vk_depth_pyramid_pipeline        = VK_NULL_HANDLE;
+    inline VulkanUtilities::DescriptorAllocator depth_pyramid_descriptor_allocator{};
+    inline std::vector<VkDescriptorSet>        vk_depth_pyramid_descriptor_sets; // One per level
+
     inline uint32_t current_frame = 0;
 
     // Entrypoint
-    uint32_t helloTriangle();
+    uint32_t        helloTriangle(int argc, char** argv);
+    void            parseArguments(int argc, char** argv);
+    ValidationLevel parseValidationLevel(const std::string& name);
+    const char*     getValidationLevelName(ValidationLevel level);
 
     // Lifecycle Methods
     void initWindow();
     void initVulkan();
+    void logHostAllocatorStatistics(const VulkanUtilities::HostAllocatorStatistics& statistics);
+    void logStartupTimeline(const std::vector<StandardUtilities::TaskTiming>& timings, double total_milliseconds);
     void mainLoop();
     void drawFrame();
     void cleanup();
 
+    // Scene
+    void createScene();
+    void createGridScene(uint32_t object_count);
+    void createLayeredScene(uint32_t object_count, uint32_t layers);
+    void updateSceneObjects(float time);
+
     // Event Callbacks
     void framebufferResized(GLFWwindow* window, int width, int height);
 
@@ -136,11 +437,21 @@ namespace HelloTriangle {
     void createSurface();
     void selectPhysicalDevice();
     void createLogicalDevice();
+    void chooseAttachmentFormats();
     void createSwapChain();
     void createImageViews();
+    void createDepthResources();
     void createRenderPass();
+    VkRenderPass buildRenderPass(VkAttachmentLoadOp load_op, VkImageLayout color_final_layout, VkAttachmentStoreOp depth_store_op);
     void createDescriptorSetLayout();
     void createGraphicsPipeline();
+    VulkanUtilities::GraphicsPipelineDescription describeGraphicsPipeline(VkPipelineLayout layout, const std::string& vertex_shader_path, const std::string& fragment_shader_path, DepthMode depth_mode, std::vector<uint32_t> fragment_constants = {});
+    VkPipeline buildGraphicsPipeline(VkPipelineLayout layout, const std::string& vertex_shader_path, const std::string& fragment_shader_path, DepthMode depth_mode, const char* name);
+    VulkanUtilities::FixedFunctionState getFixedFunctionState(DepthMode depth_mode);
+    void                                setFixedFunctionState(VkCommandBuffer buffer, DepthMode depth_mode);
+    std::vector<uint32_t> getFeatureConstants(const ShaderFeatures& features);
+    VkPipeline            getFeaturePipeline(const ShaderFeatures& features);
+    VkPipeline buildComputePipeline(VkPipelineLayout layout, const std::string& compute_shader_path);
     void createFramebuffers();
     void createCommandPool();
     void createCommandBuffers();
@@ -149,18 +460,48 @@ namespace HelloTriangle {
     void recreateSwapChain();
     void cleanupSwapChain();
 
-    void createVertexBuffer();
-    void createIndexBuffer();
+    void createGeometry();
+    void createMaterialBuffer();
     void createUniformBuffers();
+    void createObjectUniformBuffers();
 
-    void createDescriptorPool();
+    void createDescriptorAllocators();
     void createDescriptorSets();
 
+    std::vector<VkDescriptorSetLayoutBinding> getSceneDescriptorBindings();
+
+    // GPU-driven rendering (see HelloTriangleGpuDriven.cpp)
+    void createCullingSetLayout();
+    void createGpuDrivenPipelines();
+    void destroyGpuDrivenPipelines();
+    void createGpuDrivenBuffers();
+    void destroyGpuDrivenBuffers();
+    void recordCullingPass(VkCommandBuffer buffer, CullingPhase phase);
+    void recordGpuDrivenDraws(VkCommandBuffer buffer, CullingPhase phase);
+    void recordDrawCountReadback(VkCommandBuffer buffer);
+    GpuDrawCounts readGpuDrawCounts();
+
+    // Hi-Z occlusion culling (see HelloTriangleOcclusion.cpp)
+    void createDepthPyramidPipeline();
+    void destroyDepthPyramidPipeline();
+    void createDepthPyramidResources();
+    void destroyDepthPyramidResources();
+    void writeCullingPyramidDescriptors();
+    void recordDepthPyramid(VkCommandBuffer buffer);
+    void recordOcclusionCulledFrame(VkCommandBuffer buffer, uint32_t image_index);
+
     bool                     checkValidationLayerSupport();
+    bool                     checkValidationFeaturesSupport();
     std::vector<const char*> getRequiredExtensions();
 
+    std::vector<VkValidationFeatureEnableEXT> getValidationFeatures(ValidationLevel level);
+
     void recordCommandBuffer(VkCommandBuffer buffer, uint32_t image_index);
+    void beginSceneRenderPass(VkCommandBuffer buffer, VkRenderPass render_pass, uint32_t image_index, VkPipeline pipeline);
+    void buildRenderQueue(bool prepass);
+    void recordRenderQueue(VkCommandBuffer buffer, bool push_constants, bool bindless);
     void updateUniformBuffer(uint32_t current_image);
+    void updateObjectUniformBuffer(uint32_t current_image);
 
     VkSurfaceFormatKHR chooseSwapSurfaceFomat(const std::vector<VkSurfaceFormatKHR>& available_formats);
     VkPresentModeKHR   choosePresentMode(const std::vector<VkPresentModeKHR>& available_present_modes);
@@ -168,7 +509,81 @@ namespace HelloTriangle {
 
     void                    populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& create_info);
     bool                    isDeviceSuitable(VkPhysicalDevice);
+    uint32_t                countOptionalDeviceFeatures(VkPhysicalDevice device);
     bool                    checkDeviceExtensionSupport(VkPhysicalDevice device);
     QueueFamilyIndices      findQueueFamilies(VkPhysicalDevice device);
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
+
+    const VulkanUtilities::DeviceCapabilities& getDeviceCapabilities(VkPhysicalDevice device);
+
+    // Benchmarks (see HelloTriangleBenchmarks.cpp)
+    inline constexpr uint32_t BENCHMARK_WARMUP_FRAMES   = 60;
+    inline constexpr uint32_t BENCHMARK_MEASURED_FRAMES = 600;
+    inline constexpr uint32_t BENCHMARK_OBJECT_COUNT    = 10000;
+    inline constexpr uint32_t BENCHMARK_DESCRIPTOR_SETS = 10000;
+    inline constexpr uint32_t BENCHMARK_CPU_FRAMES      = 100;
+    inline constexpr uint32_t BENCHMARK_MESH_RESOLUTION = 1023; // Cells per side, (1023 + 1)^2 = ~1M vertices
+    inline constexpr uint32_t BENCHMARK_ENCODE_PASSES   = 20;
+    inline constexpr uint32_t BENCHMARK_OPTIMIZER_GRID  = 255; // (255 + 1)^2 = 65536 vertices, ~130k triangles
+    inline constexpr uint32_t BENCHMARK_SCALING_FRAMES  = 120;
+    inline constexpr uint32_t BENCHMARK_POOL_MESHES     = 256; // Grids of 5x5 up to 33x33 vertices, every other one gets freed
+
+    inline constexpr uint32_t BENCHMARK_OCCLUSION_OBJECTS = 100000;
+    inline constexpr uint32_t BENCHMARK_OCCLUSION_LAYERS  = 10; // The top layer hides (almost) everything under it
+    inline constexpr uint32_t BENCHMARK_OVERDRAW_OBJECTS  = 16384;
+    inline constexpr uint32_t BENCHMARK_OVERDRAW_LAYERS   = 16; // Drawn back to front, so every layer gets shaded on top of the last
+
+    inline constexpr uint32_t BENCHMARK_QUEUE_DRAWS     = 100000;
+    inline constexpr uint32_t BENCHMARK_QUEUE_PIPELINES = 16;
+    inline constexpr uint32_t BENCHMARK_QUEUE_MATERIALS = 256;
+    inline constexpr uint32_t BENCHMARK_QUEUE_SORTS     = 100;
+
+    inline constexpr std::array<uint32_t, 3> BENCHMARK_REGISTRY_LIGHT_COUNTS  = { 1, 4, 16 };
+    inline constexpr std::array<uint32_t, 2> BENCHMARK_REGISTRY_NOISE_OCTAVES = { 1, 4 };
+    inline constexpr uint32_t                BENCHMARK_REGISTRY_LOOKUPS       = 100000;
+
+    inline constexpr std::array<VkCullModeFlags, 3>     BENCHMARK_MATERIAL_CULL_MODES     = { VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT, VK_CULL_MODE_FRONT_BIT };
+    inline constexpr std::array<VkPrimitiveTopology, 2> BENCHMARK_MATERIAL_TOPOLOGIES     = { VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP };
+    inline constexpr std::array<VkCompareOp, 3>         BENCHMARK_MATERIAL_DEPTH_COMPARES = { VK_COMPARE_OP_LESS, VK_COMPARE_OP_LESS_OR_EQUAL, VK_COMPARE_OP_EQUAL };
+
+    inline constexpr uint32_t BENCHMARK_CAPABILITY_QUERIES = 100;
+
+    inline constexpr uint32_t BENCHMARK_HOST_ALLOCATIONS     = 1000000;
+    inline constexpr size_t   BENCHMARK_HOST_ALLOCATION_SIZE = 256;
+
+    inline constexpr uint32_t BENCHMARK_ALLOCATION_FRAMES = 300;
+
+    inline constexpr std::array<uint32_t, 3> BENCHMARK_GPU_DRIVEN_COUNTS = { 10000, 100000, 1000000 };
+
+    inline constexpr std::array<ShaderFeatures, 3> BENCHMARK_SHADER_FEATURES = {{
+        { SHADER_FEATURE_TINT,                                                 0,  0 },
+        { SHADER_FEATURE_TINT | SHADER_FEATURE_LIGHTING,                       16, 0 },
+        { SHADER_FEATURE_TINT | SHADER_FEATURE_LIGHTING | SHADER_FEATURE_NOISE, 16, 4 }
+    }};
+
+    bool                 createBenchmarkScene(const std::string& name);
+    void                 runBenchmark(const std::string& name);
+    FrameBenchmarkResult measureFrames(const std::string& name, uint32_t frame_count);
+
+    void benchmarkObjectData();
+    void benchmarkDescriptorAllocation();
+    void benchmarkDescriptorUpdates();
+    void benchmarkVertexFormats();
+    void benchmarkMeshOptimizer();
+    void benchmarkPositionStream();
+    void benchmarkGeometryPool();
+    void benchmarkGpuDriven();
+    void benchmarkOcclusionCulling();
+    void benchmarkDepthPrepass();
+    void benchmarkRenderQueue();
+    void benchmarkSpecialization();
+    void benchmarkPipelineRegistry();
+    void benchmarkPipelineLibrary();
+    void benchmarkDynamicState();
+    void benchmarkDeviceCapabilities();
+    void benchmarkHostAllocator();
+    void benchmarkFrameAllocations();
+    void benchmarkValidation();
+
+    std::vector<VulkanUtilities::GraphicsPipelineDescription> describeFeatureVariants();
 }
\ No newline at end of file
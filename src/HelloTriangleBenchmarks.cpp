@@ -0,0 +1,1088 @@
+#include "HelloTriangle.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "GLFW/glfw3.h"
+#include "spdlog/spdlog.h"
+
+#include "AllocationTracker.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshUtils.hpp"
+#include "VulkanUtilities/BufferUtils.hpp"
+#include "VulkanUtilities/DebugUtils.hpp"
+#include "VulkanUtilities/VertexEncoding.hpp"
+
+// Benchmarks are picked with "--benchmark <name>" and run in place of the normal main loop
+//  . Results are printed through spdlog, the window closes when they are done
+
+namespace HelloTriangle {
+    // Returns false when the benchmark is fine with the default scene
+    bool createBenchmarkScene(const std::string& name) {
+        if (name == "object-data") {
+            createGridScene(BENCHMARK_OBJECT_COUNT);
+            return true;
+        }
+
+        if (name == "gpu-driven") {
+            use_gpu_driven = true;
+            createGridScene(BENCHMARK_GPU_DRIVEN_COUNTS[0]);
+            return true;
+        }
+
+        if (name == "occlusion-culling") {
+            use_gpu_driven = use_occlusion_culling = true;
+            createLayeredScene(BENCHMARK_OCCLUSION_OBJECTS, BENCHMARK_OCCLUSION_LAYERS);
+            return true;
+        }
+
+        // Full screen layers, so the frame is bound by the fragment shader
+        if (name == "specialization") {
+            use_feature_shader = true;
+            createLayeredScene(BENCHMARK_OVERDRAW_OBJECTS, BENCHMARK_OVERDRAW_LAYERS);
+            return true;
+        }
+
+        // Has to be known before the device is created, the default scene is fine otherwise
+        if (name == "pipeline-library") {
+            use_pipeline_libraries = true;
+            return false;
+        }
+
+        if (name == "dynamic-state") {
+            use_dynamic_state = true;
+            return false;
+        }
+
+        // Back to front is the worst case for overdraw, every layer gets shaded before the one in front covers it
+        if (name == "depth-prepass") {
+            use_depth_prepass = true;
+            createLayeredScene(BENCHMARK_OVERDRAW_OBJECTS, BENCHMARK_OVERDRAW_LAYERS);
+            std::reverse(scene_objects.begin(), scene_objects.end());
+            return true;
+        }
+
+        return false;
+    }
+
+    void runBenchmark(const std::string& name) {
+        spdlog::info("Running benchmark: {}", name);
+
+        if (name == "object-data")
+            benchmarkObjectData();
+        else if (name == "descriptor-allocation")
+            benchmarkDescriptorAllocation();
+        else if (name == "descriptor-updates")
+            benchmarkDescriptorUpdates();
+        else if (name == "vertex-formats")
+            benchmarkVertexFormats();
+        else if (name == "mesh-optimizer")
+            benchmarkMeshOptimizer();
+        else if (name == "position-stream")
+            benchmarkPositionStream();
+        else if (name == "geometry-pool")
+            benchmarkGeometryPool();
+        else if (name == "gpu-driven")
+            benchmarkGpuDriven();
+        else if (name == "occlusion-culling")
+            benchmarkOcclusionCulling();
+        else if (name == "depth-prepass")
+            benchmarkDepthPrepass();
+        else if (name == "render-queue")
+            benchmarkRenderQueue();
+        else if (name == "specialization")
+            benchmarkSpecialization();
+        else if (name == "pipeline-registry")
+            benchmarkPipelineRegistry();
+        else if (name == "pipeline-library")
+            benchmarkPipelineLibrary();
+        else if (name == "dynamic-state")
+            benchmarkDynamicState();
+        else if (name == "device-capabilities")
+            benchmarkDeviceCapabilities();
+        else if (name == "host-allocator")
+            benchmarkHostAllocator();
+        else if (name == "frame-allocations")
+            benchmarkFrameAllocations();
+        else if (name == "validation")
+            benchmarkValidation();
+        else
+            throw std::runtime_error{"Unknown benchmark: " + name};
+    }
+
+    FrameBenchmarkResult measureFrames(const std::string& name, const uint32_t frame_count) {
+        for (uint32_t i = 0; i < BENCHMARK_WARMUP_FRAMES && !glfwWindowShouldClose(window); i++) {
+            glfwPollEvents();
+            drawFrame();
+        }
+
+        FrameBenchmarkResult result{ { name + " (record)", 0, 0.0 }, { name + " (frame)", 0, 0.0 } };
+
+        for (uint32_t i = 0; i < frame_count && !glfwWindowShouldClose(window); i++) {
+            glfwPollEvents();
+            drawFrame();
+
+            result.Record.Iterations++;
+            result.Record.TotalMilliseconds += last_frame_statistics.RecordMilliseconds;
+            result.Frame.Iterations++;
+            result.Frame.TotalMilliseconds  += last_frame_statistics.FrameMilliseconds;
+        }
+
+        return result;
+    }
+
+    // 10k individually drawn objects, with the Model matrix coming from:
+    //  . A dynamic UBO slot per object (rebinding the descriptor set for every draw)
+    //  . Push constants (one vkCmdPushConstants per draw)
+    void benchmarkObjectData() {
+        spdlog::info(" . {} objects, one vkCmdDrawIndexed each", scene_objects.size());
+
+        object_data_path = ObjectDataPath::UniformBuffer;
+        const auto [ubo_record, ubo_frame] = measureFrames("UBO per object", BENCHMARK_MEASURED_FRAMES);
+
+        object_data_path = ObjectDataPath::PushConstants;
+        const auto [push_record, push_frame] = measureFrames("Push constants", BENCHMARK_MEASURED_FRAMES);
+
+        const auto& [issued, skipped] = last_frame_statistics.Binds;
+        spdlog::info(" . Render queue (last frame): sorted in {:.3f} ms, {} binds issued, {} skipped", last_frame_statistics.SortMilliseconds, issued, skipped);
+
+        Benchmark::report(ubo_record, push_record);
+        Benchmark::report(ubo_frame,  push_frame);
+    }
+
+    // 10k transient sets per "frame", allocated from:
+    //  . One big pool with FREE_DESCRIPTOR_SET_BIT, freeing every set individually at the end of the frame
+    //  . The growable transient allocator, thrown away all at once with vkResetDescriptorPool
+    void benchmarkDescriptorAllocation() {
+        const std::array<VkDescriptorPoolSize, 2> pool_sizes = {{
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         BENCHMARK_DESCRIPTOR_SETS },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, BENCHMARK_DESCRIPTOR_SETS }
+        }};
+
+        VkDescriptorPoolCreateInfo pool_info{};
+
+        pool_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+        pool_info.pPoolSizes    = pool_sizes.data();
+        pool_info.maxSets       = BENCHMARK_DESCRIPTOR_SETS;
+
+        VkDescriptorPool free_pool;
+        if (vkCreateDescriptorPool(vk_logical_device, &pool_info, vk_allocator, &free_pool) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create Descriptor Pool!"};
+
+        std::vector<VkDescriptorSet> sets(BENCHMARK_DESCRIPTOR_SETS);
+
+        VkDescriptorSetAllocateInfo allocate_info{};
+
+        allocate_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool     = free_pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts        = &vk_descriptor_set_layout;
+
+        const auto individual = Benchmark::measure("Allocate + free individually", BENCHMARK_CPU_FRAMES, [&](uint64_t) {
+            for (auto& set : sets)
+                if (vkAllocateDescriptorSets(vk_logical_device, &allocate_info, &set) != VK_SUCCESS)
+                    throw std::runtime_error{"Failed to allocate Descriptor Set!"};
+
+            vkFreeDescriptorSets(vk_logical_device, free_pool, static_cast<uint32_t>(sets.size()), sets.data());
+        });
+
+        vkDestroyDescriptorPool(vk_logical_device, free_pool, vk_allocator);
+
+        // Starts deliberately small so the growth path gets exercised in the first frame
+        auto allocator = VulkanUtilities::createDescriptorAllocator(64);
+
+        const auto transient = Benchmark::measure("Transient allocator + pool reset", BENCHMARK_CPU_FRAMES, [&](uint64_t) {
+            VulkanUtilities::resetDescriptorAllocator(vk_logical_device, allocator);
+
+            for (auto& set : sets)
+                set = VulkanUtilities::allocateDescriptorSet(vk_logical_device, allocator, vk_descriptor_set_layout);
+        });
+
+        spdlog::info(" . {} sets per frame, the transient allocator ended up with {} pools", BENCHMARK_DESCRIPTOR_SETS, allocator.PoolsCreated);
+        spdlog::info(" . {:.0f} vs {:.0f} sets/ms",
+            BENCHMARK_DESCRIPTOR_SETS / individual.averageMilliseconds(), BENCHMARK_DESCRIPTOR_SETS / transient.averageMilliseconds());
+
+        VulkanUtilities::destroyDescriptorAllocator(vk_logical_device, allocator);
+
+        Benchmark::report(individual, transient);
+    }
+
+    // Rewrites both bindings of 10k scene sets every "frame" through:
+    //  . vkUpdateDescriptorSets with a VkWriteDescriptorSet per binding (what createDescriptorSets() used to do)
+    //  . vkUpdateDescriptorSetWithTemplate with the packed SceneDescriptorData
+    void benchmarkDescriptorUpdates() {
+        auto allocator = VulkanUtilities::createDescriptorAllocator(BENCHMARK_DESCRIPTOR_SETS);
+
+        std::vector<VkDescriptorSet> sets(BENCHMARK_DESCRIPTOR_SETS);
+        for (auto& set : sets)
+            set = VulkanUtilities::allocateDescriptorSet(vk_logical_device, allocator, vk_descriptor_set_layout);
+
+        const SceneDescriptorData data{
+            { vk_uniform_buffers[0],        0, sizeof(UniformBufferObject) },
+            { vk_object_uniform_buffers[0], 0, sizeof(glm::mat4) }
+        };
+
+        const auto writes = Benchmark::measure("vkUpdateDescriptorSets", BENCHMARK_CPU_FRAMES, [&](uint64_t) {
+            for (const auto set : sets) {
+                std::array<VkWriteDescriptorSet, 2> descriptor_writes{};
+
+                descriptor_writes[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptor_writes[0].dstSet          = set;
+                descriptor_writes[0].dstBinding      = 0;
+                descriptor_writes[0].descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                descriptor_writes[0].descriptorCount = 1;
+                descriptor_writes[0].pBufferInfo     = &data.Camera;
+
+                descriptor_writes[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptor_writes[1].dstSet          = set;
+                descriptor_writes[1].dstBinding      = 1;
+                descriptor_writes[1].descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                descriptor_writes[1].descriptorCount = 1;
+                descriptor_writes[1].pBufferInfo     = &data.Objects;
+
+                vkUpdateDescriptorSets(vk_logical_device, static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data(), 0, nullptr);
+            }
+        });
+
+        const auto templated = Benchmark::measure("vkUpdateDescriptorSetWithTemplate", BENCHMARK_CPU_FRAMES, [&](uint64_t) {
+            for (const auto set : sets)
+                scene_descriptor_template.update(vk_logical_device, set, data);
+        });
+
+        spdlog::info(" . {} sets per frame: {:.0f} vs {:.0f} set updates/ms",
+            BENCHMARK_DESCRIPTOR_SETS, BENCHMARK_DESCRIPTOR_SETS / writes.averageMilliseconds(), BENCHMARK_DESCRIPTOR_SETS / templated.averageMilliseconds());
+
+        VulkanUtilities::destroyDescriptorAllocator(vk_logical_device, allocator);
+
+        Benchmark::report(writes, templated);
+    }
+
+    // Encodes every attribute stream of a ~1M vertex mesh into its compact format (scalar vs SIMD) and checks how much precision went missing:
+    //  . Position: 3 x float -> 4 x half       (12 -> 8 bytes)
+    //  . Normal:   3 x float -> 2 x snorm16    (12 -> 4 bytes, octahedral)
+    //  . UV:       2 x float -> 2 x snorm16    (8  -> 4 bytes, 2 x half for UVs that tile past 1)
+    //  . Color:    4 x float -> 4 x unorm8     (16 -> 4 bytes)
+    // Throws when a SIMD encoder doesn't give the same bytes as its scalar reference
+    // CPU only, the scene on screen doesn't matter
+    void benchmarkVertexFormats() {
+        using namespace VulkanUtilities;
+
+        const auto   mesh         = MeshUtilities::createGridMesh(BENCHMARK_MESH_RESOLUTION, BENCHMARK_MESH_RESOLUTION);
+        const size_t vertex_count = mesh.vertexCount();
+
+        std::vector<Half4>       positions(vertex_count),   scalar_positions(vertex_count);
+        std::vector<Snorm16x2>   normals(vertex_count),     scalar_normals(vertex_count);
+        std::vector<Snorm16x2>   uvs(vertex_count),         scalar_uvs(vertex_count);
+        std::vector<Half2>       half_uvs(vertex_count),    scalar_half_uvs(vertex_count);
+        std::vector<ColorUnorm8> colors(vertex_count),      scalar_colors(vertex_count);
+
+        const auto compare = [&](const char* name, const auto& scalar_output, const auto& simd_output, auto&& scalar, auto&& simd) {
+            const auto scalar_result = Benchmark::measure(std::string{name} + " (scalar)", BENCHMARK_ENCODE_PASSES, [&](uint64_t) { scalar(); });
+            const auto simd_result   = Benchmark::measure(std::string{name} + " (SIMD)",   BENCHMARK_ENCODE_PASSES, [&](uint64_t) { simd(); });
+
+            Benchmark::report(scalar_result, simd_result);
+
+            if (std::memcmp(scalar_output.data(), simd_output.data(), simd_output.size() * sizeof(simd_output[0])) != 0)
+                throw std::runtime_error{std::string{name} + ": the SIMD encoder doesn't match the scalar one!"};
+        };
+
+        compare("Position",  scalar_positions, positions, [&] { encodeHalf4Scalar(mesh.Positions, scalar_positions); },          [&] { encodeHalf4(mesh.Positions, positions); });
+        compare("Normal",    scalar_normals,   normals,   [&] { encodeOctahedralNormalsScalar(mesh.Normals, scalar_normals); },  [&] { encodeOctahedralNormals(mesh.Normals, normals); });
+        compare("UV",        scalar_uvs,       uvs,       [&] { encodeSnorm16x2Scalar(mesh.UVs, scalar_uvs); },                  [&] { encodeSnorm16x2(mesh.UVs, uvs); });
+        compare("UV (half)", scalar_half_uvs,  half_uvs,  [&] { encodeHalf2Scalar(mesh.UVs, scalar_half_uvs); },                 [&] { encodeHalf2(mesh.UVs, half_uvs); });
+        compare("Color",     scalar_colors,    colors,    [&] { encodeColorsUnorm8Scalar(mesh.Colors, scalar_colors); },         [&] { encodeColorsUnorm8(mesh.Colors, colors); });
+
+        // Worst case error after decoding again (what the vertex shader would actually see)
+        float position_error = 0.0f, normal_error = 0.0f, uv_error = 0.0f, half_uv_error = 0.0f, color_error = 0.0f;
+
+        for (size_t i = 0; i < vertex_count; i++) {
+            for (int j = 0; j < 3; j++)
+                position_error = std::max(position_error, std::fabs(halfToFloat(positions[i].Values[j]) - mesh.Positions[i][j]));
+
+            const glm::vec3 normal = decodeOctahedral({ snorm16ToFloat(normals[i].Values[0]), snorm16ToFloat(normals[i].Values[1]) });
+            normal_error = std::max(normal_error, std::acos(std::clamp(glm::dot(normal, mesh.Normals[i]), -1.0f, 1.0f)));
+
+            for (int j = 0; j < 2; j++) {
+                uv_error      = std::max(uv_error,      std::fabs(snorm16ToFloat(uvs[i].Values[j]) - mesh.UVs[i][j]));
+                half_uv_error = std::max(half_uv_error, std::fabs(halfToFloat(half_uvs[i].Values[j]) - mesh.UVs[i][j]));
+            }
+
+            for (int j = 0; j < 4; j++)
+                color_error = std::max(color_error, std::fabs(static_cast<float>(colors[i].Values[j]) / 255.0f - mesh.Colors[i][j]));
+        }
+
+        constexpr size_t full_size    = 2 * sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(glm::vec4);
+        constexpr size_t compact_size = sizeof(Half4) + sizeof(Snorm16x2) + sizeof(Snorm16x2) + sizeof(ColorUnorm8);
+
+        const auto megabytes = [&](const size_t bytes_per_vertex) { return static_cast<double>(bytes_per_vertex * vertex_count) / (1024.0 * 1024.0); };
+
+        spdlog::info(" . {} vertices", vertex_count);
+        spdlog::info(" . Position: {:>2} -> {:>2} bytes, max error {:.6f} units",   sizeof(glm::vec3), sizeof(Half4),       position_error);
+        spdlog::info(" . Normal:   {:>2} -> {:>2} bytes, max error {:.4f} degrees", sizeof(glm::vec3), sizeof(Snorm16x2),   glm::degrees(normal_error));
+        spdlog::info(" . UV:       {:>2} -> {:>2} bytes, max error {:.6f} ({:.6f} as halves)", sizeof(glm::vec2), sizeof(Snorm16x2), uv_error, half_uv_error);
+        spdlog::info(" . Color:    {:>2} -> {:>2} bytes, max error {:.6f}",         sizeof(glm::vec4), sizeof(ColorUnorm8), color_error);
+        spdlog::info(" . Total:    {} -> {} bytes per vertex, {:.1f} MB -> {:.1f} MB", full_size, compact_size, megabytes(full_size), megabytes(compact_size));
+    }
+
+    // What an importer would hand us at worst: a grid mesh with every triangle having its own three vertices, in random order
+    //  . Reports vertex count and ACMR/ATVR before and after optimizeMesh(), plus how long the whole thing took
+    //  . Throws when the result is wrong: a different set of triangles, duplicate vertices left over, a worse ACMR,
+    //    or an out of range index that got through
+    void benchmarkMeshOptimizer() {
+        // A vertex is the raw bytes of every attribute (that's what deduplication compares), a triangle is three of them
+        using VertexKey   = std::array<uint32_t, 12>;
+        using TriangleKey = std::array<VertexKey, 3>;
+
+        const auto vertexKey = [](const MeshUtilities::Mesh& source, const uint32_t vertex) {
+            VertexKey key{};
+
+            std::memcpy(&key[0], &source.Positions[vertex], sizeof(glm::vec3));
+            std::memcpy(&key[3], &source.Normals[vertex],   sizeof(glm::vec3));
+            std::memcpy(&key[6], &source.UVs[vertex],       sizeof(glm::vec2));
+            std::memcpy(&key[8], &source.Colors[vertex],    sizeof(glm::vec4));
+
+            return key;
+        };
+
+        // Each triangle rotated so its smallest vertex comes first (the winding stays), then all of them sorted, so two meshes compare as sets
+        const auto triangleKeys = [&vertexKey](const MeshUtilities::Mesh& source) {
+            const size_t corner_count = source.Indices.empty() ? source.vertexCount() : source.Indices.size();
+
+            std::vector<TriangleKey> triangles(corner_count / 3);
+
+            for (size_t triangle = 0; triangle < triangles.size(); triangle++) {
+                for (size_t corner = 0; corner < 3; corner++)
+                    triangles[triangle][corner] = vertexKey(source, source.Indices.empty() ? static_cast<uint32_t>(triangle * 3 + corner) : source.Indices[triangle * 3 + corner]);
+
+                std::ranges::rotate(triangles[triangle], std::ranges::min_element(triangles[triangle]));
+            }
+
+            std::ranges::sort(triangles);
+
+            return triangles;
+        };
+
+        const auto grid = MeshUtilities::createGridMesh(BENCHMARK_OPTIMIZER_GRID, BENCHMARK_OPTIMIZER_GRID);
+
+        std::vector<uint32_t> triangle_order(grid.triangleCount());
+        std::iota(triangle_order.begin(), triangle_order.end(), 0u);
+        std::shuffle(triangle_order.begin(), triangle_order.end(), std::mt19937{ 42 });
+
+        MeshUtilities::Mesh mesh{};
+        for (const uint32_t triangle : triangle_order) {
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                const uint32_t vertex = grid.Indices[triangle * 3 + corner];
+
+                mesh.Positions.push_back(grid.Positions[vertex]);
+                mesh.Normals.push_back(grid.Normals[vertex]);
+                mesh.UVs.push_back(grid.UVs[vertex]);
+                mesh.Colors.push_back(grid.Colors[vertex]);
+            }
+        }
+
+        const auto triangles_before = triangleKeys(mesh);
+
+        MeshUtilities::MeshOptimizationReport report{};
+
+        const auto result = Benchmark::measure("optimizeMesh", 1, [&](uint64_t) { report = MeshUtilities::optimizeMesh(mesh); });
+
+        if (triangleKeys(mesh) != triangles_before)
+            throw std::runtime_error{"optimizeMesh() didn't keep the same set of triangles!"};
+
+        std::vector<VertexKey> vertices(mesh.vertexCount());
+        for (uint32_t vertex = 0; vertex < mesh.vertexCount(); vertex++)
+            vertices[vertex] = vertexKey(mesh, vertex);
+
+        std::ranges::sort(vertices);
+
+        if (std::ranges::adjacent_find(vertices) != vertices.end())
+            throw std::runtime_error{"optimizeMesh() left identical vertices behind!"};
+
+        if (report.After.ACMR > report.Before.ACMR)
+            throw std::runtime_error{"optimizeMesh() made the ACMR worse!"};
+
+        MeshUtilities::Mesh out_of_range{};
+        out_of_range.Positions = { grid.Positions[0], grid.Positions[1], grid.Positions[2] };
+        out_of_range.Indices   = { 0, 1, 3 };
+
+        bool rejected = false;
+
+        try {
+            MeshUtilities::optimizeMesh(out_of_range);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+
+        if (!rejected)
+            throw std::runtime_error{"optimizeMesh() took an index past the end of the mesh!"};
+
+        const auto grid_statistics = MeshUtilities::analyzeVertexCache(grid.Indices, grid.vertexCount());
+
+        spdlog::info(" . {} triangles, cache size {}", report.After.Triangles, MeshUtilities::DEFAULT_VERTEX_CACHE_SIZE);
+        spdlog::info(" . Vertices: {} -> {}", report.VerticesBefore, report.VerticesAfter);
+        spdlog::info(" . ACMR:     {:.3f} -> {:.3f} (row by row grid: {:.3f})", report.Before.ACMR, report.After.ACMR, grid_statistics.ACMR);
+        spdlog::info(" . ATVR:     {:.3f} -> {:.3f} (row by row grid: {:.3f})", report.Before.ATVR, report.After.ATVR, grid_statistics.ATVR);
+
+        Benchmark::report(result);
+    }
+
+    // Vertex fetch traffic for the ~1M vertex grid (full 32-bit attributes), interleaved vs a separate position stream:
+    //  . Depth only: interleaved drags normals, UVs and colors through the cache with every position
+    //  . Full pass:  the split streams should cost (about) the same as interleaved, that's the part that must not get worse
+    void benchmarkPositionStream() {
+        const auto     mesh         = MeshUtilities::createGridMesh(BENCHMARK_MESH_RESOLUTION, BENCHMARK_MESH_RESOLUTION);
+        const uint32_t vertex_count = mesh.vertexCount();
+
+        constexpr uint32_t position_size  = sizeof(glm::vec3);
+        constexpr uint32_t attribute_size = sizeof(glm::vec3) + sizeof(glm::vec2) + sizeof(glm::vec4);
+        constexpr uint32_t vertex_size    = position_size + attribute_size;
+
+        const auto fetch = [&](const uint32_t stride, const uint32_t size) { return MeshUtilities::analyzeVertexFetch(mesh.Indices, vertex_count, stride, size); };
+
+        const auto depth_interleaved = fetch(vertex_size,    position_size);
+        const auto depth_split       = fetch(position_size,  position_size);
+        const auto full_interleaved  = fetch(vertex_size,    vertex_size);
+        const auto full_positions    = fetch(position_size,  position_size);
+        const auto full_attributes   = fetch(attribute_size, attribute_size);
+
+        const auto megabytes = [](const uint64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+
+        spdlog::info(" . {} vertices, {} triangles, {} byte lines", vertex_count, mesh.triangleCount(), MeshUtilities::DEFAULT_FETCH_LINE_SIZE);
+        spdlog::info(" . Depth only: {:.1f} MB interleaved -> {:.1f} MB position stream (overfetch {:.2f} -> {:.2f})",
+            megabytes(depth_interleaved.BytesFetched), megabytes(depth_split.BytesFetched), depth_interleaved.Overfetch, depth_split.Overfetch);
+        spdlog::info(" . Full pass:  {:.1f} MB interleaved -> {:.1f} MB split streams",
+            megabytes(full_interleaved.BytesFetched), megabytes(full_positions.BytesFetched + full_attributes.BytesFetched));
+    }
+
+    // Fills a pool of its own with meshes of different sizes, frees every other one and compacts it, then checks that:
+    //  . The live meshes are packed from offset 0 in the order they were in, with their chunks moved along with them
+    //  . The free space is one hole again, at the tail
+    //  . Every byte of the live meshes made it through the GPU copy (read back through a staging buffer)
+    // Every vertex holds its mesh and vertex number, so a range copied to the wrong place can't match by accident
+    void benchmarkGeometryPool() {
+        struct SourceMesh {
+            std::vector<uint32_t>      Attributes; // Mesh and vertex number
+            std::vector<uint32_t>      Positions;  // Both packed into one
+            VulkanUtilities::IndexData Indices;
+        };
+
+        constexpr uint32_t attribute_stride = 2 * sizeof(uint32_t);
+        constexpr uint32_t position_stride  = sizeof(uint32_t);
+
+        std::vector<SourceMesh> sources(BENCHMARK_POOL_MESHES);
+        uint32_t                vertex_capacity = 0;
+        uint32_t                index_capacity  = 0;
+
+        for (uint32_t mesh = 0; mesh < BENCHMARK_POOL_MESHES; mesh++) {
+            const uint32_t cells        = 4 + mesh % 29;
+            const auto     grid         = MeshUtilities::createGridMesh(cells, cells);
+            const uint32_t vertex_count = grid.vertexCount();
+
+            SourceMesh& source = sources[mesh];
+
+            for (uint32_t vertex = 0; vertex < vertex_count; vertex++) {
+                source.Attributes.push_back(mesh);
+                source.Attributes.push_back(vertex);
+                source.Positions.push_back(mesh << 16 | vertex);
+            }
+
+            source.Indices = VulkanUtilities::packIndices(grid.Indices, vertex_count);
+
+            vertex_capacity += vertex_count;
+            index_capacity  += source.Indices.IndexCount;
+        }
+
+        // Exactly big enough, so the pool starts out full and every hole comes from freeMesh()
+        auto pool = VulkanUtilities::createGeometryPool(vk_logical_device, vk_physical_device, attribute_stride, vertex_capacity, index_capacity, VK_INDEX_TYPE_UINT16, position_stride);
+
+        std::vector<VulkanUtilities::MeshHandle> handles(BENCHMARK_POOL_MESHES);
+
+        const auto upload = Benchmark::measure("uploadMesh", BENCHMARK_POOL_MESHES, [&](const uint64_t mesh) {
+            const SourceMesh& source = sources[mesh];
+
+            handles[mesh] = VulkanUtilities::uploadMesh(vk_logical_device, vk_physical_device, vk_command_pool, vk_graphics_queue, pool,
+                std::as_bytes(std::span{ source.Attributes }), source.Indices, std::as_bytes(std::span{ source.Positions }));
+        });
+
+        for (uint32_t mesh = 1; mesh < BENCHMARK_POOL_MESHES; mesh += 2)
+            VulkanUtilities::freeMesh(pool, handles[mesh]);
+
+        spdlog::info(" . {} meshes, {} vertices, {} indices", BENCHMARK_POOL_MESHES, vertex_capacity, index_capacity);
+        spdlog::info(" . After freeing every other mesh: {} vertex holes, the largest is {} of {} free vertices",
+            pool.Vertices.FreeRanges.size(), VulkanUtilities::getLargestFreeRange(pool.Vertices), pool.Vertices.Capacity - pool.Vertices.Used);
+
+        const auto compact = Benchmark::measure("compactGeometryPool", 1, [&](uint64_t) {
+            VulkanUtilities::compactGeometryPool(vk_logical_device, vk_physical_device, vk_command_pool, vk_graphics_queue, pool);
+        });
+
+        uint32_t next_vertex = 0;
+        uint32_t next_index  = 0;
+
+        for (uint32_t mesh = 0; mesh < BENCHMARK_POOL_MESHES; mesh++) {
+            const auto& allocation = pool.Meshes[handles[mesh]];
+
+            if (mesh % 2 == 1) {
+                if (allocation.Live)
+                    throw std::runtime_error{"Freed mesh " + std::to_string(mesh) + " came back after compaction!"};
+
+                continue;
+            }
+
+            if (!allocation.Live || allocation.Vertices.Offset != next_vertex || allocation.Indices.Offset != next_index)
+                throw std::runtime_error{"Mesh " + std::to_string(mesh) + " isn't packed up against the one before it after compaction!"};
+
+            const auto& source_chunks = sources[mesh].Indices.Chunks;
+
+            const bool chunks_moved = std::ranges::equal(allocation.Chunks, source_chunks, [&](const VulkanUtilities::IndexChunk& chunk, const VulkanUtilities::IndexChunk& source) {
+                return chunk.FirstIndex   == source.FirstIndex + allocation.Indices.Offset
+                    && chunk.IndexCount   == source.IndexCount
+                    && chunk.VertexOffset == source.VertexOffset + static_cast<int32_t>(allocation.Vertices.Offset);
+            });
+
+            if (!chunks_moved)
+                throw std::runtime_error{"Mesh " + std::to_string(mesh) + "'s chunks didn't follow it through compaction!"};
+
+            next_vertex += allocation.Vertices.Count;
+            next_index  += allocation.Indices.Count;
+        }
+
+        const auto checkTail = [](const VulkanUtilities::RangeAllocator& allocator, const uint32_t used, const char* name) {
+            const uint32_t tail = allocator.Capacity - used;
+
+            if (allocator.Used != used || allocator.FreeRanges.size() != 1 || allocator.FreeRanges[0].Offset != used || VulkanUtilities::getLargestFreeRange(allocator) != tail)
+                throw std::runtime_error{std::string{"The free "} + name + " aren't one hole at the tail after compaction!"};
+        };
+
+        checkTail(pool.Vertices, next_vertex, "vertices");
+        checkTail(pool.Indices,  next_index,  "indices");
+
+        // One region per live mesh, copied to the same offset it has in the pool
+        const auto readBack = [&](const VkBuffer buffer, const uint32_t stride, const bool indices) {
+            const VkDeviceSize size = static_cast<VkDeviceSize>(indices ? next_index : next_vertex) * stride;
+
+            std::vector<VkBufferCopy> regions;
+            for (uint32_t mesh = 0; mesh < BENCHMARK_POOL_MESHES; mesh += 2) {
+                const auto& range = indices ? pool.Meshes[handles[mesh]].Indices : pool.Meshes[handles[mesh]].Vertices;
+                const VkDeviceSize offset = static_cast<VkDeviceSize>(range.Offset) * stride;
+
+                regions.push_back({ offset, offset, static_cast<VkDeviceSize>(range.Count) * stride });
+            }
+
+            VkBuffer       staging_buffer;
+            VkDeviceMemory staging_memory;
+            VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, staging_buffer, staging_memory);
+
+            VulkanUtilities::copyBufferRegions(vk_logical_device, vk_command_pool, vk_graphics_queue, buffer, staging_buffer, regions);
+
+            std::vector<std::byte> data(size);
+
+            void* mapped;
+            vkMapMemory(vk_logical_device, staging_memory, 0, size, 0, &mapped);
+            memcpy(data.data(), mapped, size);
+            vkUnmapMemory(vk_logical_device, staging_memory);
+
+            vkDestroyBuffer(vk_logical_device, staging_buffer, vk_allocator);
+            vkFreeMemory(vk_logical_device, staging_memory, vk_allocator);
+
+            return data;
+        };
+
+        const auto attributes = readBack(pool.VertexBuffer,   attribute_stride, false);
+        const auto positions  = readBack(pool.PositionBuffer, position_stride,  false);
+        const auto indices    = readBack(pool.IndexBuffer,    VulkanUtilities::getIndexSize(pool.IndexType), true);
+
+        for (uint32_t mesh = 0; mesh < BENCHMARK_POOL_MESHES; mesh += 2) {
+            const auto&       allocation = pool.Meshes[handles[mesh]];
+            const SourceMesh& source     = sources[mesh];
+
+            const bool survived =
+                memcmp(attributes.data() + static_cast<size_t>(allocation.Vertices.Offset) * attribute_stride, source.Attributes.data(), source.Attributes.size() * sizeof(uint32_t)) == 0 &&
+                memcmp(positions.data()  + static_cast<size_t>(allocation.Vertices.Offset) * position_stride,  source.Positions.data(),  source.Positions.size()  * sizeof(uint32_t)) == 0 &&
+                memcmp(indices.data()    + static_cast<size_t>(allocation.Indices.Offset)  * VulkanUtilities::getIndexSize(pool.IndexType), source.Indices.Data.data(), source.Indices.Data.size()) == 0;
+
+            if (!survived)
+                throw std::runtime_error{"Mesh " + std::to_string(mesh) + "'s data didn't survive compaction!"};
+        }
+
+        VulkanUtilities::destroyGeometryPool(vk_logical_device, pool);
+
+        spdlog::info(" . After compaction: {} of {} vertices and {} of {} indices in use, the rest is one hole at the tail",
+            next_vertex, vertex_capacity, next_index, index_capacity);
+
+        Benchmark::report(upload);
+        Benchmark::report(compact);
+    }
+
+    // 10k, 100k and 1M objects drawn through:
+    //  . Push constants, one vkCmdDrawIndexed per object (record time grows with the object count)
+    //  . The GPU-driven path, a culling dispatch plus one vkCmdDrawIndexedIndirectCount (record time should stay flat)
+    void benchmarkGpuDriven() {
+        if (!use_gpu_driven)
+            throw std::runtime_error{"The gpu-driven benchmark needs a device with indirect count draws!"};
+
+        // The material buffer is sized for the initial scene, the bigger grids would run off its end
+        if (use_bindless)
+            throw std::runtime_error{"The gpu-driven benchmark can't run with --bindless!"};
+
+        for (const uint32_t object_count : BENCHMARK_GPU_DRIVEN_COUNTS) {
+            vkDeviceWaitIdle(vk_logical_device);
+
+            createGridScene(object_count);
+
+            destroyGpuDrivenBuffers();
+            createGpuDrivenBuffers();
+
+            spdlog::info(" . {} objects, {} indirect draws max", object_count, gpu_max_draw_count);
+
+            object_data_path = ObjectDataPath::PushConstants;
+            const auto [cpu_record, cpu_frame] = measureFrames("Push constants", BENCHMARK_SCALING_FRAMES);
+
+            object_data_path = ObjectDataPath::GpuDriven;
+            const auto [gpu_record, gpu_frame] = measureFrames("GPU-driven", BENCHMARK_SCALING_FRAMES);
+
+            Benchmark::report(cpu_record, gpu_record);
+            Benchmark::report(cpu_frame,  gpu_frame);
+        }
+    }
+
+    // 100k objects in 10 layers stacked on top of each other, all of them inside the frustum, drawn through the GPU-driven path:
+    //  . Frustum culling only (every layer gets rasterized and shaded wherever the depth test lets it)
+    //  . Two-phase Hi-Z occlusion culling (the layers under the top one should mostly never be drawn)
+    void benchmarkOcclusionCulling() {
+        if (!use_occlusion_culling)
+            throw std::runtime_error{"The occlusion-culling benchmark needs a device with indirect count draws!"};
+
+        spdlog::info(" . {} objects in {} layers", gpu_object_count, BENCHMARK_OCCLUSION_LAYERS);
+
+        use_occlusion_culling = false;
+        const auto [frustum_record, frustum_frame] = measureFrames("Frustum culling", BENCHMARK_MEASURED_FRAMES);
+        const auto frustum_counts = readGpuDrawCounts();
+
+        use_occlusion_culling = true;
+        const auto [occlusion_record, occlusion_frame] = measureFrames("Hi-Z occlusion culling", BENCHMARK_MEASURED_FRAMES);
+        const auto occlusion_counts = readGpuDrawCounts();
+
+        spdlog::info(" . Frustum culling drew {} objects", frustum_counts.Early);
+        spdlog::info(" . Occlusion culling drew {} objects ({} early, {} late)", occlusion_counts.Early + occlusion_counts.Late, occlusion_counts.Early, occlusion_counts.Late);
+
+        Benchmark::report(frustum_record, occlusion_record);
+        Benchmark::report(frustum_frame,  occlusion_frame);
+    }
+
+    void benchmarkDepthPrepass() {
+        if (use_gpu_driven)
+            throw std::runtime_error{"The depth-prepass benchmark only runs on the CPU recorded path!"};
+
+        spdlog::info(" . {} objects in {} layers, drawn back to front", scene_objects.size(), BENCHMARK_OVERDRAW_LAYERS);
+
+        depth_prepass_enabled = false;
+        const auto [single_record, single_frame] = measureFrames("Depth test only", BENCHMARK_MEASURED_FRAMES);
+
+        depth_prepass_enabled = true;
+        const auto [prepass_record, prepass_frame] = measureFrames("Depth prepass + EQUAL", BENCHMARK_MEASURED_FRAMES);
+
+        Benchmark::report(single_record, prepass_record);
+        Benchmark::report(single_frame,  prepass_frame);
+    }
+
+    // 100k draws spread over random pipelines, materials and depths, recorded in submission order vs sorted:
+    //  . Binds are only counted (same BoundState as recordRenderQueue()), nothing is recorded for real
+    //  . The radix sort is timed against std::sort on the same keys
+    void benchmarkRenderQueue() {
+        std::mt19937                            generator{ 42 };
+        std::uniform_int_distribution<uint32_t> pipeline_distribution{ 0, BENCHMARK_QUEUE_PIPELINES - 1 };
+        std::uniform_int_distribution<uint32_t> material_distribution{ 0, BENCHMARK_QUEUE_MATERIALS - 1 };
+        std::uniform_real_distribution<float>   depth_distribution{ 0.1f, 100.0f };
+
+        Rendering::RenderQueue queue{};
+
+        for (uint32_t i = 0; i < BENCHMARK_QUEUE_DRAWS; i++)
+            Rendering::submitDraw(queue, Rendering::makeSortKey(QUEUE_PASS_OPAQUE, pipeline_distribution(generator), material_distribution(generator), depth_distribution(generator)), i);
+
+        const std::vector<Rendering::DrawItem> submitted = queue.Items;
+
+        const auto countBinds = [](const std::vector<Rendering::DrawItem>& items) {
+            Rendering::BoundState state{};
+
+            for (const auto& [key, object] : items) {
+                Rendering::bindIfChanged(state, state.Pipeline, Rendering::getSortKeyPipeline(key));
+                Rendering::bindIfChanged(state, state.Material, Rendering::getSortKeyMaterial(key));
+            }
+
+            return state.Statistics;
+        };
+
+        const auto radix_result = Benchmark::measure("Radix sort", BENCHMARK_QUEUE_SORTS, [&](uint64_t) {
+            queue.Items = submitted;
+            Rendering::sortRenderQueue(queue);
+        });
+
+        std::vector<Rendering::DrawItem> std_sorted;
+
+        const auto std_result = Benchmark::measure("std::sort", BENCHMARK_QUEUE_SORTS, [&](uint64_t) {
+            std_sorted = submitted;
+            std::ranges::sort(std_sorted, {}, &Rendering::DrawItem::Key);
+        });
+
+        // Both include the copy back to the submission order, which is the same for each
+        if (!std::ranges::equal(queue.Items, std_sorted, {}, &Rendering::DrawItem::Key, &Rendering::DrawItem::Key))
+            throw std::runtime_error{"Radix sorted render queue doesn't match std::sort!"};
+
+        const auto unsorted_binds = countBinds(submitted);
+        const auto sorted_binds   = countBinds(queue.Items);
+
+        spdlog::info(" . {} draws, {} pipelines, {} materials", BENCHMARK_QUEUE_DRAWS, BENCHMARK_QUEUE_PIPELINES, BENCHMARK_QUEUE_MATERIALS);
+        spdlog::info(" . Submission order: {} binds issued, {} skipped", unsorted_binds.Issued, unsorted_binds.Skipped);
+        spdlog::info(" . Sorted:           {} binds issued, {} skipped", sorted_binds.Issued,   sorted_binds.Skipped);
+
+        Benchmark::report(std_result, radix_result);
+    }
+
+    // The same feature sets through FeatureFS.frag, branching on the uniform buffer vs a specialized pipeline variant
+    void benchmarkSpecialization() {
+        if (use_gpu_driven || use_bindless)
+            throw std::runtime_error{"The specialization benchmark only runs on the plain push constant path!"};
+
+        for (const ShaderFeatures& features : BENCHMARK_SHADER_FEATURES) {
+            spdlog::info(" . Flags {:#x}, {} lights, {} noise octaves", features.Flags, features.LightCount, features.NoiseOctaves);
+
+            shader_features = features;
+
+            specialize_features = false;
+            const auto uniform = measureFrames("Uniform branches", BENCHMARK_MEASURED_FRAMES);
+
+            // Built here (blocking) so the specialized frames don't just draw the ubershader fallback while it compiles
+            const auto description    = describeGraphicsPipeline(vk_pipeline_layout, "res/vert.spv", "res/feature_frag.spv", DepthMode::Test, getFeatureConstants(features));
+            const auto compile_result = Benchmark::measure("Variant compile", 1, [&](uint64_t) { VulkanUtilities::getPipeline(pipeline_registry, description); });
+
+            specialize_features = true;
+            const auto specialized = measureFrames("Specialized", BENCHMARK_MEASURED_FRAMES);
+
+            Benchmark::report(uniform.Frame, specialized.Frame);
+            Benchmark::report(compile_result);
+        }
+
+        const auto statistics = VulkanUtilities::getPipelineRegistryStatistics(pipeline_registry);
+
+        spdlog::info(" . Registry: {} hits, {} misses, {} fallbacks", statistics.Hits, statistics.Misses, statistics.Fallbacks);
+    }
+
+    // Every flag combination with each of the light and octave counts
+    std::vector<VulkanUtilities::GraphicsPipelineDescription> describeFeatureVariants() {
+        std::vector<VulkanUtilities::GraphicsPipelineDescription> descriptions;
+
+        for (uint32_t flags = 0; flags <= (SHADER_FEATURE_TINT | SHADER_FEATURE_LIGHTING | SHADER_FEATURE_NOISE); flags++)
+            for (const uint32_t light_count : BENCHMARK_REGISTRY_LIGHT_COUNTS)
+                for (const uint32_t noise_octaves : BENCHMARK_REGISTRY_NOISE_OCTAVES)
+                    descriptions.push_back(describeGraphicsPipeline(vk_pipeline_layout, "res/vert.spv", "res/feature_frag.spv", DepthMode::Test, { flags, light_count, noise_octaves }));
+
+        return descriptions;
+    }
+
+    // Every FeatureFS.frag variant compiled one after the other vs on the registry's worker threads
+    //  . Each run gets its own registry so neither one finds the other's pipelines (the driver may still cache the shaders, so run it on a cold cache for real numbers)
+    void benchmarkPipelineRegistry() {
+        const auto descriptions = describeFeatureVariants();
+
+        VulkanUtilities::PipelineRegistry serial_registry;
+        VulkanUtilities::PipelineRegistry parallel_registry;
+
+        VulkanUtilities::createPipelineRegistry(serial_registry, vk_logical_device, 0);
+        VulkanUtilities::createPipelineRegistry(parallel_registry, vk_logical_device);
+
+        const auto serial_result = Benchmark::measure("Serial compile", 1, [&](uint64_t) {
+            for (const auto& description : descriptions)
+                VulkanUtilities::getPipeline(serial_registry, description);
+        });
+
+        const auto parallel_result = Benchmark::measure("Background compile", 1, [&](uint64_t) {
+            for (const auto& description : descriptions)
+                VulkanUtilities::requestPipeline(parallel_registry, description, VK_NULL_HANDLE);
+
+            VulkanUtilities::waitForPipelines(parallel_registry);
+        });
+
+        // Everything is in there now, this is what every frame pays
+        const auto lookup_result = Benchmark::measure("Lookup", BENCHMARK_REGISTRY_LOOKUPS, [&](const uint64_t i) {
+            VulkanUtilities::getPipeline(parallel_registry, descriptions[i % descriptions.size()]);
+        });
+
+        const auto serial_statistics   = VulkanUtilities::getPipelineRegistryStatistics(serial_registry);
+        const auto parallel_statistics = VulkanUtilities::getPipelineRegistryStatistics(parallel_registry);
+
+        spdlog::info(" . {} variants, {} worker threads", descriptions.size(), parallel_registry.Workers ? parallel_registry.Workers->threadCount() : 0);
+        spdlog::info(" . Summed compile time: {:.2f}ms serial, {:.2f}ms background", serial_statistics.CompileMilliseconds, parallel_statistics.CompileMilliseconds);
+
+        Benchmark::report(serial_result, parallel_result);
+        Benchmark::report(lookup_result);
+
+        VulkanUtilities::destroyPipelineRegistry(serial_registry);
+        VulkanUtilities::destroyPipelineRegistry(parallel_registry);
+    }
+
+    // The FeatureFS.frag variants built in one piece vs from library parts
+    //  . Only the fragment shader part differs between variants, the other three parts are compiled once and shared
+    //  . A fast link is what a draw waits on when a variant is missing, the optimized link is what replaces it in the background
+    void benchmarkPipelineLibrary() {
+        if (!use_pipeline_libraries)
+            throw std::runtime_error{"The pipeline library benchmark needs VK_EXT_graphics_pipeline_library!"};
+
+        const auto descriptions = describeFeatureVariants();
+
+        std::vector<VkPipeline>                            pipelines;
+        std::vector<VulkanUtilities::PipelineLibraryParts> parts;
+        VulkanUtilities::PipelineLibraryCache              library_cache;
+
+        const auto monolithic_result = Benchmark::measure("Monolithic", 1, [&](uint64_t) {
+            for (const auto& description : descriptions)
+                pipelines.push_back(VulkanUtilities::createGraphicsPipeline(vk_logical_device, description));
+        });
+
+        const auto parts_result = Benchmark::measure("Library parts", 1, [&](uint64_t) {
+            for (const auto& description : descriptions)
+                parts.push_back(VulkanUtilities::getPipelineLibraryParts(vk_logical_device, library_cache, description));
+        });
+
+        const auto fast_link_result = Benchmark::measure("Fast link", 1, [&](uint64_t) {
+            for (size_t i = 0; i < descriptions.size(); i++)
+                pipelines.push_back(VulkanUtilities::linkPipelineLibraries(vk_logical_device, descriptions[i], parts[i], false));
+        });
+
+        const auto optimized_link_result = Benchmark::measure("Optimized link", 1, [&](uint64_t) {
+            for (size_t i = 0; i < descriptions.size(); i++)
+                pipelines.push_back(VulkanUtilities::linkPipelineLibraries(vk_logical_device, descriptions[i], parts[i], true));
+        });
+
+        const Benchmark::Result library_result{ "Parts + fast link", 1, parts_result.TotalMilliseconds + fast_link_result.TotalMilliseconds };
+
+        const auto library_statistics = VulkanUtilities::getPipelineLibraryStatistics(library_cache);
+
+        spdlog::info(" . {} variants, {} parts compiled, {} reused", descriptions.size(), library_statistics.Misses, library_statistics.Hits);
+
+        Benchmark::report(monolithic_result, library_result);
+        Benchmark::report(monolithic_result, fast_link_result);
+        Benchmark::report(fast_link_result, optimized_link_result);
+
+        for (const VkPipeline pipeline : pipelines)
+            vkDestroyPipeline(vk_logical_device, pipeline, vk_allocator);
+
+        VulkanUtilities::destroyPipelineLibraryCache(vk_logical_device, library_cache);
+    }
+
+    // A material set that only differs in fixed function state, every combination baked into its own pipeline vs set on the command buffer
+    //  . Both registries compile on this thread, so the totals compare directly
+    //  . Blending stays baked on devices without extended dynamic state 3, those materials still split
+    void benchmarkDynamicState() {
+        if (dynamic_pipeline_state == 0)
+            throw std::runtime_error{"The dynamic state benchmark needs VK_EXT_extended_dynamic_state!"};
+
+        std::vector<VulkanUtilities::FixedFunctionState> materials;
+
+        for (const VkCullModeFlags cull_mode : BENCHMARK_MATERIAL_CULL_MODES)
+            for (const VkPrimitiveTopology topology : BENCHMARK_MATERIAL_TOPOLOGIES)
+                for (const VkCompareOp depth_compare : BENCHMARK_MATERIAL_DEPTH_COMPARES)
+                    for (const VkBool32 blend : { VK_FALSE, VK_TRUE }) {
+                        VulkanUtilities::FixedFunctionState material{};
+
+                        material.CullMode     = cull_mode;
+                        material.Topology     = topology;
+                        material.DepthCompare = depth_compare;
+                        material.DepthWrite   = !blend; // Transparent materials test against depth but don't write it
+                        material.BlendEnable  = blend;
+
+                        materials.push_back(material);
+                    }
+
+        VulkanUtilities::PipelineRegistry baked_registry;
+        VulkanUtilities::PipelineRegistry dynamic_registry;
+
+        VulkanUtilities::createPipelineRegistry(baked_registry,   vk_logical_device, 0);
+        VulkanUtilities::createPipelineRegistry(dynamic_registry, vk_logical_device, 0);
+
+        const auto measureMaterials = [&materials](const std::string& name, VulkanUtilities::PipelineRegistry& registry, const uint32_t dynamic_state) {
+            return Benchmark::measure(name, 1, [&](uint64_t) {
+                for (const auto& material : materials) {
+                    auto description = describeGraphicsPipeline(vk_pipeline_layout, "res/vert.spv", "res/frag.spv", DepthMode::Test);
+
+                    description.FixedFunction = material;
+                    description.DynamicState  = dynamic_state;
+
+                    VulkanUtilities::getPipeline(registry, description);
+                }
+            });
+        };
+
+        const auto baked_result   = measureMaterials("Baked state",   baked_registry,   0);
+        const auto dynamic_result = measureMaterials("Dynamic state", dynamic_registry, dynamic_pipeline_state);
+
+        const auto baked_statistics   = VulkanUtilities::getPipelineRegistryStatistics(baked_registry);
+        const auto dynamic_statistics = VulkanUtilities::getPipelineRegistryStatistics(dynamic_registry);
+
+        spdlog::info(" . {} materials, dynamic state bits {:#x}", materials.size(), dynamic_pipeline_state);
+        spdlog::info(" . Baked:   {} pipelines, {:.2f}ms compiling", baked_registry.Entries.size(),   baked_statistics.CompileMilliseconds);
+        spdlog::info(" . Dynamic: {} pipelines, {:.2f}ms compiling", dynamic_registry.Entries.size(), dynamic_statistics.CompileMilliseconds);
+
+        Benchmark::report(baked_result, dynamic_result);
+
+        VulkanUtilities::destroyPipelineRegistry(baked_registry);
+        VulkanUtilities::destroyPipelineRegistry(dynamic_registry);
+    }
+
+    // Querying every device from scratch vs reading the disk cache, and what a lookup costs once it's all in memory
+    //  . The surface half gets queried either way, so the difference is what the cache actually saves at startup
+    //  . Goes through its own cache file, the real one is left alone
+    void benchmarkDeviceCapabilities() {
+        const std::string cache_path = std::string{DEVICE_CAPABILITY_CACHE_PATH} + ".benchmark";
+
+        std::remove(cache_path.c_str());
+
+        // Writes the file, so every measured run below is a hit
+        VulkanUtilities::queryDeviceCapabilities(vk_instance, vk_surface, cache_path);
+
+        const auto uncached_result = Benchmark::measure("Queried", BENCHMARK_CAPABILITY_QUERIES, [](uint64_t) {
+            VulkanUtilities::queryDeviceCapabilities(vk_instance, vk_surface, "");
+        });
+
+        const auto cached_result = Benchmark::measure("Disk cache", BENCHMARK_CAPABILITY_QUERIES, [&cache_path](uint64_t) {
+            VulkanUtilities::queryDeviceCapabilities(vk_instance, vk_surface, cache_path);
+        });
+
+        // What selectPhysicalDevice() does for every device
+        const auto lookup_result = Benchmark::measure("Suitability lookup", BENCHMARK_CAPABILITY_QUERIES, [](uint64_t) {
+            for (const auto& capabilities : device_capabilities.Devices)
+                isDeviceSuitable(capabilities.Device);
+        });
+
+        spdlog::info(" . {} devices, {:.2f}ms spent on capabilities during startup", device_capabilities.Devices.size(), device_capabilities.QueryMilliseconds);
+
+        Benchmark::report(uncached_result, cached_result);
+        Benchmark::report(lookup_result);
+
+        std::remove(cache_path.c_str());
+    }
+
+    // What a command scope allocation costs through the arenas vs the heap path every other scope takes,
+    // then which scopes the driver actually allocates from while frames are being drawn (the churn worth going after)
+    void benchmarkHostAllocator() {
+        if (!vk_allocator)
+            throw std::runtime_error{"The host allocator benchmark needs the host allocator, drop --system-allocator!"};
+
+        const auto measureScope = [](const std::string& name, const VkSystemAllocationScope scope) {
+            return Benchmark::measure(name, BENCHMARK_HOST_ALLOCATIONS, [scope](uint64_t) {
+                void* memory = vk_allocator->pfnAllocation(vk_allocator->pUserData, BENCHMARK_HOST_ALLOCATION_SIZE, 16, scope);
+                vk_allocator->pfnFree(vk_allocator->pUserData, memory);
+            });
+        };
+
+        const auto heap_result  = measureScope("Heap (object scope)",   VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+        const auto arena_result = measureScope("Arena (command scope)", VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+
+        Benchmark::report(heap_result, arena_result);
+
+        const auto before = VulkanUtilities::getHostAllocatorStatistics();
+        const auto frames = measureFrames("Frames", BENCHMARK_MEASURED_FRAMES);
+        const auto after  = VulkanUtilities::getHostAllocatorStatistics();
+
+        const auto frame_count = std::max<uint64_t>(frames.Frame.Iterations, 1);
+
+        spdlog::info(" . Host allocations per frame over {} frames:", frames.Frame.Iterations);
+
+        for (uint32_t scope = 0; scope < VulkanUtilities::HOST_ALLOCATION_SCOPE_COUNT; scope++) {
+            const uint64_t allocations = after.Scopes[scope].Allocations - before.Scopes[scope].Allocations;
+            const uint64_t bytes       = after.Scopes[scope].TotalBytes  - before.Scopes[scope].TotalBytes;
+
+            spdlog::info("   . {:<8} {:.2f} allocations, {:.0f} bytes",
+                VulkanUtilities::getAllocationScopeName(static_cast<VkSystemAllocationScope>(scope)),
+                static_cast<double>(allocations) / frame_count, static_cast<double>(bytes) / frame_count);
+        }
+
+        Benchmark::report(frames.Frame);
+    }
+
+    // Steady state frames shouldn't touch the heap, every new/delete on the main thread is counted while a frame is drawn
+    //  . Sites are return addresses, "addr2line -f -C -e VulkanLearning.exe <address>" turns them into functions
+    //  . The driver's own allocations come through the host allocator, they are reported but don't fail the run (nothing to fix here)
+    //  . Anything the app allocates fails it, so a run with "--benchmark frame-allocations" doubles as the check
+    void benchmarkFrameAllocations() {
+        for (uint32_t i = 0; i < BENCHMARK_WARMUP_FRAMES && !glfwWindowShouldClose(window); i++) {
+            glfwPollEvents();
+            drawFrame();
+        }
+
+        StandardUtilities::AllocationReport total{};
+        uint32_t                            allocating_frames = 0;
+        Benchmark::Result                   frames{ "Tracked frames", 0, 0.0 };
+
+        const auto host_before = vk_allocator ? VulkanUtilities::getHostAllocatorStatistics() : VulkanUtilities::HostAllocatorStatistics{};
+
+        for (uint32_t i = 0; i < BENCHMARK_ALLOCATION_FRAMES && !glfwWindowShouldClose(window); i++) {
+            glfwPollEvents();
+
+            StandardUtilities::armAllocationTracking();
+            drawFrame();
+            const auto report = StandardUtilities::disarmAllocationTracking();
+
+            if (report.Allocations > 0)
+                allocating_frames++;
+
+            StandardUtilities::accumulateAllocationReport(total, report);
+
+            frames.Iterations++;
+            frames.TotalMilliseconds += last_frame_statistics.FrameMilliseconds;
+        }
+
+        spdlog::info(" . {} of {} frames allocated: {} allocations, {} frees, {} bytes", allocating_frames, frames.Iterations, total.Allocations, total.Frees, total.Bytes);
+
+        for (uint32_t i = 0; i < total.SiteCount; i++) {
+            const auto& [address, count, bytes] = total.Sites[i];
+            spdlog::info("   . {} {} allocations, {} bytes", address, count, bytes);
+        }
+
+        if (total.DroppedSites > 0)
+            spdlog::info("   . {} more from sites that didn't fit", total.DroppedSites);
+
+        if (vk_allocator) {
+            const auto host_after = VulkanUtilities::getHostAllocatorStatistics();
+
+            for (uint32_t scope = 0; scope < VulkanUtilities::HOST_ALLOCATION_SCOPE_COUNT; scope++) {
+                const auto& before = host_before.Scopes[scope];
+                const auto& after  = host_after.Scopes[scope];
+
+                // Arena allocations don't reach the heap
+                const uint64_t heap_allocations = (after.Allocations - after.ArenaAllocations) - (before.Allocations - before.ArenaAllocations);
+
+                if (heap_allocations > 0)
+                    spdlog::warn(" . The driver made {} heap allocations in the {} scope", heap_allocations,
+                        VulkanUtilities::getAllocationScopeName(static_cast<VkSystemAllocationScope>(scope)));
+            }
+        }
+
+        Benchmark::report(frames);
+
+        if (total.Allocations > 0)
+            throw std::runtime_error{"Steady state frames allocated on the heap!"};
+    }
+
+    // The level is fixed once the instance exists, so this measures whichever one --validation picked
+    //  . Run it once per level (off, core, sync, best-practices, gpu-assisted) and compare startup, record and frame times
+    //  . Every level but off needs the layer installed (the Vulkan SDK has it)
+    void benchmarkValidation() {
+        spdlog::info(" . Validation: {}, Vulkan initialized in {:.2f}ms", getValidationLevelName(validation_level), vulkan_init_milliseconds);
+
+        const auto messages_before = VulkanUtilities::getDebugMessageStatistics();
+        const auto frames          = measureFrames("Frames", BENCHMARK_MEASURED_FRAMES);
+        const auto messages_after  = VulkanUtilities::getDebugMessageStatistics();
+
+        spdlog::info(" . {} validation messages while measuring", messages_after.Received - messages_before.Received);
+
+        Benchmark::report(frames.Record);
+        Benchmark::report(frames.Frame);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,366 @@
+#include "HelloTriangle.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "spdlog/spdlog.h"
+
+#include "VulkanUtilities/BufferUtils.hpp"
+#include "VulkanUtilities/CullingUtils.hpp"
+#include "VulkanUtilities/DebugNames.hpp"
+#include "VulkanUtilities/ExtensionUtils.hpp"
+
+// GPU-driven path ("--gpu-driven"), the CPU records the same handful of commands no matter how many objects there are:
+//  . CullObjectsCS frustum culls every object and appends a VkDrawIndexedIndirectCommand for the visible ones
+//  . One vkCmdDrawIndexedIndirectCount then draws whatever survived
+// Objects are static on this path, their transforms are uploaded once by createGpuDrivenBuffers()
+// Occlusion culling runs the same two steps twice around a depth pyramid build (see HelloTriangleOcclusion.cpp)
+
+namespace HelloTriangle {
+    // Set 0 of the culling pass and set 1 of the GPU-driven graphics pipeline
+    void createCullingSetLayout() {
+        std::array<VkDescriptorSetLayoutBinding, 5> bindings{};
+
+        // Binding 0: GpuObjects (the vertex shader reads the Model matrix from here too)
+        bindings[0].binding         = 0;
+        bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[0].descriptorCount = 1;
+        bindings[0].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+
+        // Binding 1: Draw commands written by the culling pass
+        bindings[1].binding         = 1;
+        bindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[1].descriptorCount = 1;
+        bindings[1].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        // Binding 2: Draw counts (early/all and late)
+        bindings[2].binding         = 2;
+        bindings[2].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[2].descriptorCount = 1;
+        bindings[2].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        // Binding 3: Last frame's visibility, one uint per object
+        bindings[3].binding         = 3;
+        bindings[3].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[3].descriptorCount = 1;
+        bindings[3].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        // Binding 4: Depth pyramid (always written, the shader declares it even when occlusion culling is off)
+        bindings[4].binding         = 4;
+        bindings[4].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[4].descriptorCount = 1;
+        bindings[4].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkDescriptorSetLayoutCreateInfo create_info{};
+
+        create_info.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        create_info.bindingCount = static_cast<uint32_t>(bindings.size());
+        create_info.pBindings    = bindings.data();
+
+        if (vkCreateDescriptorSetLayout(vk_logical_device, &create_info, vk_allocator, &vk_culling_set_layout) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create the culling descriptor set layout!"};
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, vk_culling_set_layout, "Culling set layout");
+    }
+
+    void createGpuDrivenPipelines() {
+        VkPushConstantRange push_constant_range{};
+
+        push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        push_constant_range.offset     = 0;
+        push_constant_range.size       = sizeof(CullingPushConstants);
+
+        VkPipelineLayoutCreateInfo culling_layout_info{};
+
+        culling_layout_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        culling_layout_info.setLayoutCount         = 1;
+        culling_layout_info.pSetLayouts            = &vk_culling_set_layout;
+        culling_layout_info.pushConstantRangeCount = 1;
+        culling_layout_info.pPushConstantRanges    = &push_constant_range;
+
+        if (vkCreatePipelineLayout(vk_logical_device, &culling_layout_info, vk_allocator, &vk_culling_pipeline_layout) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create the culling Pipeline Layout!"};
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_PIPELINE_LAYOUT, vk_culling_pipeline_layout, "Culling pipeline layout");
+
+        vk_culling_pipeline = buildComputePipeline(vk_culling_pipeline_layout, "res/cull_comp.spv");
+
+        // Set 0 is the normal scene set (camera), set 1 the culling set (objects)
+        const VkDescriptorSetLayout set_layouts[] = { vk_descriptor_set_layout, vk_culling_set_layout };
+
+        VkPipelineLayoutCreateInfo graphics_layout_info{};
+
+        graphics_layout_info.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        graphics_layout_info.setLayoutCount = 2;
+        graphics_layout_info.pSetLayouts    = set_layouts;
+
+        if (vkCreatePipelineLayout(vk_logical_device, &graphics_layout_info, vk_allocator, &vk_gpu_driven_pipeline_layout) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create the GPU-driven Pipeline Layout!"};
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_PIPELINE_LAYOUT, vk_gpu_driven_pipeline_layout, "GPU-driven pipeline layout");
+
+        vk_gpu_driven_pipeline = buildGraphicsPipeline(vk_gpu_driven_pipeline_layout, "res/gpu_driven_vert.spv", "res/frag.spv", DepthMode::Test, "GPU-driven pipeline");
+
+        createDepthPyramidPipeline();
+    }
+
+    void destroyGpuDrivenPipelines() {
+        destroyDepthPyramidPipeline();
+
+        vkDestroyPipeline(vk_logical_device, vk_culling_pipeline, vk_allocator);
+        vkDestroyPipelineLayout(vk_logical_device, vk_culling_pipeline_layout, vk_allocator);
+        vkDestroyPipelineLayout(vk_logical_device, vk_gpu_driven_pipeline_layout, vk_allocator);
+        vkDestroyDescriptorSetLayout(vk_logical_device, vk_culling_set_layout, vk_allocator);
+    }
+
+    // One GpuObject per (scene object, mesh chunk), so the culling pass never has to know about chunks
+    void createGpuDrivenBuffers() {
+        updateSceneObjects(0.0f);
+
+        std::vector<glm::vec3> mesh_positions;
+        for (const auto& vertex : VERTICES)
+            mesh_positions.emplace_back(vertex.Position, 0.0f);
+
+        const glm::vec4 mesh_sphere = VulkanUtilities::computeBoundingSphere(mesh_positions);
+        const auto&     chunks      = geometry_pool.Meshes[quad_mesh].Chunks;
+
+        std::vector<GpuObject> gpu_objects;
+        gpu_objects.reserve(scene_objects.size() * chunks.size());
+
+        for (const auto& object : scene_objects)
+            for (const auto& chunk : chunks)
+                gpu_objects.push_back({ object.Transform, VulkanUtilities::transformBoundingSphere(object.Transform, mesh_sphere), chunk.IndexCount, chunk.FirstIndex, chunk.VertexOffset, object.MaterialIndex });
+
+        gpu_object_count = static_cast<uint32_t>(gpu_objects.size());
+
+        if (gpu_object_count == 0)
+            throw std::runtime_error{"The GPU-driven path needs at least one object!"};
+
+        // Objects: device local, uploaded once
+        const VkDeviceSize object_size = sizeof(GpuObject) * gpu_objects.size();
+
+        VkBuffer       staging_buffer;
+        VkDeviceMemory staging_memory;
+        VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, object_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, staging_buffer, staging_memory);
+
+        void* data;
+        vkMapMemory(vk_logical_device, staging_memory, 0, object_size, 0, &data);
+        memcpy(data, gpu_objects.data(), object_size);
+        vkUnmapMemory(vk_logical_device, staging_memory);
+
+        VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, object_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vk_gpu_object_buffer, vk_gpu_object_memory);
+
+        VulkanUtilities::copyBuffer(vk_logical_device, vk_command_pool, vk_graphics_queue, staging_buffer, vk_gpu_object_buffer, object_size);
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, vk_gpu_object_buffer, "GPU objects");
+
+        vkDestroyBuffer(vk_logical_device, staging_buffer, vk_allocator);
+        vkFreeMemory(vk_logical_device, staging_memory, vk_allocator);
+
+        // Draw commands and count: one set per frame in flight, the culling pass of the next frame would stomp on them otherwise
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(vk_physical_device, &properties);
+
+        gpu_max_draw_count = std::min(gpu_object_count, properties.limits.maxDrawIndirectCount);
+        if (gpu_max_draw_count < gpu_object_count)
+            spdlog::warn(" . maxDrawIndirectCount is {}, only that many of the {} objects can be drawn", gpu_max_draw_count, gpu_object_count);
+
+        // Room for every object in both the early and the late region, occlusion culling can be switched on at any time
+        const VkDeviceSize draw_size  = sizeof(VkDrawIndexedIndirectCommand) * gpu_max_draw_count * CULLING_DRAW_REGIONS;
+        const VkDeviceSize count_size = sizeof(uint32_t) * CULLING_DRAW_REGIONS;
+
+        // Visibility: starts out all 0, so the first frame's early phase draws nothing and the late phase catches everything
+        const VkDeviceSize visibility_size = sizeof(uint32_t) * gpu_object_count;
+
+        VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, visibility_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vk_visibility_buffer, vk_visibility_memory);
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, vk_visibility_buffer, "Visibility");
+
+        const VkCommandBuffer command_buffer = VulkanUtilities::beginSingleTimeCommands(vk_logical_device, vk_command_pool);
+        vkCmdFillBuffer(command_buffer, vk_visibility_buffer, 0, visibility_size, 0);
+        VulkanUtilities::endSingleTimeCommands(vk_logical_device, vk_command_pool, vk_graphics_queue, command_buffer);
+
+        vk_draw_command_buffers.resize(MAX_FRAMES_IN_FLIGHT);
+        vk_draw_command_memorys.resize(MAX_FRAMES_IN_FLIGHT);
+        vk_draw_count_buffers.resize(MAX_FRAMES_IN_FLIGHT);
+        vk_draw_count_memorys.resize(MAX_FRAMES_IN_FLIGHT);
+        vk_draw_count_readback_buffers.resize(MAX_FRAMES_IN_FLIGHT);
+        vk_draw_count_readback_memorys.resize(MAX_FRAMES_IN_FLIGHT);
+        vk_draw_count_readback_mapped.resize(MAX_FRAMES_IN_FLIGHT);
+        vk_culling_descriptor_sets.resize(MAX_FRAMES_IN_FLIGHT);
+
+        culling_descriptor_allocator = VulkanUtilities::createDescriptorAllocator(MAX_FRAMES_IN_FLIGHT, {
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         4.0f },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f }
+        });
+
+        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, draw_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vk_draw_command_buffers[i], vk_draw_command_memorys[i]);
+
+            VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, count_size,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vk_draw_count_buffers[i], vk_draw_count_memorys[i]);
+
+            // The counts get copied out at the end of the frame, so the CPU can see how much the culling threw away
+            VulkanUtilities::createBuffer(vk_logical_device, vk_physical_device, count_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, vk_draw_count_readback_buffers[i], vk_draw_count_readback_memorys[i]);
+
+            vkMapMemory(vk_logical_device, vk_draw_count_readback_memorys[i], 0, count_size, 0, &vk_draw_count_readback_mapped[i]);
+            memset(vk_draw_count_readback_mapped[i], 0, count_size);
+
+            const auto frame = static_cast<uint32_t>(i);
+
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, vk_draw_command_buffers[i],        "Draw commands",       frame);
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, vk_draw_count_buffers[i],          "Draw counts",         frame);
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_BUFFER, vk_draw_count_readback_buffers[i], "Draw count readback", frame);
+
+            vk_culling_descriptor_sets[i] = VulkanUtilities::allocateDescriptorSet(vk_logical_device, culling_descriptor_allocator, vk_culling_set_layout);
+
+            const VkDescriptorBufferInfo buffer_infos[] = {
+                { vk_gpu_object_buffer,       0, VK_WHOLE_SIZE },
+                { vk_draw_command_buffers[i], 0, VK_WHOLE_SIZE },
+                { vk_draw_count_buffers[i],   0, VK_WHOLE_SIZE },
+                { vk_visibility_buffer,       0, VK_WHOLE_SIZE }
+            };
+
+            std::array<VkWriteDescriptorSet, 4> descriptor_writes{};
+
+            for (uint32_t binding = 0; binding < descriptor_writes.size(); binding++) {
+                descriptor_writes[binding].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptor_writes[binding].dstSet          = vk_culling_descriptor_sets[i];
+                descriptor_writes[binding].dstBinding      = binding;
+                descriptor_writes[binding].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                descriptor_writes[binding].descriptorCount = 1;
+                descriptor_writes[binding].pBufferInfo     = &buffer_infos[binding];
+            }
+
+            vkUpdateDescriptorSets(vk_logical_device, static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data(), 0, nullptr);
+        }
+
+        writeCullingPyramidDescriptors();
+    }
+
+    // The GPU can't be using any of it anymore (vkDeviceWaitIdle first)
+    void destroyGpuDrivenBuffers() {
+        VulkanUtilities::destroyDescriptorAllocator(vk_logical_device, culling_descriptor_allocator);
+
+        for (size_t i = 0; i < vk_draw_command_buffers.size(); i++) {
+            vkDestroyBuffer(vk_logical_device, vk_draw_command_buffers[i], vk_allocator);
+            vkFreeMemory(vk_logical_device, vk_draw_command_memorys[i], vk_allocator);
+            vkDestroyBuffer(vk_logical_device, vk_draw_count_buffers[i], vk_allocator);
+            vkFreeMemory(vk_logical_device, vk_draw_count_memorys[i], vk_allocator);
+            vkDestroyBuffer(vk_logical_device, vk_draw_count_readback_buffers[i], vk_allocator);
+            vkFreeMemory(vk_logical_device, vk_draw_count_readback_memorys[i], vk_allocator);
+        }
+
+        vkDestroyBuffer(vk_logical_device, vk_gpu_object_buffer, vk_allocator);
+        vkFreeMemory(vk_logical_device, vk_gpu_object_memory, vk_allocator);
+        vkDestroyBuffer(vk_logical_device, vk_visibility_buffer, vk_allocator);
+        vkFreeMemory(vk_logical_device, vk_visibility_memory, vk_allocator);
+
+        vk_draw_command_buffers.clear();
+        vk_draw_command_memorys.clear();
+        vk_draw_count_buffers.clear();
+        vk_draw_count_memorys.clear();
+        vk_draw_count_readback_buffers.clear();
+        vk_draw_count_readback_memorys.clear();
+        vk_draw_count_readback_mapped.clear();
+        vk_culling_descriptor_sets.clear();
+
+        vk_gpu_object_buffer = VK_NULL_HANDLE;
+        vk_gpu_object_memory = VK_NULL_HANDLE;
+        vk_visibility_buffer = VK_NULL_HANDLE;
+        vk_visibility_memory = VK_NULL_HANDLE;
+        gpu_object_count     = 0;
+    }
+
+    // Recorded outside the render pass: (clear the counts,) cull, then make the results visible to the indirect draw
+    //  . The late phase keeps the counts, the early phase already cleared them for both
+    void recordCullingPass(const VkCommandBuffer buffer, const CullingPhase phase) {
+        const VulkanUtilities::DebugLabelScope label{ buffer, phase == CullingPhase::Early ? "Culling (early)" : phase == CullingPhase::Late ? "Culling (late)" : "Culling" };
+
+        if (phase != CullingPhase::Late) {
+            vkCmdFillBuffer(buffer, vk_draw_count_buffers[current_frame], 0, sizeof(uint32_t) * CULLING_DRAW_REGIONS, 0);
+
+            // Also covers the previous frame's visibility writes and pyramid reads (the pyramid gets rebuilt in a moment)
+            VkMemoryBarrier clear_barrier{};
+
+            clear_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            clear_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            clear_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+            vkCmdPipelineBarrier(buffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &clear_barrier, 0, nullptr, 0, nullptr);
+        }
+
+        CullingPushConstants push_constants{};
+
+        push_constants.ViewProjection = scene_camera.Projection * scene_camera.View;
+        push_constants.PyramidSize    = { static_cast<float>(depth_pyramid.Width), static_cast<float>(depth_pyramid.Height) };
+        push_constants.ObjectCount    = gpu_max_draw_count;
+        push_constants.Phase          = static_cast<uint32_t>(phase);
+        push_constants.PyramidLevels  = depth_pyramid.MipLevels;
+
+        vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, vk_culling_pipeline);
+        vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, vk_culling_pipeline_layout, 0, 1, &vk_culling_descriptor_sets[current_frame], 0, nullptr);
+        vkCmdPushConstants(buffer, vk_culling_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullingPushConstants), &push_constants);
+
+        vkCmdDispatch(buffer, (gpu_max_draw_count + CULLING_WORKGROUP_SIZE - 1) / CULLING_WORKGROUP_SIZE, 1, 1);
+
+        // The counts are copied out again at the end of the frame, hence the transfer read
+        VkMemoryBarrier cull_barrier{};
+
+        cull_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        cull_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        cull_barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+
+        vkCmdPipelineBarrier(buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &cull_barrier, 0, nullptr, 0, nullptr);
+    }
+
+    // Recorded inside the render pass, with the GPU-driven pipeline and the geometry pool already bound
+    void recordGpuDrivenDraws(const VkCommandBuffer buffer, const CullingPhase phase) {
+        const uint32_t        dynamic_offset = 0;
+        const VkDescriptorSet sets[]         = { vk_descriptor_sets[current_frame], vk_culling_descriptor_sets[current_frame] };
+
+        vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vk_gpu_driven_pipeline_layout, 0, 2, sets, 1, &dynamic_offset);
+
+        const uint32_t     region       = phase == CullingPhase::Late ? 1 : 0;
+        const VkDeviceSize draw_offset  = sizeof(VkDrawIndexedIndirectCommand) * gpu_max_draw_count * region;
+        const VkDeviceSize count_offset = sizeof(uint32_t) * region;
+
+        VulkanUtilities::cmdDrawIndexedIndirectCountKHR(buffer, vk_draw_command_buffers[current_frame], draw_offset, vk_draw_count_buffers[current_frame], count_offset,
+            gpu_max_draw_count, sizeof(VkDrawIndexedIndirectCommand));
+    }
+
+    void recordDrawCountReadback(const VkCommandBuffer buffer) {
+        const VulkanUtilities::DebugLabelScope label{ buffer, "Draw count readback" };
+
+        VkBufferCopy copy_region{};
+
+        copy_region.size = sizeof(uint32_t) * CULLING_DRAW_REGIONS;
+
+        vkCmdCopyBuffer(buffer, vk_draw_count_buffers[current_frame], vk_draw_count_readback_buffers[current_frame], 1, &copy_region);
+
+        VkMemoryBarrier host_barrier{};
+
+        host_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        host_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        host_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+        vkCmdPipelineBarrier(buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &host_barrier, 0, nullptr, 0, nullptr);
+    }
+
+    // Waits for the GPU, then reads back the counts of the last frame that was submitted
+    GpuDrawCounts readGpuDrawCounts() {
+        vkDeviceWaitIdle(vk_logical_device);
+
+        const uint32_t last_frame = (current_frame + MAX_FRAMES_IN_FLIGHT - 1) % MAX_FRAMES_IN_FLIGHT;
+
+        GpuDrawCounts counts{};
+        memcpy(&counts, vk_draw_count_readback_mapped[last_frame], sizeof(counts));
+
+        return counts;
+    }
+}
\ No newline at end of file
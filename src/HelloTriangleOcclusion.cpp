@@ -0,0 +1,227 @@
+#include "HelloTriangle.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "VulkanUtilities/DebugNames.hpp"
+#include "VulkanUtilities/DepthPyramid.hpp"
+#include "VulkanUtilities/ImageUtils.hpp"
+
+// Two-phase Hi-Z occlusion culling ("--occlusion-culling", on top of the GPU-driven path):
+//  . Early: draw what was visible last frame (frustum culled only), that depth is a good guess of what this frame hides
+//  . Build the depth pyramid from it, every level keeps the farthest depth of the four texels under it
+//  . Late:  cull everything against the frustum and the pyramid, draw whatever is visible but wasn't drawn yet, remember the visibility for next frame
+// Hidden objects never get past the late phase, and objects coming into view aren't lost either (the late phase draws them the same frame)
+
+namespace HelloTriangle {
+    void createDepthPyramidPipeline() {
+        std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+
+        // Binding 0: The level below (the depth buffer for level 0)
+        bindings[0].binding         = 0;
+        bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[0].descriptorCount = 1;
+        bindings[0].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        // Binding 1: The level being written
+        bindings[1].binding         = 1;
+        bindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        bindings[1].descriptorCount = 1;
+        bindings[1].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkDescriptorSetLayoutCreateInfo set_layout_info{};
+
+        set_layout_info.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        set_layout_info.bindingCount = static_cast<uint32_t>(bindings.size());
+        set_layout_info.pBindings    = bindings.data();
+
+        if (vkCreateDescriptorSetLayout(vk_logical_device, &set_layout_info, vk_allocator, &vk_depth_pyramid_set_layout) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create the depth pyramid descriptor set layout!"};
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, vk_depth_pyramid_set_layout, "Depth pyramid set layout");
+
+        VkPushConstantRange push_constant_range{};
+
+        push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        push_constant_range.offset     = 0;
+        push_constant_range.size       = sizeof(DepthPyramidPushConstants);
+
+        VkPipelineLayoutCreateInfo pipeline_layout_info{};
+
+        pipeline_layout_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_info.setLayoutCount         = 1;
+        pipeline_layout_info.pSetLayouts            = &vk_depth_pyramid_set_layout;
+        pipeline_layout_info.pushConstantRangeCount = 1;
+        pipeline_layout_info.pPushConstantRanges    = &push_constant_range;
+
+        if (vkCreatePipelineLayout(vk_logical_device, &pipeline_layout_info, vk_allocator, &vk_depth_pyramid_pipeline_layout) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create the depth pyramid Pipeline Layout!"};
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_PIPELINE_LAYOUT, vk_depth_pyramid_pipeline_layout, "Depth pyramid pipeline layout");
+
+        vk_depth_pyramid_pipeline = buildComputePipeline(vk_depth_pyramid_pipeline_layout, "res/depth_pyramid_comp.spv");
+    }
+
+    void destroyDepthPyramidPipeline() {
+        vkDestroyPipeline(vk_logical_device, vk_depth_pyramid_pipeline, vk_allocator);
+        vkDestroyPipelineLayout(vk_logical_device, vk_depth_pyramid_pipeline_layout, vk_allocator);
+        vkDestroyDescriptorSetLayout(vk_logical_device, vk_depth_pyramid_set_layout, vk_allocator);
+    }
+
+    // Sized after the depth buffer, so it is recreated with the swapchain
+    void createDepthPyramidResources() {
+        depth_pyramid = VulkanUtilities::createDepthPyramid(vk_logical_device, vk_physical_device, vk_command_pool, vk_graphics_queue, vk_swapchain_extent);
+
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_IMAGE,      depth_pyramid.Image,   "Depth pyramid");
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_IMAGE_VIEW, depth_pyramid.View,    "Depth pyramid view");
+        VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_SAMPLER,    depth_pyramid.Sampler, "Depth pyramid sampler");
+
+        for (uint32_t level = 0; level < depth_pyramid.MipLevels; level++)
+            VulkanUtilities::setObjectName(vk_logical_device, VK_OBJECT_TYPE_IMAGE_VIEW, depth_pyramid.MipViews[level], "Depth pyramid level", level);
+
+        depth_pyramid_descriptor_allocator = VulkanUtilities::createDescriptorAllocator(depth_pyramid.MipLevels, {
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          1.0f }
+        });
+
+        vk_depth_pyramid_descriptor_sets.resize(depth_pyramid.MipLevels);
+
+        for (uint32_t level = 0; level < depth_pyramid.MipLevels; level++) {
+            vk_depth_pyramid_descriptor_sets[level] = VulkanUtilities::allocateDescriptorSet(vk_logical_device, depth_pyramid_descriptor_allocator, vk_depth_pyramid_set_layout);
+
+            const VkDescriptorImageInfo source_info = level == 0
+                ? VkDescriptorImageInfo{ depth_pyramid.Sampler, vk_depth_sampled_view,               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL }
+                : VkDescriptorImageInfo{ depth_pyramid.Sampler, depth_pyramid.MipViews[level - 1], VK_IMAGE_LAYOUT_GENERAL };
+
+            const VkDescriptorImageInfo destination_info{ VK_NULL_HANDLE, depth_pyramid.MipViews[level], VK_IMAGE_LAYOUT_GENERAL };
+
+            std::array<VkWriteDescriptorSet, 2> descriptor_writes{};
+
+            descriptor_writes[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_writes[0].dstSet          = vk_depth_pyramid_descriptor_sets[level];
+            descriptor_writes[0].dstBinding      = 0;
+            descriptor_writes[0].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            descriptor_writes[0].descriptorCount = 1;
+            descriptor_writes[0].pImageInfo      = &source_info;
+
+            descriptor_writes[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_writes[1].dstSet          = vk_depth_pyramid_descriptor_sets[level];
+            descriptor_writes[1].dstBinding      = 1;
+            descriptor_writes[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            descriptor_writes[1].descriptorCount = 1;
+            descriptor_writes[1].pImageInfo      = &destination_info;
+
+            vkUpdateDescriptorSets(vk_logical_device, static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data(), 0, nullptr);
+        }
+    }
+
+    void destroyDepthPyramidResources() {
+        VulkanUtilities::destroyDescriptorAllocator(vk_logical_device, depth_pyramid_descriptor_allocator);
+        VulkanUtilities::destroyDepthPyramid(vk_logical_device, depth_pyramid);
+
+        vk_depth_pyramid_descriptor_sets.clear();
+    }
+
+    // Binding 4 of the culling sets, again every time the pyramid gets recreated
+    void writeCullingPyramidDescriptors() {
+        const VkDescriptorImageInfo pyramid_info{ depth_pyramid.Sampler, depth_pyramid.View, VK_IMAGE_LAYOUT_GENERAL };
+
+        for (const auto set : vk_culling_descriptor_sets) {
+            VkWriteDescriptorSet descriptor_write{};
+
+            descriptor_write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_write.dstSet          = set;
+            descriptor_write.dstBinding      = 4;
+            descriptor_write.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            descriptor_write.descriptorCount = 1;
+            descriptor_write.pImageInfo      = &pyramid_info;
+
+            vkUpdateDescriptorSets(vk_logical_device, 1, &descriptor_write, 0, nullptr);
+        }
+    }
+
+    // Recorded between the early and the late render pass, the depth buffer goes to shader read for the reduction and comes back afterwards
+    void recordDepthPyramid(const VkCommandBuffer buffer) {
+        const VulkanUtilities::DebugLabelScope label{ buffer, "Depth pyramid" };
+
+        VkImageMemoryBarrier depth_barrier{};
+
+        depth_barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        depth_barrier.srcAccessMask                   = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        depth_barrier.dstAccessMask                   = VK_ACCESS_SHADER_READ_BIT;
+        depth_barrier.oldLayout                       = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        depth_barrier.newLayout                       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        depth_barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        depth_barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        depth_barrier.image                           = vk_depth_image;
+        depth_barrier.subresourceRange.aspectMask     = VulkanUtilities::getDepthAspectFlags(vk_depth_format);
+        depth_barrier.subresourceRange.baseMipLevel   = 0;
+        depth_barrier.subresourceRange.levelCount     = 1;
+        depth_barrier.subresourceRange.baseArrayLayer = 0;
+        depth_barrier.subresourceRange.layerCount     = 1;
+
+        vkCmdPipelineBarrier(buffer, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &depth_barrier);
+
+        vkCmdBindPipeline(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, vk_depth_pyramid_pipeline);
+
+        // Each level reads the one written right before it
+        VkMemoryBarrier level_barrier{};
+
+        level_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        level_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        level_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        glm::ivec2 source_size{ static_cast<int>(vk_swapchain_extent.width), static_cast<int>(vk_swapchain_extent.height) };
+
+        for (uint32_t level = 0; level < depth_pyramid.MipLevels; level++) {
+            const glm::ivec2 destination_size{ std::max(static_cast<int>(depth_pyramid.Width) >> level, 1), std::max(static_cast<int>(depth_pyramid.Height) >> level, 1) };
+
+            const DepthPyramidPushConstants push_constants{ source_size, destination_size };
+
+            vkCmdBindDescriptorSets(buffer, VK_PIPELINE_BIND_POINT_COMPUTE, vk_depth_pyramid_pipeline_layout, 0, 1, &vk_depth_pyramid_descriptor_sets[level], 0, nullptr);
+            vkCmdPushConstants(buffer, vk_depth_pyramid_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(DepthPyramidPushConstants), &push_constants);
+
+            vkCmdDispatch(buffer,
+                (destination_size.x + DEPTH_PYRAMID_WORKGROUP_SIZE - 1) / DEPTH_PYRAMID_WORKGROUP_SIZE,
+                (destination_size.y + DEPTH_PYRAMID_WORKGROUP_SIZE - 1) / DEPTH_PYRAMID_WORKGROUP_SIZE, 1);
+
+            vkCmdPipelineBarrier(buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &level_barrier, 0, nullptr, 0, nullptr);
+
+            source_size = destination_size;
+        }
+
+        // Back to a depth attachment for the late pass
+        depth_barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        depth_barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        depth_barrier.oldLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        depth_barrier.newLayout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        vkCmdPipelineBarrier(buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, 0, 0, nullptr, 0, nullptr, 1, &depth_barrier);
+    }
+
+    void recordOcclusionCulledFrame(const VkCommandBuffer buffer, const uint32_t image_index) {
+        recordCullingPass(buffer, CullingPhase::Early);
+
+        {
+            const VulkanUtilities::DebugLabelScope label{ buffer, "Scene (early)" };
+
+            beginSceneRenderPass(buffer, vk_early_render_pass, image_index, vk_gpu_driven_pipeline);
+            recordGpuDrivenDraws(buffer, CullingPhase::Early);
+            vkCmdEndRenderPass(buffer);
+        }
+
+        recordDepthPyramid(buffer);
+
+        recordCullingPass(buffer, CullingPhase::Late);
+
+        {
+            const VulkanUtilities::DebugLabelScope label{ buffer, "Scene (late)" };
+
+            beginSceneRenderPass(buffer, vk_late_render_pass, image_index, vk_gpu_driven_pipeline);
+            recordGpuDrivenDraws(buffer, CullingPhase::Late);
+            vkCmdEndRenderPass(buffer);
+        }
+
+        recordDrawCountReadback(buffer);
+    }
+}
@@ -0,0 +1,431 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace MeshUtilities {
+    static constexpr uint32_t INVALID_VERTEX = ~0u;
+
+    // remap[old] = new (or INVALID_VERTEX to drop the vertex)
+    template <typename Attribute>
+    static void remapStream(std::vector<Attribute>& stream, const std::vector<uint32_t>& remap, const uint32_t new_vertex_count) {
+        if (stream.empty())
+            return;
+
+        std::vector<Attribute> remapped(new_vertex_count);
+
+        for (size_t i = 0; i < remap.size(); i++)
+            if (remap[i] != INVALID_VERTEX)
+                remapped[remap[i]] = stream[i];
+
+        stream = std::move(remapped);
+    }
+
+    static void remapMesh(Mesh& mesh, const std::vector<uint32_t>& remap, const uint32_t new_vertex_count) {
+        remapStream(mesh.Positions, remap, new_vertex_count);
+        remapStream(mesh.Normals,   remap, new_vertex_count);
+        remapStream(mesh.UVs,       remap, new_vertex_count);
+        remapStream(mesh.Colors,    remap, new_vertex_count);
+
+        for (auto& index : mesh.Indices)
+            index = remap[index];
+    }
+
+    // Everything below indexes per-vertex arrays with the raw indices
+    static void checkIndices(const std::span<const uint32_t> indices, const uint32_t vertex_count) {
+        const auto out_of_range = std::ranges::find_if(indices, [vertex_count](const uint32_t index) { return index >= vertex_count; });
+
+        if (out_of_range != indices.end())
+            throw std::runtime_error{"Index " + std::to_string(*out_of_range) + " is past the end of the mesh (" + std::to_string(vertex_count) + " vertices)!"};
+    }
+
+    VertexCacheStatistics analyzeVertexCache(const std::span<const uint32_t> indices, const uint32_t vertex_count, const uint32_t cache_size) {
+        checkIndices(indices, vertex_count);
+
+        VertexCacheStatistics statistics{};
+
+        // A vertex is in the cache when fewer than cache_size misses happened since it was loaded (that's all a FIFO is)
+        std::vector<uint32_t> loaded_at(vertex_count, 0);
+        std::vector<bool>     referenced(vertex_count, false);
+
+        uint32_t time = cache_size + 1;
+
+        for (const uint32_t index : indices) {
+            if (time - loaded_at[index] > cache_size) {
+                loaded_at[index] = time++;
+                statistics.Misses++;
+            }
+
+            if (!referenced[index]) {
+                referenced[index] = true;
+                statistics.Vertices++;
+            }
+        }
+
+        statistics.Triangles = static_cast<uint32_t>(indices.size() / 3);
+        statistics.ACMR      = statistics.Triangles == 0 ? 0.0f : static_cast<float>(statistics.Misses) / static_cast<float>(statistics.Triangles);
+        statistics.ATVR      = statistics.Vertices  == 0 ? 0.0f : static_cast<float>(statistics.Misses) / static_cast<float>(statistics.Vertices);
+
+        return statistics;
+    }
+
+    VertexFetchStatistics analyzeVertexFetch(
+        const std::span<const uint32_t> indices,
+        const uint32_t                  vertex_count,
+        const uint32_t                  vertex_stride,
+        const uint32_t                  fetch_size,
+        const uint32_t                  cache_size,
+        const uint32_t                  line_size,
+        const uint32_t                  line_count
+    ) {
+        if (fetch_size == 0 || fetch_size > vertex_stride)
+            throw std::runtime_error{"Vertex fetch size has to be between 1 and the vertex stride!"};
+
+        checkIndices(indices, vertex_count);
+
+        VertexFetchStatistics statistics{};
+
+        // Same FIFO trick as analyzeVertexCache(), once for transformed vertices and once for lines
+        const uint64_t total_lines = (static_cast<uint64_t>(vertex_count) * vertex_stride + line_size - 1) / line_size;
+
+        std::vector<uint32_t> vertex_loaded_at(vertex_count, 0);
+        std::vector<uint32_t> line_loaded_at(total_lines, 0);
+        std::vector<bool>     referenced(vertex_count, false);
+
+        uint32_t vertex_time = cache_size + 1;
+        uint32_t line_time   = line_count + 1;
+
+        for (const uint32_t index : indices) {
+            if (!referenced[index]) {
+                referenced[index] = true;
+                statistics.Vertices++;
+            }
+
+            if (vertex_time - vertex_loaded_at[index] <= cache_size)
+                continue;
+
+            vertex_loaded_at[index] = vertex_time++;
+
+            const uint64_t first_byte = static_cast<uint64_t>(index) * vertex_stride;
+
+            for (uint64_t line = first_byte / line_size; line <= (first_byte + fetch_size - 1) / line_size; line++) {
+                if (line_time - line_loaded_at[line] > line_count) {
+                    line_loaded_at[line] = line_time++;
+                    statistics.BytesFetched += line_size;
+                }
+            }
+        }
+
+        const uint64_t needed = static_cast<uint64_t>(statistics.Vertices) * fetch_size;
+        statistics.Overfetch  = needed == 0 ? 0.0f : static_cast<float>(statistics.BytesFetched) / static_cast<float>(needed);
+
+        return statistics;
+    }
+
+    uint32_t deduplicateVertices(Mesh& mesh) {
+        const uint32_t vertex_count = mesh.vertexCount();
+
+        checkIndices(mesh.Indices, vertex_count);
+
+        if (mesh.Indices.empty()) {
+            mesh.Indices.resize(vertex_count);
+            std::iota(mesh.Indices.begin(), mesh.Indices.end(), 0u);
+        }
+
+        // Hashes/compares the raw bytes of every stream the mesh has, so -0.0 and 0.0 stay different (which is what we want here)
+        const auto vertexBytes = [&](const uint32_t vertex, auto&& function) {
+            if (!mesh.Positions.empty()) function(&mesh.Positions[vertex], sizeof(glm::vec3));
+            if (!mesh.Normals.empty())   function(&mesh.Normals[vertex],   sizeof(glm::vec3));
+            if (!mesh.UVs.empty())       function(&mesh.UVs[vertex],       sizeof(glm::vec2));
+            if (!mesh.Colors.empty())    function(&mesh.Colors[vertex],    sizeof(glm::vec4));
+        };
+
+        const auto hash = [&](const uint32_t vertex) {
+            size_t value = 14695981039346656037ull;
+
+            vertexBytes(vertex, [&](const void* data, const size_t size) {
+                const auto* bytes = static_cast<const unsigned char*>(data);
+
+                for (size_t i = 0; i < size; i++)
+                    value = (value ^ bytes[i]) * 1099511628211ull;
+            });
+
+            return value;
+        };
+
+        const auto equal = [&](const uint32_t left, const uint32_t right) {
+            bool same = true;
+
+            if (!mesh.Positions.empty()) same = same && memcmp(&mesh.Positions[left], &mesh.Positions[right], sizeof(glm::vec3)) == 0;
+            if (!mesh.Normals.empty())   same = same && memcmp(&mesh.Normals[left],   &mesh.Normals[right],   sizeof(glm::vec3)) == 0;
+            if (!mesh.UVs.empty())       same = same && memcmp(&mesh.UVs[left],       &mesh.UVs[right],       sizeof(glm::vec2)) == 0;
+            if (!mesh.Colors.empty())    same = same && memcmp(&mesh.Colors[left],    &mesh.Colors[right],    sizeof(glm::vec4)) == 0;
+
+            return same;
+        };
+
+        std::unordered_map<uint32_t, uint32_t, decltype(hash), decltype(equal)> unique_vertices{ vertex_count, hash, equal };
+
+        std::vector<uint32_t> remap(vertex_count, INVALID_VERTEX);
+        uint32_t              unique_count = 0;
+
+        // Only vertices the index buffer actually uses survive
+        for (const uint32_t index : mesh.Indices) {
+            if (remap[index] != INVALID_VERTEX)
+                continue;
+
+            const auto [iterator, inserted] = unique_vertices.try_emplace(index, unique_count);
+            if (inserted)
+                unique_count++;
+
+            remap[index] = iterator->second;
+        }
+
+        remapMesh(mesh, remap, unique_count);
+
+        return unique_count;
+    }
+
+    void optimizeVertexCache(std::vector<uint32_t>& indices, const uint32_t vertex_count, const uint32_t cache_size) {
+        checkIndices(indices, vertex_count);
+
+        const size_t triangle_count = indices.size() / 3;
+
+        if (triangle_count == 0)
+            return;
+
+        // Vertex -> triangle adjacency, flattened (offsets[v] .. offsets[v + 1] into adjacent_triangles)
+        std::vector<uint32_t> live_triangles(vertex_count, 0);
+        for (const uint32_t index : indices)
+            live_triangles[index]++;
+
+        std::vector<uint32_t> offsets(vertex_count + 1, 0);
+        for (uint32_t vertex = 0; vertex < vertex_count; vertex++)
+            offsets[vertex + 1] = offsets[vertex] + live_triangles[vertex];
+
+        std::vector<uint32_t> adjacent_triangles(indices.size());
+        std::vector<uint32_t> fill_positions(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++)
+            adjacent_triangles[fill_positions[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+        std::vector<uint32_t> loaded_at(vertex_count, 0);
+        std::vector<bool>     emitted(triangle_count, false);
+        std::vector<uint32_t> dead_end_stack;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> result;
+
+        result.reserve(indices.size());
+
+        uint32_t time         = cache_size + 1;
+        uint32_t scan_cursor  = 0; // Next vertex to try when the dead-end stack runs dry as well
+        uint32_t fan_vertex   = indices[0];
+
+        while (fan_vertex != INVALID_VERTEX) {
+            candidates.clear();
+
+            // Emit every triangle around the fanning vertex that hasn't been emitted yet
+            for (uint32_t i = offsets[fan_vertex]; i < offsets[fan_vertex + 1]; i++) {
+                const uint32_t triangle = adjacent_triangles[i];
+
+                if (emitted[triangle])
+                    continue;
+
+                emitted[triangle] = true;
+
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    const uint32_t vertex = indices[triangle * 3 + corner];
+
+                    result.push_back(vertex);
+                    dead_end_stack.push_back(vertex);
+                    candidates.push_back(vertex);
+
+                    live_triangles[vertex]--;
+
+                    if (time - loaded_at[vertex] > cache_size)
+                        loaded_at[vertex] = time++;
+                }
+            }
+
+            // Next fanning vertex: the candidate that will still be in the cache after its remaining triangles are emitted, and the oldest of those
+            //  . Vertices whose triangles would push them out anyway aren't worth it (priority 0)
+            fan_vertex = INVALID_VERTEX;
+
+            int32_t best_priority = -1;
+            for (const uint32_t vertex : candidates) {
+                if (live_triangles[vertex] == 0)
+                    continue;
+
+                int32_t priority = 0;
+                if (time - loaded_at[vertex] + 2 * live_triangles[vertex] <= cache_size)
+                    priority = static_cast<int32_t>(time - loaded_at[vertex]);
+
+                if (priority > best_priority) {
+                    best_priority = priority;
+                    fan_vertex    = vertex;
+                }
+            }
+
+            if (fan_vertex != INVALID_VERTEX)
+                continue;
+
+            // Dead end, go back through the recently used vertices first and only then scan for anything that's left
+            while (!dead_end_stack.empty() && fan_vertex == INVALID_VERTEX) {
+                const uint32_t vertex = dead_end_stack.back();
+                dead_end_stack.pop_back();
+
+                if (live_triangles[vertex] > 0)
+                    fan_vertex = vertex;
+            }
+
+            for (; scan_cursor < vertex_count && fan_vertex == INVALID_VERTEX; scan_cursor++)
+                if (live_triangles[scan_cursor] > 0)
+                    fan_vertex = scan_cursor;
+        }
+
+        indices = std::move(result);
+    }
+
+    void optimizeOverdraw(std::vector<uint32_t>& indices, const std::span<const glm::vec3> positions, const uint32_t cache_size, const float threshold) {
+        const size_t   triangle_count = indices.size() / 3;
+        const uint32_t vertex_count   = static_cast<uint32_t>(positions.size());
+
+        if (triangle_count == 0)
+            return;
+
+        // Cluster boundaries: start a new cluster (with a cold cache) once the current one has paid off its own cold start
+        const float target_acmr = analyzeVertexCache(indices, vertex_count, cache_size).ACMR * threshold;
+
+        std::vector<uint32_t> cluster_starts{ 0 };
+        std::vector<uint32_t> loaded_at(vertex_count, 0);
+
+        uint32_t time              = cache_size + 1;
+        uint32_t cluster_misses    = 0;
+        uint32_t cluster_triangles = 0;
+
+        for (uint32_t triangle = 0; triangle < triangle_count; triangle++) {
+            if (cluster_triangles > 0 && static_cast<float>(cluster_misses) <= target_acmr * static_cast<float>(cluster_triangles)) {
+                cluster_starts.push_back(triangle);
+
+                time              += cache_size + 1;
+                cluster_misses     = 0;
+                cluster_triangles  = 0;
+            }
+
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                const uint32_t vertex = indices[triangle * 3 + corner];
+
+                if (time - loaded_at[vertex] > cache_size) {
+                    loaded_at[vertex] = time++;
+                    cluster_misses++;
+                }
+            }
+
+            cluster_triangles++;
+        }
+
+        cluster_starts.push_back(static_cast<uint32_t>(triangle_count));
+
+        // Area weighted centroid and normal per cluster
+        struct Cluster {
+            uint32_t  Start;
+            uint32_t  End;
+            glm::vec3 Centroid;
+            glm::vec3 Normal;
+            float     SortKey;
+        };
+
+        std::vector<Cluster> clusters(cluster_starts.size() - 1);
+
+        glm::vec3 mesh_centroid{ 0.0f };
+        float     mesh_area = 0.0f;
+
+        for (size_t i = 0; i < clusters.size(); i++) {
+            Cluster& cluster = clusters[i];
+
+            cluster = { cluster_starts[i], cluster_starts[i + 1], glm::vec3{ 0.0f }, glm::vec3{ 0.0f }, 0.0f };
+
+            float cluster_area = 0.0f;
+
+            for (uint32_t triangle = cluster.Start; triangle < cluster.End; triangle++) {
+                const glm::vec3 a = positions[indices[triangle * 3 + 0]];
+                const glm::vec3 b = positions[indices[triangle * 3 + 1]];
+                const glm::vec3 c = positions[indices[triangle * 3 + 2]];
+
+                const glm::vec3 normal = glm::cross(b - a, c - a);
+                const float     area   = glm::length(normal);
+
+                cluster.Centroid = cluster.Centroid + (a + b + c) * (area / 3.0f);
+                cluster.Normal   = cluster.Normal + normal;
+                cluster_area    += area;
+            }
+
+            mesh_centroid = mesh_centroid + cluster.Centroid;
+            mesh_area    += cluster_area;
+
+            if (cluster_area > 0.0f)
+                cluster.Centroid = cluster.Centroid / cluster_area;
+        }
+
+        if (mesh_area > 0.0f)
+            mesh_centroid = mesh_centroid / mesh_area;
+
+        // Clusters on the outside facing away from the center are the likely occluders, so they go first
+        for (auto& cluster : clusters) {
+            const float normal_length = glm::length(cluster.Normal);
+
+            cluster.SortKey = normal_length > 0.0f ? glm::dot(cluster.Centroid - mesh_centroid, cluster.Normal / normal_length) : 0.0f;
+        }
+
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& left, const Cluster& right) { return left.SortKey > right.SortKey; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+
+        for (const auto& cluster : clusters)
+            result.insert(result.end(), indices.begin() + cluster.Start * 3, indices.begin() + cluster.End * 3);
+
+        indices = std::move(result);
+    }
+
+    uint32_t optimizeVertexFetch(Mesh& mesh) {
+        checkIndices(mesh.Indices, mesh.vertexCount());
+
+        std::vector<uint32_t> remap(mesh.vertexCount(), INVALID_VERTEX);
+        uint32_t              next_vertex = 0;
+
+        for (const uint32_t index : mesh.Indices)
+            if (remap[index] == INVALID_VERTEX)
+                remap[index] = next_vertex++;
+
+        remapMesh(mesh, remap, next_vertex);
+
+        return next_vertex;
+    }
+
+    MeshOptimizationReport optimizeMesh(Mesh& mesh, const uint32_t cache_size) {
+        if (mesh.Positions.empty())
+            throw std::runtime_error{"Can't optimize a mesh without positions!"};
+
+        MeshOptimizationReport report{};
+
+        report.VerticesBefore = mesh.vertexCount();
+        report.Before         = mesh.Indices.empty()
+            ? VertexCacheStatistics{ report.VerticesBefore, report.VerticesBefore / 3, report.VerticesBefore, 3.0f, 1.0f }
+            : analyzeVertexCache(mesh.Indices, report.VerticesBefore, cache_size);
+
+        // Dedup first (cache optimization is pointless on split vertices), fetch last (it follows the final index order)
+        const uint32_t unique_vertices = deduplicateVertices(mesh);
+
+        optimizeVertexCache(mesh.Indices, unique_vertices, cache_size);
+        optimizeOverdraw(mesh.Indices, mesh.Positions, cache_size);
+
+        report.VerticesAfter = optimizeVertexFetch(mesh);
+        report.After         = analyzeVertexCache(mesh.Indices, report.VerticesAfter, cache_size);
+
+        return report;
+    }
+}
@@ -0,0 +1,47 @@
+#include "MeshUtils.hpp"
+
+#include <cmath>
+
+namespace MeshUtilities {
+    uint32_t Mesh::vertexCount() const   { return static_cast<uint32_t>(Positions.size()); }
+    uint32_t Mesh::triangleCount() const { return static_cast<uint32_t>(Indices.size() / 3); }
+
+    Mesh createGridMesh(const uint32_t columns, const uint32_t rows) {
+        Mesh mesh{};
+
+        const size_t vertex_count = static_cast<size_t>(columns + 1) * (rows + 1);
+
+        mesh.Positions.reserve(vertex_count);
+        mesh.Normals.reserve(vertex_count);
+        mesh.UVs.reserve(vertex_count);
+        mesh.Colors.reserve(vertex_count);
+        mesh.Indices.reserve(static_cast<size_t>(columns) * rows * 6);
+
+        // Height is sin(x) * cos(z), so the normal falls straight out of the partial derivatives
+        for (uint32_t row = 0; row <= rows; row++) {
+            for (uint32_t column = 0; column <= columns; column++) {
+                const float u = static_cast<float>(column) / static_cast<float>(columns);
+                const float v = static_cast<float>(row)    / static_cast<float>(rows);
+
+                const float x = (u - 0.5f) * 20.0f;
+                const float z = (v - 0.5f) * 20.0f;
+
+                mesh.Positions.emplace_back(x, std::sin(x) * std::cos(z), z);
+                mesh.Normals.push_back(glm::normalize(glm::vec3{ -std::cos(x) * std::cos(z), 1.0f, std::sin(x) * std::sin(z) }));
+                mesh.UVs.emplace_back(u, v);
+                mesh.Colors.emplace_back(u, v, 1.0f - u * v, 1.0f);
+            }
+        }
+
+        for (uint32_t row = 0; row < rows; row++) {
+            for (uint32_t column = 0; column < columns; column++) {
+                const uint32_t top_left    = row * (columns + 1) + column;
+                const uint32_t bottom_left = top_left + columns + 1;
+
+                mesh.Indices.insert(mesh.Indices.end(), { top_left, bottom_left, top_left + 1, top_left + 1, bottom_left, bottom_left + 1 });
+            }
+        }
+
+        return mesh;
+    }
+}
@@ -0,0 +1,84 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace Rendering {
+    static constexpr uint64_t fieldMask(const uint32_t bits) { return (uint64_t{1} << bits) - 1; }
+
+    uint64_t makeSortKey(const uint32_t pass, const uint32_t pipeline, const uint32_t material, const float depth, const DepthOrder order) {
+        // NaN fails the comparison too, so it ends up as 0 along with the negatives
+        uint32_t depth_bits = std::bit_cast<uint32_t>(depth > 0.0f ? depth : 0.0f);
+
+        if (order == DepthOrder::BackToFront)
+            depth_bits = ~depth_bits;
+
+        return (static_cast<uint64_t>(pass)     & fieldMask(SORT_KEY_PASS_BITS))     << SORT_KEY_PASS_SHIFT
+             | (static_cast<uint64_t>(pipeline) & fieldMask(SORT_KEY_PIPELINE_BITS)) << SORT_KEY_PIPELINE_SHIFT
+             | (static_cast<uint64_t>(material) & fieldMask(SORT_KEY_MATERIAL_BITS)) << SORT_KEY_MATERIAL_SHIFT
+             | static_cast<uint64_t>(depth_bits) << SORT_KEY_DEPTH_SHIFT;
+    }
+
+    uint32_t getSortKeyPass(const uint64_t key)     { return static_cast<uint32_t>((key >> SORT_KEY_PASS_SHIFT)     & fieldMask(SORT_KEY_PASS_BITS)); }
+    uint32_t getSortKeyPipeline(const uint64_t key) { return static_cast<uint32_t>((key >> SORT_KEY_PIPELINE_SHIFT) & fieldMask(SORT_KEY_PIPELINE_BITS)); }
+    uint32_t getSortKeyMaterial(const uint64_t key) { return static_cast<uint32_t>((key >> SORT_KEY_MATERIAL_SHIFT) & fieldMask(SORT_KEY_MATERIAL_BITS)); }
+
+    void resetRenderQueue(RenderQueue& queue) {
+        queue.Items.clear();
+    }
+
+    void submitDraw(RenderQueue& queue, const uint64_t key, const uint32_t object) {
+        queue.Items.push_back({ key, object });
+    }
+
+    void sortRenderQueue(RenderQueue& queue) {
+        auto& items   = queue.Items;
+        auto& scratch = queue.Scratch;
+
+        if (items.size() < 2)
+            return;
+
+        scratch.resize(items.size());
+
+        // All eight histograms in one read over the keys
+        std::array<std::array<uint32_t, 256>, 8> histograms{};
+
+        for (const DrawItem& item : items)
+            for (uint32_t pass = 0; pass < 8; pass++)
+                histograms[pass][(item.Key >> (pass * 8)) & 0xFF]++;
+
+        for (uint32_t pass = 0; pass < 8; pass++) {
+            auto& histogram = histograms[pass];
+
+            // Every key has the same byte here (the pass bits mostly, or a scene with one pipeline), nothing would move
+            if (std::ranges::find(histogram, static_cast<uint32_t>(items.size())) != histogram.end())
+                continue;
+
+            // Counts -> starting offsets
+            uint32_t offset = 0;
+            for (uint32_t& count : histogram) {
+                const uint32_t bucket = count;
+                count   = offset;
+                offset += bucket;
+            }
+
+            for (const DrawItem& item : items)
+                scratch[histogram[(item.Key >> (pass * 8)) & 0xFF]++] = item;
+
+            items.swap(scratch);
+        }
+    }
+
+    bool bindIfChanged(BoundState& state, uint32_t& bound, const uint32_t value) {
+        if (bound == value) {
+            state.Statistics.Skipped++;
+            return false;
+        }
+
+        bound = value;
+        state.Statistics.Issued++;
+
+        return true;
+    }
+}
@@ -0,0 +1,176 @@
+#include "TaskGraph.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "Benchmark.hpp"
+
+namespace StandardUtilities {
+    uint32_t addTask(TaskGraph& graph, std::string name, std::vector<uint32_t> dependencies, std::function<void()> job, const bool main_thread) {
+        const auto id = static_cast<uint32_t>(graph.Tasks.size());
+
+        for (const uint32_t dependency : dependencies)
+            if (dependency >= id)
+                throw std::runtime_error{"Task " + name + " depends on a task that wasn't added before it!"};
+
+        graph.Tasks.push_back({ std::move(name), std::move(job), std::move(dependencies), main_thread });
+
+        return id;
+    }
+
+    static std::vector<TaskTiming> runTaskGraphSerially(const TaskGraph& graph) {
+        const Benchmark::Stopwatch stopwatch{};
+
+        std::vector<TaskTiming> timings;
+        timings.reserve(graph.Tasks.size());
+
+        for (const auto& task : graph.Tasks) {
+            const double start = stopwatch.elapsedMilliseconds();
+
+            task.Job();
+
+            timings.push_back({ task.Name, start, stopwatch.elapsedMilliseconds(), 0 });
+        }
+
+        return timings;
+    }
+
+    // Everything a run shares between the calling thread and the workers, guarded by Mutex
+    struct TaskGraphRun {
+        TaskGraphRun(const TaskGraph& graph, ThreadPool& workers) : Graph{ graph }, Workers{ workers } {}
+
+        const TaskGraph&           Graph;
+        ThreadPool&                Workers;
+        const Benchmark::Stopwatch Stopwatch{};
+
+        std::vector<uint32_t>              Remaining;  // Unfinished dependencies per task
+        std::vector<std::vector<uint32_t>> Dependents;
+        std::deque<uint32_t>               MainThreadReady;
+        uint32_t                           Running = 0; // Launched but not finished yet, the run is over once this hits 0
+
+        std::vector<TaskTiming>      Timings;
+        std::vector<std::thread::id> Threads;
+        std::exception_ptr           Error;
+
+        std::mutex              Mutex;
+        std::condition_variable Progress;
+    };
+
+    static void launchTask(TaskGraphRun& run, uint32_t task);
+
+    static uint32_t getThreadIndex(TaskGraphRun& run) {
+        const auto id = std::this_thread::get_id();
+
+        for (uint32_t i = 0; i < run.Threads.size(); i++)
+            if (run.Threads[i] == id)
+                return i;
+
+        run.Threads.push_back(id);
+
+        return static_cast<uint32_t>(run.Threads.size() - 1);
+    }
+
+    static void executeTask(TaskGraphRun& run, const uint32_t task) {
+        const double start = run.Stopwatch.elapsedMilliseconds();
+
+        std::exception_ptr error;
+
+        try {
+            run.Graph.Tasks[task].Job();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        const double end = run.Stopwatch.elapsedMilliseconds();
+
+        std::vector<uint32_t> ready;
+
+        {
+            const std::lock_guard lock{ run.Mutex };
+
+            run.Timings.push_back({ run.Graph.Tasks[task].Name, start, end, getThreadIndex(run) });
+
+            if (error && !run.Error)
+                run.Error = error;
+
+            if (!run.Error)
+                for (const uint32_t dependent : run.Dependents[task])
+                    if (--run.Remaining[dependent] == 0)
+                        ready.push_back(dependent);
+
+            // Counted as running before this one stops being, so Running can't touch 0 in between
+            for (const uint32_t next : ready)
+                launchTask(run, next);
+
+            run.Running--;
+
+            // Still under the lock, the caller owns run and may return (destroying it) as soon as it sees Running hit 0
+            run.Progress.notify_all();
+        }
+    }
+
+    // Called with the lock held, the pool has its own lock so submitting under ours is fine
+    static void launchTask(TaskGraphRun& run, const uint32_t task) {
+        run.Running++;
+
+        if (run.Graph.Tasks[task].MainThread)
+            run.MainThreadReady.push_back(task);
+        else
+            run.Workers.submit([&run, task] { executeTask(run, task); });
+    }
+
+    std::vector<TaskTiming> runTaskGraph(const TaskGraph& graph, ThreadPool* workers) {
+        if (!workers)
+            return runTaskGraphSerially(graph);
+
+        TaskGraphRun run{ graph, *workers };
+
+        run.Remaining.resize(graph.Tasks.size());
+        run.Dependents.resize(graph.Tasks.size());
+        run.Timings.reserve(graph.Tasks.size());
+        run.Threads.push_back(std::this_thread::get_id());
+
+        for (uint32_t task = 0; task < graph.Tasks.size(); task++) {
+            run.Remaining[task] = static_cast<uint32_t>(graph.Tasks[task].Dependencies.size());
+
+            for (const uint32_t dependency : graph.Tasks[task].Dependencies)
+                run.Dependents[dependency].push_back(task);
+        }
+
+        std::unique_lock lock{ run.Mutex };
+
+        for (uint32_t task = 0; task < graph.Tasks.size(); task++)
+            if (run.Remaining[task] == 0)
+                launchTask(run, task);
+
+        // The calling thread runs the main thread tasks until nothing is left running anywhere
+        while (true) {
+            run.Progress.wait(lock, [&run] { return !run.MainThreadReady.empty() || run.Running == 0; });
+
+            if (run.MainThreadReady.empty())
+                break;
+
+            const uint32_t task = run.MainThreadReady.front();
+            run.MainThreadReady.pop_front();
+
+            // Something already failed, it was only queued before that
+            if (run.Error) {
+                run.Running--;
+                continue;
+            }
+
+            lock.unlock();
+            executeTask(run, task);
+            lock.lock();
+        }
+
+        if (run.Error)
+            std::rethrow_exception(run.Error);
+
+        return std::move(run.Timings);
+    }
+}
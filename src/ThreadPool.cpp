@@ -0,0 +1,72 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace StandardUtilities {
+    ThreadPool::ThreadPool(const uint32_t thread_count) {
+        workers.reserve(thread_count);
+
+        for (uint32_t i = 0; i < thread_count; i++)
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+    // Whatever is still queued gets run first, nothing is dropped
+    ThreadPool::~ThreadPool() {
+        {
+            const std::lock_guard lock{ mutex };
+            stopping = true;
+        }
+
+        job_available.notify_all();
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    void ThreadPool::submit(std::function<void()> job) {
+        {
+            const std::lock_guard lock{ mutex };
+            jobs.push_back(std::move(job));
+        }
+
+        job_available.notify_one();
+    }
+
+    void ThreadPool::waitIdle() {
+        std::unique_lock lock{ mutex };
+        idle.wait(lock, [this] { return jobs.empty() && busy_workers == 0; });
+    }
+
+    uint32_t ThreadPool::threadCount() const {
+        return static_cast<uint32_t>(workers.size());
+    }
+
+    uint32_t ThreadPool::defaultThreadCount() {
+        return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    void ThreadPool::workerLoop() {
+        std::unique_lock lock{ mutex };
+
+        while (true) {
+            job_available.wait(lock, [this] { return stopping || !jobs.empty(); });
+
+            if (jobs.empty())
+                return;
+
+            std::function<void()> job = std::move(jobs.front());
+            jobs.pop_front();
+
+            busy_workers++;
+            lock.unlock();
+
+            job();
+
+            lock.lock();
+            busy_workers--;
+
+            if (jobs.empty() && busy_workers == 0)
+                idle.notify_all();
+        }
+    }
+}
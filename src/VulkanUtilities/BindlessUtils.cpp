@@ -0,0 +1,241 @@
+#include "VulkanUtilities/BindlessUtils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "VulkanUtilities/HostAllocator.hpp"
+
+namespace VulkanUtilities {
+    bool isDescriptorIndexingSupported(const VkPhysicalDeviceDescriptorIndexingFeaturesEXT& features) {
+        return features.runtimeDescriptorArray                        &&
+               features.descriptorBindingPartiallyBound               &&
+               features.descriptorBindingVariableDescriptorCount      &&
+               features.descriptorBindingStorageBufferUpdateAfterBind &&
+               features.descriptorBindingSampledImageUpdateAfterBind  &&
+               features.shaderSampledImageArrayNonUniformIndexing;
+    }
+
+    // Only turns on what the bindless table actually uses (pNext is left alone so it can be chained)
+    void populateDescriptorIndexingFeatures(VkPhysicalDeviceDescriptorIndexingFeaturesEXT& features) {
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+        features.runtimeDescriptorArray                        = VK_TRUE;
+        features.descriptorBindingPartiallyBound               = VK_TRUE;
+        features.descriptorBindingVariableDescriptorCount      = VK_TRUE;
+        features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        features.descriptorBindingSampledImageUpdateAfterBind  = VK_TRUE;
+        features.shaderSampledImageArrayNonUniformIndexing     = VK_TRUE;
+    }
+
+    BindlessTable createBindlessTable(const VkDevice device, const VkPhysicalDevice physical_device, const BindlessCapacities& requested_capacities) {
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexing_properties{};
+        indexing_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &indexing_properties;
+
+        vkGetPhysicalDeviceProperties2(physical_device, &properties);
+
+        BindlessTable table{};
+
+        // Clamp to the per-stage limits too, since every binding is visible to every stage
+        table.Capacities.StorageBuffers = std::min({ requested_capacities.StorageBuffers,
+            indexing_properties.maxDescriptorSetUpdateAfterBindStorageBuffers, indexing_properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+        table.Capacities.SampledImages  = std::min({ requested_capacities.SampledImages,
+            indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages, indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages });
+        table.Capacities.Samplers       = std::min({ requested_capacities.Samplers,
+            indexing_properties.maxDescriptorSetUpdateAfterBindSamplers, indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+        std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+
+        bindings[0].binding         = BINDLESS_STORAGE_BUFFER_BINDING;
+        bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[0].descriptorCount = table.Capacities.StorageBuffers;
+        bindings[0].stageFlags      = VK_SHADER_STAGE_ALL;
+
+        bindings[1].binding         = BINDLESS_SAMPLED_IMAGE_BINDING;
+        bindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        bindings[1].descriptorCount = table.Capacities.SampledImages;
+        bindings[1].stageFlags      = VK_SHADER_STAGE_ALL;
+
+        bindings[2].binding         = BINDLESS_SAMPLER_BINDING;
+        bindings[2].descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLER;
+        bindings[2].descriptorCount = table.Capacities.Samplers;
+        bindings[2].stageFlags      = VK_SHADER_STAGE_ALL;
+
+        // Basically:
+        //  . Update After Bind:          Slots can be written while the set is bound in a recorded (or pending) command buffer
+        //  . Partially Bound:            Slots nobody reads don't need a valid descriptor
+        //  . Variable Descriptor Count:  The real size of the last array is picked at allocation time
+        constexpr VkDescriptorBindingFlagsEXT common_flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+
+        const std::array<VkDescriptorBindingFlagsEXT, 3> binding_flags = {
+            common_flags,
+            common_flags,
+            common_flags | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT
+        };
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_info{};
+
+        binding_flags_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        binding_flags_info.bindingCount  = static_cast<uint32_t>(binding_flags.size());
+        binding_flags_info.pBindingFlags = binding_flags.data();
+
+        VkDescriptorSetLayoutCreateInfo layout_info{};
+
+        layout_info.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layout_info.pNext        = &binding_flags_info;
+        layout_info.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        layout_info.bindingCount = static_cast<uint32_t>(bindings.size());
+        layout_info.pBindings    = bindings.data();
+
+        if (vkCreateDescriptorSetLayout(device, &layout_info, getAllocationCallbacks(), &table.Layout) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create bindless descriptor set layout!"};
+
+        std::array<VkDescriptorPoolSize, 3> pool_sizes{};
+
+        pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        pool_sizes[0].descriptorCount = table.Capacities.StorageBuffers;
+        pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        pool_sizes[1].descriptorCount = table.Capacities.SampledImages;
+        pool_sizes[2].type            = VK_DESCRIPTOR_TYPE_SAMPLER;
+        pool_sizes[2].descriptorCount = table.Capacities.Samplers;
+
+        VkDescriptorPoolCreateInfo pool_info{};
+
+        pool_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+        pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+        pool_info.pPoolSizes    = pool_sizes.data();
+        pool_info.maxSets       = 1;
+
+        if (vkCreateDescriptorPool(device, &pool_info, getAllocationCallbacks(), &table.Pool) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create bindless descriptor pool!"};
+
+        VkDescriptorSetVariableDescriptorCountAllocateInfoEXT variable_count_info{};
+
+        variable_count_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO_EXT;
+        variable_count_info.descriptorSetCount = 1;
+        variable_count_info.pDescriptorCounts  = &table.Capacities.Samplers;
+
+        VkDescriptorSetAllocateInfo allocate_info{};
+
+        allocate_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.pNext              = &variable_count_info;
+        allocate_info.descriptorPool     = table.Pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts        = &table.Layout;
+
+        if (vkAllocateDescriptorSets(device, &allocate_info, &table.Set) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to allocate the bindless descriptor set!"};
+
+        return table;
+    }
+
+    void destroyBindlessTable(const VkDevice device, BindlessTable& table) {
+        // The set goes away with the pool
+        vkDestroyDescriptorPool(device, table.Pool, getAllocationCallbacks());
+        vkDestroyDescriptorSetLayout(device, table.Layout, getAllocationCallbacks());
+
+        table = {};
+    }
+
+    // Recycled slots are preferred so the arrays stay dense
+    static uint32_t acquireSlot(std::vector<uint32_t>& free_slots, uint32_t& count, const uint32_t capacity) {
+        if (!free_slots.empty()) {
+            const uint32_t slot = free_slots.back();
+            free_slots.pop_back();
+
+            return slot;
+        }
+
+        if (count >= capacity)
+            throw std::runtime_error{"Ran out of bindless descriptor slots!"};
+
+        return count++;
+    }
+
+    uint32_t registerBindlessStorageBuffer(const VkDevice device, BindlessTable& table, const VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize range) {
+        const uint32_t slot = acquireSlot(table.FreeStorageBuffers, table.StorageBufferCount, table.Capacities.StorageBuffers);
+
+        VkDescriptorBufferInfo buffer_info{};
+
+        buffer_info.buffer = buffer;
+        buffer_info.offset = offset;
+        buffer_info.range  = range;
+
+        VkWriteDescriptorSet descriptor_write{};
+
+        descriptor_write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_write.dstSet          = table.Set;
+        descriptor_write.dstBinding      = BINDLESS_STORAGE_BUFFER_BINDING;
+        descriptor_write.dstArrayElement = slot;
+        descriptor_write.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_write.descriptorCount = 1;
+        descriptor_write.pBufferInfo     = &buffer_info;
+
+        vkUpdateDescriptorSets(device, 1, &descriptor_write, 0, nullptr);
+
+        return slot;
+    }
+
+    uint32_t registerBindlessSampledImage(const VkDevice device, BindlessTable& table, const VkImageView view, const VkImageLayout layout) {
+        const uint32_t slot = acquireSlot(table.FreeSampledImages, table.SampledImageCount, table.Capacities.SampledImages);
+
+        VkDescriptorImageInfo image_info{};
+
+        image_info.imageView   = view;
+        image_info.imageLayout = layout;
+
+        VkWriteDescriptorSet descriptor_write{};
+
+        descriptor_write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_write.dstSet          = table.Set;
+        descriptor_write.dstBinding      = BINDLESS_SAMPLED_IMAGE_BINDING;
+        descriptor_write.dstArrayElement = slot;
+        descriptor_write.descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        descriptor_write.descriptorCount = 1;
+        descriptor_write.pImageInfo      = &image_info;
+
+        vkUpdateDescriptorSets(device, 1, &descriptor_write, 0, nullptr);
+
+        return slot;
+    }
+
+    uint32_t registerBindlessSampler(const VkDevice device, BindlessTable& table, const VkSampler sampler) {
+        const uint32_t slot = acquireSlot(table.FreeSamplers, table.SamplerCount, table.Capacities.Samplers);
+
+        VkDescriptorImageInfo image_info{};
+
+        image_info.sampler = sampler;
+
+        VkWriteDescriptorSet descriptor_write{};
+
+        descriptor_write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_write.dstSet          = table.Set;
+        descriptor_write.dstBinding      = BINDLESS_SAMPLER_BINDING;
+        descriptor_write.dstArrayElement = slot;
+        descriptor_write.descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLER;
+        descriptor_write.descriptorCount = 1;
+        descriptor_write.pImageInfo      = &image_info;
+
+        vkUpdateDescriptorSets(device, 1, &descriptor_write, 0, nullptr);
+
+        return slot;
+    }
+
+    // Releasing only hands the slot back, the caller has to make sure no in-flight frame still reads it
+    void releaseBindlessStorageBuffer(BindlessTable& table, const uint32_t index) {
+        table.FreeStorageBuffers.push_back(index);
+    }
+
+    void releaseBindlessSampledImage(BindlessTable& table, const uint32_t index) {
+        table.FreeSampledImages.push_back(index);
+    }
+
+    void releaseBindlessSampler(BindlessTable& table, const uint32_t index) {
+        table.FreeSamplers.push_back(index);
+    }
+}
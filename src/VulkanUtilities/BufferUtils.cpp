@@ -2,6 +2,8 @@
 
 #include <stdexcept>
 
+#include "VulkanUtilities/HostAllocator.hpp"
+
 namespace VulkanUtilities {
     uint32_t findMemoryType(
         const VkPhysicalDevice      device,
@@ -36,7 +38,7 @@ namespace VulkanUtilities {
         create_info.usage       = usage_flags;
         create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        if (vkCreateBuffer(device, &create_info, nullptr, &buffer) != VK_SUCCESS)
+        if (vkCreateBuffer(device, &create_info, getAllocationCallbacks(), &buffer) != VK_SUCCESS)
             throw std::runtime_error{"Failed to create buffer!"};
 
         VkMemoryRequirements memory_requirements{};
@@ -48,20 +50,13 @@ namespace VulkanUtilities {
         allocate_info.allocationSize  = memory_requirements.size;
         allocate_info.memoryTypeIndex = findMemoryType(physical_device, memory_requirements.memoryTypeBits, property_flags);
 
-        if (vkAllocateMemory(device, &allocate_info, nullptr, &memory) != VK_SUCCESS)
+        if (vkAllocateMemory(device, &allocate_info, getAllocationCallbacks(), &memory) != VK_SUCCESS)
             throw std::runtime_error{"Failed to allocate buffer memory!"};
 
         vkBindBufferMemory(device, buffer, memory, 0);
     }
 
-    void copyBuffer(
-        const VkDevice      device,
-        const VkCommandPool pool,
-        const VkQueue       queue,
-        const VkBuffer      source,
-        const VkBuffer      destination,
-        const VkDeviceSize  size
-    ) {
+    VkCommandBuffer beginSingleTimeCommands(const VkDevice device, const VkCommandPool pool) {
         VkCommandBufferAllocateInfo allocate_info{};
 
         allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -79,14 +74,10 @@ namespace VulkanUtilities {
 
         vkBeginCommandBuffer(command_buffer, &begin_info);
 
-        VkBufferCopy copy_region{};
-
-        copy_region.srcOffset = 0; // Optional
-        copy_region.dstOffset = 0; // Optional
-        copy_region.size      = size;
-
-        vkCmdCopyBuffer(command_buffer, source, destination, 1, &copy_region);
+        return command_buffer;
+    }
 
+    void endSingleTimeCommands(const VkDevice device, const VkCommandPool pool, const VkQueue queue, VkCommandBuffer command_buffer) {
         vkEndCommandBuffer(command_buffer);
 
         VkSubmitInfo submit_info{};
@@ -100,4 +91,49 @@ namespace VulkanUtilities {
 
         vkFreeCommandBuffers(device, pool, 1, &command_buffer);
     }
+
+    void copyBuffer(
+        const VkDevice      device,
+        const VkCommandPool pool,
+        const VkQueue       queue,
+        const VkBuffer      source,
+        const VkBuffer      destination,
+        const VkDeviceSize  size
+    ) {
+        VkBufferCopy copy_region{};
+
+        copy_region.srcOffset = 0; // Optional
+        copy_region.dstOffset = 0; // Optional
+        copy_region.size      = size;
+
+        copyBufferRegions(device, pool, queue, source, destination, { copy_region });
+    }
+
+    void copyBufferRegions(
+        const VkDevice                   device,
+        const VkCommandPool              pool,
+        const VkQueue                    queue,
+        const VkBuffer                   source,
+        const VkBuffer                   destination,
+        const std::vector<VkBufferCopy>& regions
+    ) {
+        if (regions.empty())
+            return;
+
+        const VkCommandBuffer command_buffer = beginSingleTimeCommands(device, pool);
+
+        cmdCopyBufferRegions(command_buffer, source, destination, regions);
+
+        endSingleTimeCommands(device, pool, queue, command_buffer);
+    }
+
+    void cmdCopyBufferRegions(
+        const VkCommandBuffer            command_buffer,
+        const VkBuffer                   source,
+        const VkBuffer                   destination,
+        const std::vector<VkBufferCopy>& regions
+    ) {
+        if (!regions.empty())
+            vkCmdCopyBuffer(command_buffer, source, destination, static_cast<uint32_t>(regions.size()), regions.data());
+    }
 }
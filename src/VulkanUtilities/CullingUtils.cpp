@@ -0,0 +1,75 @@
+#include "VulkanUtilities/CullingUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VulkanUtilities {
+    FrustumPlanes extractFrustumPlanes(const glm::mat4& view_projection) {
+        // glm is column major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+        const auto row = [&](const int i) { return glm::vec4{ view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i] }; };
+
+        const glm::vec4 x = row(0);
+        const glm::vec4 y = row(1);
+        const glm::vec4 z = row(2);
+        const glm::vec4 w = row(3);
+
+        FrustumPlanes planes = {
+            w + x, // Left
+            w - x, // Right
+            w + y, // Bottom (top once the projection is Y flipped, doesn't matter here)
+            w - y, // Top
+            z,     // Near (Vulkan depth starts at 0, not -w)
+            w - z  // Far
+        };
+
+        for (auto& plane : planes)
+            plane = plane / glm::length(glm::vec3{ plane.x, plane.y, plane.z });
+
+        return planes;
+    }
+
+    bool isSphereInFrustum(const FrustumPlanes& planes, const glm::vec4 sphere) {
+        return std::ranges::all_of(planes, [&](const glm::vec4& plane) {
+            return plane.x * sphere.x + plane.y * sphere.y + plane.z * sphere.z + plane.w >= -sphere.w;
+        });
+    }
+
+    // Centered on the bounding box, not minimal but good enough for culling
+    glm::vec4 computeBoundingSphere(const std::span<const glm::vec3> positions) {
+        if (positions.empty())
+            return glm::vec4{ 0.0f };
+
+        glm::vec3 minimum = positions[0];
+        glm::vec3 maximum = positions[0];
+
+        for (const auto& position : positions) {
+            minimum = glm::min(minimum, position);
+            maximum = glm::max(maximum, position);
+        }
+
+        const glm::vec3 center = (minimum + maximum) * 0.5f;
+
+        float radius = 0.0f;
+        for (const auto& position : positions)
+            radius = std::max(radius, glm::length(position - center));
+
+        return { center, radius };
+    }
+
+    // Non-uniform scale grows the sphere by the largest axis scale, so it still covers the object
+    glm::vec4 transformBoundingSphere(const glm::mat4& model, const glm::vec4 sphere) {
+        const glm::vec4 center = model * glm::vec4{ sphere.x, sphere.y, sphere.z, 1.0f };
+
+        const float scale = std::sqrt(std::max({
+            glm::dot(glm::vec3{ model[0] }, glm::vec3{ model[0] }),
+            glm::dot(glm::vec3{ model[1] }, glm::vec3{ model[1] }),
+            glm::dot(glm::vec3{ model[2] }, glm::vec3{ model[2] })
+        }));
+
+        return { center.x, center.y, center.z, sphere.w * scale };
+    }
+
+    bool isDrawIndirectCountSupported(const VkPhysicalDeviceFeatures& features) {
+        return features.multiDrawIndirect && features.drawIndirectFirstInstance;
+    }
+}
@@ -0,0 +1,17 @@
+#include "VulkanUtilities/DebugNames.hpp"
+
+#include <cstdio>
+
+namespace VulkanUtilities {
+    void setDebugObjectName(const VkDevice device, const VkObjectType type, const uint64_t handle, const char* name, const uint32_t index) {
+        if (index == NO_NAME_INDEX) {
+            setDebugUtilsObjectNameEXT(device, type, handle, name);
+            return;
+        }
+
+        char indexed_name[DEBUG_NAME_LENGTH];
+        std::snprintf(indexed_name, sizeof(indexed_name), "%s [%u]", name, index);
+
+        setDebugUtilsObjectNameEXT(device, type, handle, indexed_name);
+    }
+}
@@ -1,8 +1,199 @@
 #include "VulkanUtilities/DebugUtils.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
 #include "spdlog/spdlog.h"
 
 namespace VulkanUtilities {
+    static constexpr uint32_t DEBUG_MESSAGE_NAME_LENGTH = 64;
+
+    // Bounded multi-producer queue (Vyukov's), a slot is free for the producer at position p when its sequence is p,
+    // and ready for the consumer once the producer bumped it to p + 1
+    struct QueuedDebugMessage {
+        std::atomic<uint64_t>                  Sequence   = 0;
+        VkDebugUtilsMessageSeverityFlagBitsEXT Severity   = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+        int32_t                                Id         = 0;
+        uint32_t                               Suppressed = 0; // Repeats of this id that weren't logged since the last one that was
+        std::array<char, DEBUG_MESSAGE_LENGTH> Text{};
+    };
+
+    struct DebugMessageQueue {
+        std::array<QueuedDebugMessage, DEBUG_MESSAGE_QUEUE_SIZE> Messages;
+        std::atomic<uint64_t>                                    EnqueuePosition = 0;
+        uint64_t                                                 DequeuePosition = 0; // Only ever one thread logging
+
+        DebugMessageQueue() {
+            for (uint32_t i = 0; i < DEBUG_MESSAGE_QUEUE_SIZE; i++)
+                Messages[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+    };
+
+    // Open addressing on the message id, a slot is claimed once and kept for good
+    struct DebugMessageIdSlot {
+        std::atomic<uint64_t> Key             = 0; // 0 while free, the id with bit 32 set once claimed
+        std::atomic<int64_t>  WindowStart     = 0; // Milliseconds
+        std::atomic<uint32_t> WindowCount     = 0;
+        std::atomic<uint32_t> Suppressed      = 0; // Since the last logged one
+        std::atomic<uint64_t> Total           = 0;
+        std::atomic<uint64_t> TotalSuppressed = 0;
+
+        std::array<char, DEBUG_MESSAGE_NAME_LENGTH> Name{}; // Written by whoever claimed the slot, only read after the log stopped
+    };
+
+    struct AtomicDebugMessageStatistics {
+        std::atomic<uint64_t> Received    = 0;
+        std::atomic<uint64_t> Logged      = 0;
+        std::atomic<uint64_t> Suppressed  = 0;
+        std::atomic<uint64_t> Dropped     = 0;
+        std::atomic<uint32_t> DistinctIds = 0;
+    };
+
+    static DebugMessageQueue                                      message_queue;
+    static std::array<DebugMessageIdSlot, DEBUG_MESSAGE_ID_SLOTS> message_ids;
+    static AtomicDebugMessageStatistics                           message_statistics;
+
+    static std::thread           log_thread;
+    static std::atomic<bool>     log_running = false;
+    static std::atomic<uint32_t> log_wakeups = 0; // Bumped on every push, the log thread sleeps on it
+
+    static void copyString(char* destination, const size_t capacity, const char* source) {
+        if (!source)
+            source = "";
+
+        const size_t length = std::min(std::strlen(source), capacity - 1);
+
+        std::memcpy(destination, source, length);
+        destination[length] = '\0';
+    }
+
+    static int64_t nowMilliseconds() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static DebugMessageIdSlot* findIdSlot(const int32_t id, const char* name) {
+        const uint64_t key = static_cast<uint32_t>(id) | uint64_t{1} << 32;
+
+        // Murmur's finalizer, ids are hashes already but it doesn't hurt
+        uint32_t hash = static_cast<uint32_t>(id);
+        hash ^= hash >> 16; hash *= 0x85EBCA6B;
+        hash ^= hash >> 13; hash *= 0xC2B2AE35;
+        hash ^= hash >> 16;
+
+        for (uint32_t probe = 0; probe < DEBUG_MESSAGE_ID_SLOTS; probe++) {
+            DebugMessageIdSlot& slot = message_ids[(hash + probe) & (DEBUG_MESSAGE_ID_SLOTS - 1)];
+
+            uint64_t current = slot.Key.load(std::memory_order_acquire);
+
+            if (current == 0 && slot.Key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                copyString(slot.Name.data(), slot.Name.size(), name);
+                message_statistics.DistinctIds.fetch_add(1, std::memory_order_relaxed);
+                return &slot;
+            }
+
+            if (current == key)
+                return &slot;
+        }
+
+        return nullptr;
+    }
+
+    // False when it's over the limit, counted as suppressed then
+    //  . Two threads starting a new window at once can let a message or two more through, not worth a lock
+    static bool allowMessage(DebugMessageIdSlot& slot) {
+        slot.Total.fetch_add(1, std::memory_order_relaxed);
+
+        const int64_t now   = nowMilliseconds();
+        int64_t       start = slot.WindowStart.load(std::memory_order_relaxed);
+
+        if (now - start >= DEBUG_MESSAGE_RATE_WINDOW_MS && slot.WindowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+            slot.WindowCount.store(0, std::memory_order_relaxed);
+
+        if (slot.WindowCount.fetch_add(1, std::memory_order_relaxed) < DEBUG_MESSAGE_RATE_LIMIT)
+            return true;
+
+        slot.Suppressed.fetch_add(1, std::memory_order_relaxed);
+        slot.TotalSuppressed.fetch_add(1, std::memory_order_relaxed);
+        message_statistics.Suppressed.fetch_add(1, std::memory_order_relaxed);
+
+        return false;
+    }
+
+    static bool pushMessage(const VkDebugUtilsMessageSeverityFlagBitsEXT severity, const int32_t id, const uint32_t suppressed, const char* text) {
+        uint64_t position = message_queue.EnqueuePosition.load(std::memory_order_relaxed);
+
+        QueuedDebugMessage* message;
+
+        for (;;) {
+            message = &message_queue.Messages[position & (DEBUG_MESSAGE_QUEUE_SIZE - 1)];
+
+            const uint64_t sequence   = message->Sequence.load(std::memory_order_acquire);
+            const auto     difference = static_cast<int64_t>(sequence - position);
+
+            if (difference == 0) {
+                if (message_queue.EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            } else if (difference < 0)
+                return false; // Full, the log thread is a whole queue behind
+            else
+                position = message_queue.EnqueuePosition.load(std::memory_order_relaxed);
+        }
+
+        message->Severity   = severity;
+        message->Id         = id;
+        message->Suppressed = suppressed;
+        copyString(message->Text.data(), message->Text.size(), text);
+
+        message->Sequence.store(position + 1, std::memory_order_release);
+
+        log_wakeups.fetch_add(1, std::memory_order_release);
+        log_wakeups.notify_one();
+
+        return true;
+    }
+
+    static void logMessage(const QueuedDebugMessage& message) {
+        const bool error = message.Severity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+
+        if (message.Suppressed > 0)
+            spdlog::log(error ? spdlog::level::err : spdlog::level::warn, " . Validation Layer {}: {} ({} more like it suppressed)",
+                error ? "Error" : "Warning", message.Text.data(), message.Suppressed);
+        else
+            spdlog::log(error ? spdlog::level::err : spdlog::level::warn, " . Validation Layer {}: {}", error ? "Error" : "Warning", message.Text.data());
+
+        message_statistics.Logged.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Single consumer, either the log thread or stopDebugMessageLog() once it's gone
+    static void drainMessages() {
+        for (;;) {
+            QueuedDebugMessage& message = message_queue.Messages[message_queue.DequeuePosition & (DEBUG_MESSAGE_QUEUE_SIZE - 1)];
+
+            if (message.Sequence.load(std::memory_order_acquire) != message_queue.DequeuePosition + 1)
+                return;
+
+            logMessage(message);
+
+            message.Sequence.store(message_queue.DequeuePosition + DEBUG_MESSAGE_QUEUE_SIZE, std::memory_order_release);
+            message_queue.DequeuePosition++;
+        }
+    }
+
+    static void runDebugMessageLog() {
+        while (log_running.load(std::memory_order_acquire)) {
+            // Read before draining, a push that comes in after the drain changes it and wait() returns straight away
+            const uint32_t wakeups = log_wakeups.load(std::memory_order_acquire);
+
+            drainMessages();
+
+            log_wakeups.wait(wakeups, std::memory_order_acquire);
+        }
+    }
+
     VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
         VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
         VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -11,9 +202,68 @@ namespace VulkanUtilities {
     ) {
         // VERY GOOD REFERENCE FOR THIS: https://vulkan-tutorial.com/en/Drawing_a_triangle/Setup/Validation_layers
 
-        if (messageSeverity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
-            spdlog::error(" . Validation Layer Error: {}", pCallbackData->pMessage);
+        if (messageSeverity < VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
+            return VK_FALSE;
+
+        message_statistics.Received.fetch_add(1, std::memory_order_relaxed);
+
+        uint32_t suppressed = 0;
+
+        if (DebugMessageIdSlot* slot = findIdSlot(pCallbackData->messageIdNumber, pCallbackData->pMessageIdName)) {
+            if (!allowMessage(*slot))
+                return VK_FALSE;
+
+            suppressed = slot->Suppressed.exchange(0, std::memory_order_relaxed);
+        }
+
+        if (!pushMessage(messageSeverity, pCallbackData->messageIdNumber, suppressed, pCallbackData->pMessage))
+            message_statistics.Dropped.fetch_add(1, std::memory_order_relaxed);
 
         return VK_FALSE;
     }
+
+    void startDebugMessageLog() {
+        if (log_running.exchange(true))
+            return;
+
+        log_thread = std::thread{ runDebugMessageLog };
+    }
+
+    void stopDebugMessageLog() {
+        if (log_running.exchange(false)) {
+            log_wakeups.fetch_add(1, std::memory_order_release);
+            log_wakeups.notify_one();
+
+            log_thread.join();
+        }
+
+        drainMessages();
+
+        const DebugMessageStatistics statistics = getDebugMessageStatistics();
+
+        if (statistics.Received == 0)
+            return;
+
+        spdlog::info("Validation messages: {} received from {} ids, {} logged, {} suppressed, {} dropped",
+            statistics.Received, statistics.DistinctIds, statistics.Logged, statistics.Suppressed, statistics.Dropped);
+
+        for (const DebugMessageIdSlot& slot : message_ids) {
+            const uint64_t key              = slot.Key.load(std::memory_order_acquire);
+            const uint64_t total_suppressed = slot.TotalSuppressed.load(std::memory_order_relaxed);
+
+            if (key != 0 && total_suppressed > 0)
+                spdlog::info(" . {} ({:#010x}): {} times, {} suppressed", slot.Name.data(), static_cast<uint32_t>(key),
+                    slot.Total.load(std::memory_order_relaxed), total_suppressed);
+        }
+    }
+
+    DebugMessageStatistics getDebugMessageStatistics() {
+        return {
+            message_statistics.Received.load(std::memory_order_relaxed),
+            message_statistics.Logged.load(std::memory_order_relaxed),
+            message_statistics.Suppressed.load(std::memory_order_relaxed),
+            message_statistics.Dropped.load(std::memory_order_relaxed),
+            message_statistics.DistinctIds.load(std::memory_order_relaxed)
+        };
+    }
 }
@@ -0,0 +1,91 @@
+#include "VulkanUtilities/DepthPyramid.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "VulkanUtilities/BufferUtils.hpp"
+#include "VulkanUtilities/HostAllocator.hpp"
+#include "VulkanUtilities/ImageUtils.hpp"
+
+namespace VulkanUtilities {
+    VkExtent2D getDepthPyramidExtent(const VkExtent2D depth_extent) {
+        return { std::max(depth_extent.width / 2, 1u), std::max(depth_extent.height / 2, 1u) };
+    }
+
+    DepthPyramid createDepthPyramid(
+        const VkDevice         device,
+        const VkPhysicalDevice physical_device,
+        const VkCommandPool    pool,
+        const VkQueue          queue,
+        const VkExtent2D       depth_extent
+    ) {
+        DepthPyramid pyramid{};
+
+        const VkExtent2D extent = getDepthPyramidExtent(depth_extent);
+
+        pyramid.Width     = extent.width;
+        pyramid.Height    = extent.height;
+        pyramid.MipLevels = getMipLevelCount(extent.width, extent.height);
+
+        createImage(device, physical_device, pyramid.Width, pyramid.Height, pyramid.MipLevels, DEPTH_PYRAMID_FORMAT,
+            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pyramid.Image, pyramid.Memory);
+
+        pyramid.View = createImageView(device, pyramid.Image, DEPTH_PYRAMID_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT, 0, pyramid.MipLevels);
+
+        for (uint32_t level = 0; level < pyramid.MipLevels; level++)
+            pyramid.MipViews.push_back(createImageView(device, pyramid.Image, DEPTH_PYRAMID_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT, level, 1));
+
+        VkSamplerCreateInfo sampler_info{};
+
+        sampler_info.sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        sampler_info.magFilter    = VK_FILTER_NEAREST;
+        sampler_info.minFilter    = VK_FILTER_NEAREST;
+        sampler_info.mipmapMode   = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler_info.minLod       = 0.0f;
+        sampler_info.maxLod       = VK_LOD_CLAMP_NONE;
+
+        if (vkCreateSampler(device, &sampler_info, getAllocationCallbacks(), &pyramid.Sampler) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create the depth pyramid sampler!"};
+
+        // Straight to GENERAL, it never leaves it
+        const VkCommandBuffer command_buffer = beginSingleTimeCommands(device, pool);
+
+        VkImageMemoryBarrier barrier{};
+
+        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask                   = 0;
+        barrier.dstAccessMask                   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.oldLayout                       = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout                       = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image                           = pyramid.Image;
+        barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel   = 0;
+        barrier.subresourceRange.levelCount     = pyramid.MipLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount     = 1;
+
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        endSingleTimeCommands(device, pool, queue, command_buffer);
+
+        return pyramid;
+    }
+
+    void destroyDepthPyramid(const VkDevice device, DepthPyramid& pyramid) {
+        vkDestroySampler(device, pyramid.Sampler, getAllocationCallbacks());
+
+        for (const auto view : pyramid.MipViews)
+            vkDestroyImageView(device, view, getAllocationCallbacks());
+
+        vkDestroyImageView(device, pyramid.View, getAllocationCallbacks());
+        vkDestroyImage(device, pyramid.Image, getAllocationCallbacks());
+        vkFreeMemory(device, pyramid.Memory, getAllocationCallbacks());
+
+        pyramid = {};
+    }
+}
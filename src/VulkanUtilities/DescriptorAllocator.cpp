@@ -0,0 +1,235 @@
+#include "VulkanUtilities/DescriptorAllocator.hpp"
+#include "VulkanUtilities/DescriptorTemplates.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "VulkanUtilities/HostAllocator.hpp"
+
+namespace VulkanUtilities {
+    bool isImageDescriptor(const VkDescriptorType type) {
+        return type == VK_DESCRIPTOR_TYPE_SAMPLER                ||
+               type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+               type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE          ||
+               type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE          ||
+               type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    }
+
+    static VkDescriptorPool createDescriptorPool(const VkDevice device, const DescriptorAllocator& allocator) {
+        std::vector<VkDescriptorPoolSize> pool_sizes{};
+        pool_sizes.reserve(allocator.Ratios.size());
+
+        for (const auto& [Type, Ratio] : allocator.Ratios)
+            pool_sizes.push_back({ Type, std::max(1u, static_cast<uint32_t>(Ratio * static_cast<float>(allocator.SetsPerPool))) });
+
+        VkDescriptorPoolCreateInfo create_info{};
+
+        create_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        create_info.flags         = 0; // No FREE_DESCRIPTOR_SET_BIT, sets only ever go away all at once with the pool reset
+        create_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+        create_info.pPoolSizes    = pool_sizes.data();
+        create_info.maxSets       = allocator.SetsPerPool;
+
+        VkDescriptorPool pool;
+        if (vkCreateDescriptorPool(device, &create_info, getAllocationCallbacks(), &pool) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create Descriptor Pool!"};
+
+        return pool;
+    }
+
+    // Reuses a pool that was reset if there is one, otherwise makes a new one (half again as big as the last)
+    static VkDescriptorPool acquirePool(const VkDevice device, DescriptorAllocator& allocator) {
+        if (!allocator.ReadyPools.empty()) {
+            const VkDescriptorPool pool = allocator.ReadyPools.back();
+            allocator.ReadyPools.pop_back();
+
+            return pool;
+        }
+
+        if (allocator.PoolsCreated > 0)
+            allocator.SetsPerPool = std::min(allocator.SetsPerPool + allocator.SetsPerPool / 2, MAX_DESCRIPTOR_SETS_PER_POOL);
+
+        allocator.PoolsCreated++;
+
+        return createDescriptorPool(device, allocator);
+    }
+
+    DescriptorAllocator createDescriptorAllocator(const uint32_t initial_sets_per_pool, const std::vector<DescriptorPoolRatio>& ratios) {
+        DescriptorAllocator allocator{};
+
+        allocator.Ratios      = ratios;
+        allocator.SetsPerPool = std::max(1u, initial_sets_per_pool);
+
+        return allocator;
+    }
+
+    void destroyDescriptorAllocator(const VkDevice device, DescriptorAllocator& allocator) {
+        if (allocator.CurrentPool != VK_NULL_HANDLE)
+            vkDestroyDescriptorPool(device, allocator.CurrentPool, getAllocationCallbacks());
+
+        for (const auto pool : allocator.FullPools)
+            vkDestroyDescriptorPool(device, pool, getAllocationCallbacks());
+
+        for (const auto pool : allocator.ReadyPools)
+            vkDestroyDescriptorPool(device, pool, getAllocationCallbacks());
+
+        allocator = {};
+    }
+
+    // Every set that came out of this allocator is invalid afterwards (so only do this once the GPU is done with them)
+    void resetDescriptorAllocator(const VkDevice device, DescriptorAllocator& allocator) {
+        if (allocator.CurrentPool != VK_NULL_HANDLE) {
+            allocator.FullPools.push_back(allocator.CurrentPool);
+            allocator.CurrentPool = VK_NULL_HANDLE;
+        }
+
+        for (const auto pool : allocator.FullPools) {
+            vkResetDescriptorPool(device, pool, 0);
+            allocator.ReadyPools.push_back(pool);
+        }
+
+        allocator.FullPools.clear();
+    }
+
+    VkDescriptorSet allocateDescriptorSet(const VkDevice device, DescriptorAllocator& allocator, const VkDescriptorSetLayout layout, const void* allocate_next) {
+        if (allocator.CurrentPool == VK_NULL_HANDLE)
+            allocator.CurrentPool = acquirePool(device, allocator);
+
+        VkDescriptorSetAllocateInfo allocate_info{};
+
+        allocate_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.pNext              = allocate_next;
+        allocate_info.descriptorPool     = allocator.CurrentPool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts        = &layout;
+
+        VkDescriptorSet set;
+        VkResult        result = vkAllocateDescriptorSets(device, &allocate_info, &set);
+
+        // The current pool is full, retire it and try again with a fresh one (a fresh pool failing means something else is wrong)
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+            allocator.FullPools.push_back(allocator.CurrentPool);
+
+            allocator.CurrentPool        = acquirePool(device, allocator);
+            allocate_info.descriptorPool = allocator.CurrentPool;
+
+            result = vkAllocateDescriptorSets(device, &allocate_info, &set);
+        }
+
+        if (result != VK_SUCCESS)
+            throw std::runtime_error{"Failed to allocate Descriptor Set!"};
+
+        allocator.SetsAllocated++;
+
+        return set;
+    }
+
+    bool operator==(const DescriptorBinding& left, const DescriptorBinding& right) {
+        if (left.Binding != right.Binding || left.Type != right.Type)
+            return false;
+
+        if (isImageDescriptor(left.Type))
+            return left.ImageInfo.sampler     == right.ImageInfo.sampler   &&
+                   left.ImageInfo.imageView   == right.ImageInfo.imageView &&
+                   left.ImageInfo.imageLayout == right.ImageInfo.imageLayout;
+
+        return left.BufferInfo.buffer == right.BufferInfo.buffer &&
+               left.BufferInfo.offset == right.BufferInfo.offset &&
+               left.BufferInfo.range  == right.BufferInfo.range;
+    }
+
+    // FNV-1a over everything operator== looks at
+    size_t DescriptorSetKeyHash::operator()(const DescriptorSetKey& key) const {
+        uint64_t hash = 14695981039346656037ull;
+
+        const auto combine = [&hash](const uint64_t value) {
+            for (int i = 0; i < 8; i++) {
+                hash ^= (value >> (i * 8)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+        };
+
+        combine(reinterpret_cast<uint64_t>(key.Layout));
+
+        for (const auto& binding : key.Bindings) {
+            combine(binding.Binding);
+            combine(binding.Type);
+
+            if (isImageDescriptor(binding.Type)) {
+                combine(reinterpret_cast<uint64_t>(binding.ImageInfo.sampler));
+                combine(reinterpret_cast<uint64_t>(binding.ImageInfo.imageView));
+                combine(binding.ImageInfo.imageLayout);
+            } else {
+                combine(reinterpret_cast<uint64_t>(binding.BufferInfo.buffer));
+                combine(binding.BufferInfo.offset);
+                combine(binding.BufferInfo.range);
+            }
+        }
+
+        return static_cast<size_t>(hash);
+    }
+
+    DescriptorSetCache createDescriptorSetCache(const uint32_t initial_sets_per_pool, const std::vector<DescriptorPoolRatio>& ratios) {
+        DescriptorSetCache cache{};
+        cache.Allocator = createDescriptorAllocator(initial_sets_per_pool, ratios);
+
+        return cache;
+    }
+
+    void destroyDescriptorSetCache(const VkDevice device, DescriptorSetCache& cache) {
+        destroyDescriptorAllocator(device, cache.Allocator);
+
+        cache = {};
+    }
+
+    VkDescriptorSet getOrCreateDescriptorSet(
+        const VkDevice                        device,
+        DescriptorSetCache&                   cache,
+        const VkDescriptorSetLayout           layout,
+        const std::vector<DescriptorBinding>& bindings,
+        const VkDescriptorUpdateTemplate      update_template
+    ) {
+        DescriptorSetKey key{ layout, bindings };
+
+        if (const auto iterator = cache.Sets.find(key); iterator != cache.Sets.end()) {
+            cache.Hits++;
+            return iterator->second;
+        }
+
+        cache.Misses++;
+
+        const VkDescriptorSet set = allocateDescriptorSet(device, cache.Allocator, layout);
+
+        if (update_template != VK_NULL_HANDLE) {
+            const std::vector<std::byte> data = packDescriptorBindings(bindings);
+            vkUpdateDescriptorSetWithTemplate(device, set, update_template, data.data());
+
+            cache.Sets.emplace(std::move(key), set);
+
+            return set;
+        }
+
+        std::vector<VkWriteDescriptorSet> descriptor_writes{bindings.size()};
+
+        for (size_t i = 0; i < bindings.size(); i++) {
+            descriptor_writes[i].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_writes[i].dstSet          = set;
+            descriptor_writes[i].dstBinding      = bindings[i].Binding;
+            descriptor_writes[i].dstArrayElement = 0;
+            descriptor_writes[i].descriptorType  = bindings[i].Type;
+            descriptor_writes[i].descriptorCount = 1;
+
+            if (isImageDescriptor(bindings[i].Type))
+                descriptor_writes[i].pImageInfo  = &bindings[i].ImageInfo;
+            else
+                descriptor_writes[i].pBufferInfo = &bindings[i].BufferInfo;
+        }
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data(), 0, nullptr);
+
+        cache.Sets.emplace(std::move(key), set);
+
+        return set;
+    }
+}
@@ -0,0 +1,106 @@
+#include "VulkanUtilities/DescriptorTemplates.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "VulkanUtilities/HostAllocator.hpp"
+
+namespace VulkanUtilities {
+    size_t getDescriptorDataStride(const VkDescriptorType type) {
+        switch (type) {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                return sizeof(VkDescriptorBufferInfo);
+
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                return sizeof(VkDescriptorImageInfo);
+
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                return sizeof(VkBufferView);
+
+            default:
+                throw std::runtime_error{"Descriptor type not supported by update templates!"};
+        }
+    }
+
+    size_t getDescriptorDataSize(const std::vector<VkDescriptorSetLayoutBinding>& bindings) {
+        size_t size = 0;
+
+        for (const auto& binding : bindings)
+            size += getDescriptorDataStride(binding.descriptorType) * binding.descriptorCount;
+
+        return size;
+    }
+
+    VkDescriptorUpdateTemplate createDescriptorUpdateTemplate(
+        const VkDevice                                   device,
+        const VkDescriptorSetLayout                      layout,
+        const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+        const size_t                                     data_size
+    ) {
+        // Every info struct is a multiple of 8 bytes, so the packed offsets are already what the compiler would pick for a struct
+        if (const size_t packed_size = getDescriptorDataSize(bindings); packed_size != data_size)
+            throw std::runtime_error{"Descriptor template data is " + std::to_string(data_size) + " bytes, the layout packs to " + std::to_string(packed_size) + "!"};
+
+        std::vector<VkDescriptorUpdateTemplateEntry> entries{bindings.size()};
+
+        size_t offset = 0;
+        for (size_t i = 0; i < bindings.size(); i++) {
+            const size_t stride = getDescriptorDataStride(bindings[i].descriptorType);
+
+            entries[i].dstBinding      = bindings[i].binding;
+            entries[i].dstArrayElement = 0;
+            entries[i].descriptorCount = bindings[i].descriptorCount;
+            entries[i].descriptorType  = bindings[i].descriptorType;
+            entries[i].offset          = offset;
+            entries[i].stride          = stride;
+
+            offset += stride * bindings[i].descriptorCount;
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo create_info{};
+
+        create_info.sType                      = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        create_info.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+        create_info.pDescriptorUpdateEntries   = entries.data();
+        create_info.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        create_info.descriptorSetLayout        = layout;
+
+        VkDescriptorUpdateTemplate update_template;
+        if (vkCreateDescriptorUpdateTemplate(device, &create_info, getAllocationCallbacks(), &update_template) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create Descriptor Update Template!"};
+
+        return update_template;
+    }
+
+    std::vector<std::byte> packDescriptorBindings(const std::vector<DescriptorBinding>& bindings) {
+        size_t size = 0;
+        for (const auto& binding : bindings)
+            size += getDescriptorDataStride(binding.Type);
+
+        std::vector<std::byte> data(size);
+
+        size_t offset = 0;
+        for (const auto& binding : bindings) {
+            if (binding.Type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER || binding.Type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER)
+                throw std::runtime_error{"Texel buffer descriptors can't be packed from a DescriptorBinding!"};
+
+            if (isImageDescriptor(binding.Type))
+                memcpy(data.data() + offset, &binding.ImageInfo, sizeof(VkDescriptorImageInfo));
+            else
+                memcpy(data.data() + offset, &binding.BufferInfo, sizeof(VkDescriptorBufferInfo));
+
+            offset += getDescriptorDataStride(binding.Type);
+        }
+
+        return data;
+    }
+}
@@ -0,0 +1,337 @@
+#include "VulkanUtilities/DeviceCapabilities.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "VulkanUtilities/BindlessUtils.hpp"
+#include "VulkanUtilities/CullingUtils.hpp"
+#include "VulkanUtilities/DynamicState.hpp"
+#include "VulkanUtilities/PipelineLibrary.hpp"
+
+namespace VulkanUtilities {
+    // Bumped whenever the record layout changes, an old file just gets ignored (and rewritten)
+    static constexpr uint32_t CAPABILITY_CACHE_MAGIC   = 0x43445643; // "CVDC"
+    static constexpr uint32_t CAPABILITY_CACHE_VERSION = 2;
+
+    // A driver update can change any of it, so the driver version is part of the key
+    struct CapabilityCacheKey {
+        uint32_t VendorID;
+        uint32_t DeviceID;
+        uint32_t DriverVersion;
+        uint32_t ApiVersion;
+        uint8_t  PipelineCacheUUID[VK_UUID_SIZE];
+
+        bool operator==(const CapabilityCacheKey& other) const { return std::memcmp(this, &other, sizeof(CapabilityCacheKey)) == 0; }
+    };
+
+    struct CapabilityCacheHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t FeaturesSize; // The Vk structs get written as they are, so a header with other sizes is someone else's build
+        uint32_t MemoryPropertiesSize;
+        uint32_t QueueFamilySize;
+        uint32_t RecordCount;
+    };
+
+    struct CapabilityCacheRecord {
+        CapabilityCacheKey Key;
+        DeviceCapabilities Capabilities;
+    };
+
+    // FNV-1a, same as the pipeline descriptions
+    static uint64_t hashExtensionName(const std::string_view name) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+
+        for (const char c : name) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+
+        return hash;
+    }
+
+    static CapabilityCacheKey makeCacheKey(const VkPhysicalDeviceProperties& properties) {
+        CapabilityCacheKey key{};
+
+        key.VendorID      = properties.vendorID;
+        key.DeviceID      = properties.deviceID;
+        key.DriverVersion = properties.driverVersion;
+        key.ApiVersion    = properties.apiVersion;
+        std::memcpy(key.PipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        return key;
+    }
+
+    static CapabilityCacheHeader makeCacheHeader(const uint32_t record_count) {
+        return { CAPABILITY_CACHE_MAGIC, CAPABILITY_CACHE_VERSION, sizeof(VkPhysicalDeviceFeatures), sizeof(VkPhysicalDeviceMemoryProperties), sizeof(VkQueueFamilyProperties), record_count };
+    }
+
+    template <typename T>
+    static bool readValue(std::ifstream& file, T& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template <typename T>
+    static bool readVector(std::ifstream& file, std::vector<T>& values) {
+        uint32_t count = 0;
+
+        // Anything bigger than this is a broken file, not a device with that many queue families/extensions
+        if (!readValue(file, count) || count > 4096)
+            return false;
+
+        values.resize(count);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T))));
+    }
+
+    template <typename T>
+    static void writeValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static void writeVector(std::ofstream& file, const std::vector<T>& values) {
+        writeValue(file, static_cast<uint32_t>(values.size()));
+        file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    // A missing, stale or broken file is just an empty cache
+    static std::vector<CapabilityCacheRecord> readCapabilityCache(const std::string& path) {
+        std::ifstream file{path, std::ios::binary};
+
+        if (!file.is_open())
+            return {};
+
+        CapabilityCacheHeader header{};
+        const CapabilityCacheHeader expected = makeCacheHeader(0);
+
+        if (!readValue(file, header) || header.Magic != expected.Magic || header.Version != expected.Version ||
+            header.FeaturesSize != expected.FeaturesSize || header.MemoryPropertiesSize != expected.MemoryPropertiesSize || header.QueueFamilySize != expected.QueueFamilySize)
+            return {};
+
+        std::vector<CapabilityCacheRecord> records{header.RecordCount};
+
+        for (auto& [key, capabilities] : records) {
+            uint8_t descriptor_indexing       = 0;
+            uint8_t draw_indirect_count       = 0;
+            uint8_t graphics_pipeline_library = 0;
+
+            const bool read = readValue(file, key)
+                && readValue(file, capabilities.Features)
+                && readValue(file, capabilities.MemoryProperties)
+                && readVector(file, capabilities.QueueFamilies)
+                && readVector(file, capabilities.Extensions)
+                && readValue(file, descriptor_indexing)
+                && readValue(file, draw_indirect_count)
+                && readValue(file, graphics_pipeline_library)
+                && readValue(file, capabilities.DynamicPipelineState);
+
+            if (!read)
+                return {};
+
+            capabilities.DescriptorIndexing      = descriptor_indexing != 0;
+            capabilities.DrawIndirectCount       = draw_indirect_count != 0;
+            capabilities.GraphicsPipelineLibrary = graphics_pipeline_library != 0;
+        }
+
+        return records;
+    }
+
+    // Failing to write is fine, next run just queries everything again
+    static void writeCapabilityCache(const std::string& path, const std::vector<CapabilityCacheRecord>& records) {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+
+        if (!file.is_open())
+            return;
+
+        writeValue(file, makeCacheHeader(static_cast<uint32_t>(records.size())));
+
+        for (const auto& [key, capabilities] : records) {
+            writeValue(file, key);
+            writeValue(file, capabilities.Features);
+            writeValue(file, capabilities.MemoryProperties);
+            writeVector(file, capabilities.QueueFamilies);
+            writeVector(file, capabilities.Extensions);
+            writeValue(file, static_cast<uint8_t>(capabilities.DescriptorIndexing));
+            writeValue(file, static_cast<uint8_t>(capabilities.DrawIndirectCount));
+            writeValue(file, static_cast<uint8_t>(capabilities.GraphicsPipelineLibrary));
+            writeValue(file, capabilities.DynamicPipelineState);
+        }
+    }
+
+    // Every optional feature struct goes in one vkGetPhysicalDeviceFeatures2 chain, checked against the extensions that were already enumerated
+    //  . Structs for extensions the device doesn't have can't go in the chain, they stay zeroed (so unsupported)
+    //  . vkGetPhysicalDeviceFeatures2 is core in 1.1, a 1.0 device gets none of them (the instance doesn't enable the KHR version)
+    static void queryOptionalFeatures(DeviceCapabilities& capabilities) {
+        const bool descriptor_indexing_available       = hasDeviceExtension(capabilities, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        const bool draw_indirect_count_available       = hasDeviceExtension(capabilities, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+        const bool graphics_pipeline_library_available = hasDeviceExtension(capabilities, VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) && hasDeviceExtension(capabilities, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+        const bool dynamic_state_available             = hasDeviceExtension(capabilities, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+        const bool dynamic_state_3_available           = hasDeviceExtension(capabilities, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing_features{};
+        indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+        VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT library_features{};
+        library_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+
+        VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamic_state_features{};
+        dynamic_state_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+
+        VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state_3_features{};
+        dynamic_state_3_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+
+        void* feature_chain = nullptr;
+
+        const auto chain = [&feature_chain](const bool available, auto& features) {
+            if (!available)
+                return;
+
+            features.pNext = feature_chain;
+            feature_chain  = &features;
+        };
+
+        chain(descriptor_indexing_available,       indexing_features);
+        chain(graphics_pipeline_library_available, library_features);
+        chain(dynamic_state_available,             dynamic_state_features);
+        chain(dynamic_state_3_available,           dynamic_state_3_features);
+
+        if (feature_chain != nullptr && capabilities.Properties.apiVersion >= VK_API_VERSION_1_1) {
+            VkPhysicalDeviceFeatures2 features{};
+            features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features.pNext = feature_chain;
+
+            vkGetPhysicalDeviceFeatures2(capabilities.Device, &features);
+        }
+
+        capabilities.DescriptorIndexing      = descriptor_indexing_available       && isDescriptorIndexingSupported(indexing_features);
+        capabilities.DrawIndirectCount       = draw_indirect_count_available       && isDrawIndirectCountSupported(capabilities.Features);
+        capabilities.GraphicsPipelineLibrary = graphics_pipeline_library_available && isGraphicsPipelineLibrarySupported(library_features);
+        capabilities.DynamicPipelineState    = getDynamicPipelineStateSupport(dynamic_state_features, dynamic_state_3_features);
+    }
+
+    // Everything that doesn't depend on the surface, what the disk cache saves
+    static void queryDeviceIndependentCapabilities(DeviceCapabilities& capabilities) {
+        const VkPhysicalDevice device = capabilities.Device;
+
+        vkGetPhysicalDeviceFeatures(device, &capabilities.Features);
+        vkGetPhysicalDeviceMemoryProperties(device, &capabilities.MemoryProperties);
+
+        uint32_t queue_count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_count, nullptr);
+
+        capabilities.QueueFamilies.resize(queue_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_count, capabilities.QueueFamilies.data());
+
+        uint32_t extension_count = 0;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+
+        std::vector<VkExtensionProperties> extensions{extension_count};
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, extensions.data());
+
+        capabilities.Extensions.clear();
+        capabilities.Extensions.reserve(extension_count);
+
+        for (const auto& extension : extensions)
+            capabilities.Extensions.push_back(hashExtensionName(extension.extensionName));
+
+        std::ranges::sort(capabilities.Extensions);
+
+        queryOptionalFeatures(capabilities);
+    }
+
+    static void querySurfaceCapabilities(DeviceCapabilities& capabilities, const VkSurfaceKHR surface) {
+        const VkPhysicalDevice device = capabilities.Device;
+
+        capabilities.PresentSupport.assign(capabilities.QueueFamilies.size(), VK_FALSE);
+
+        for (uint32_t i = 0; i < capabilities.QueueFamilies.size(); i++)
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &capabilities.PresentSupport[i]);
+
+        uint32_t format_count = 0;
+        vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &format_count, nullptr);
+
+        capabilities.SurfaceFormats.resize(format_count);
+        vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &format_count, capabilities.SurfaceFormats.data());
+
+        uint32_t present_count = 0;
+        vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &present_count, nullptr);
+
+        capabilities.PresentModes.resize(present_count);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &present_count, capabilities.PresentModes.data());
+    }
+
+    DeviceCapabilityDatabase queryDeviceCapabilities(const VkInstance instance, const VkSurfaceKHR surface, const std::string& cache_path) {
+        const auto start = std::chrono::steady_clock::now();
+
+        DeviceCapabilityDatabase database{};
+
+        uint32_t device_count = 0;
+        vkEnumeratePhysicalDevices(instance, &device_count, nullptr);
+
+        std::vector<VkPhysicalDevice> devices{device_count};
+        vkEnumeratePhysicalDevices(instance, &device_count, devices.data());
+
+        std::vector<CapabilityCacheRecord> records;
+
+        if (!cache_path.empty())
+            records = readCapabilityCache(cache_path);
+
+        database.Devices.resize(device_count);
+
+        for (uint32_t i = 0; i < device_count; i++) {
+            DeviceCapabilities& capabilities = database.Devices[i];
+
+            capabilities.Device = devices[i];
+
+            // Needed for the key anyway, and it's the one query that's cheap
+            vkGetPhysicalDeviceProperties(devices[i], &capabilities.Properties);
+
+            const CapabilityCacheKey key = makeCacheKey(capabilities.Properties);
+
+            const auto cached = std::ranges::find(records, key, &CapabilityCacheRecord::Key);
+
+            if (cached != records.end()) {
+                const VkPhysicalDeviceProperties properties = capabilities.Properties;
+
+                capabilities               = cached->Capabilities;
+                capabilities.Device        = devices[i];
+                capabilities.Properties    = properties;
+                capabilities.FromDiskCache = true;
+
+                database.DiskHits++;
+            } else {
+                queryDeviceIndependentCapabilities(capabilities);
+
+                if (!cache_path.empty()) {
+                    records.push_back({ key, capabilities });
+                    database.DiskMisses++;
+                }
+            }
+
+            querySurfaceCapabilities(capabilities, surface);
+        }
+
+        if (database.DiskMisses > 0)
+            writeCapabilityCache(cache_path, records);
+
+        database.QueryMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        return database;
+    }
+
+    const DeviceCapabilities& getDeviceCapabilities(const DeviceCapabilityDatabase& database, const VkPhysicalDevice device) {
+        const auto found = std::ranges::find(database.Devices, device, &DeviceCapabilities::Device);
+
+        if (found == database.Devices.end())
+            throw std::runtime_error{"No capabilities were queried for this physical device!"};
+
+        return *found;
+    }
+
+    bool hasDeviceExtension(const DeviceCapabilities& capabilities, const std::string_view name) {
+        return std::ranges::binary_search(capabilities.Extensions, hashExtensionName(name));
+    }
+}
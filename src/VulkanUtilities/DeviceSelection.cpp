@@ -0,0 +1,134 @@
+#include "VulkanUtilities/DeviceSelection.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace VulkanUtilities {
+    static uint32_t getDeviceTypeRank(const VkPhysicalDeviceType type) {
+        switch (type) {
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return 4;
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 3;
+            case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return 2;
+            case VK_PHYSICAL_DEVICE_TYPE_CPU:            return 1; // Software rasterizers (lavapipe, SwiftShader), only if there's nothing else
+            default:                                     return 0;
+        }
+    }
+
+    static uint64_t getLargestLocalHeapMB(const VkPhysicalDevice device) {
+        VkPhysicalDeviceMemoryProperties memory_properties;
+        vkGetPhysicalDeviceMemoryProperties(device, &memory_properties);
+
+        VkDeviceSize largest = 0;
+
+        for (uint32_t i = 0; i < memory_properties.memoryHeapCount; i++)
+            if (memory_properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                largest = std::max(largest, memory_properties.memoryHeaps[i].size);
+
+        return largest / (1024 * 1024);
+    }
+
+    std::vector<PhysicalDeviceCandidate> rankPhysicalDevices(
+        const VkInstance                                  instance,
+        const std::function<bool(VkPhysicalDevice)>&     is_suitable,
+        const std::function<uint32_t(VkPhysicalDevice)>& count_optional_features
+    ) {
+        uint32_t device_count = 0;
+        vkEnumeratePhysicalDevices(instance, &device_count, nullptr);
+
+        std::vector<VkPhysicalDevice> devices{device_count};
+        vkEnumeratePhysicalDevices(instance, &device_count, devices.data());
+
+        std::vector<PhysicalDeviceCandidate> candidates;
+        candidates.reserve(device_count);
+
+        for (uint32_t i = 0; i < device_count; i++) {
+            // The UUID is the only thing that tells two of the same card apart
+            //  . It needs vkGetPhysicalDeviceProperties2 (core in 1.1), a 1.0 device just gets a zeroed one
+            VkPhysicalDeviceIDProperties id_properties{};
+            id_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+            VkPhysicalDeviceProperties2 properties{};
+            properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+
+            vkGetPhysicalDeviceProperties(devices[i], &properties.properties);
+
+            if (properties.properties.apiVersion >= VK_API_VERSION_1_1) {
+                properties.pNext = &id_properties;
+                vkGetPhysicalDeviceProperties2(devices[i], &properties);
+            }
+
+            PhysicalDeviceCandidate candidate{};
+
+            candidate.Device   = devices[i];
+            candidate.Index    = i;
+            candidate.Name     = properties.properties.deviceName;
+            candidate.Uuid     = formatDeviceUuid(id_properties.deviceUUID);
+            candidate.Type     = properties.properties.deviceType;
+            candidate.Suitable = is_suitable(devices[i]);
+
+            candidate.Score.TypeRank            = getDeviceTypeRank(candidate.Type);
+            candidate.Score.OptionalFeatures    = candidate.Suitable ? count_optional_features(devices[i]) : 0;
+            candidate.Score.LocalMemoryMB       = getLargestLocalHeapMB(devices[i]);
+            candidate.Score.MaxImageDimension2D = properties.properties.limits.maxImageDimension2D;
+
+            candidates.push_back(std::move(candidate));
+        }
+
+        std::ranges::stable_sort(candidates, [](const PhysicalDeviceCandidate& left, const PhysicalDeviceCandidate& right) {
+            if (left.Suitable != right.Suitable)
+                return left.Suitable;
+
+            return left.Score > right.Score;
+        });
+
+        return candidates;
+    }
+
+    std::string formatDeviceUuid(const uint8_t (&uuid)[VK_UUID_SIZE]) {
+        static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+        std::string formatted;
+        formatted.reserve(VK_UUID_SIZE * 2 + 4);
+
+        for (uint32_t i = 0; i < VK_UUID_SIZE; i++) {
+            if (i == 4 || i == 6 || i == 8 || i == 10)
+                formatted += '-';
+
+            formatted += HEX_DIGITS[uuid[i] >> 4];
+            formatted += HEX_DIGITS[uuid[i] & 0xF];
+        }
+
+        return formatted;
+    }
+
+    static std::string normalizeSelector(const std::string& text, const bool strip_dashes) {
+        std::string normalized;
+        normalized.reserve(text.size());
+
+        for (const char character : text)
+            if (!(strip_dashes && character == '-'))
+                normalized += static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+
+        return normalized;
+    }
+
+    bool matchesDeviceSelector(const PhysicalDeviceCandidate& candidate, const std::string& selector) {
+        if (selector.empty())
+            return false;
+
+        if (normalizeSelector(candidate.Uuid, true) == normalizeSelector(selector, true))
+            return true;
+
+        return normalizeSelector(candidate.Name, false).find(normalizeSelector(selector, false)) != std::string::npos;
+    }
+
+    const char* getDeviceTypeName(const VkPhysicalDeviceType type) {
+        switch (type) {
+            case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   return "discrete";
+            case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return "integrated";
+            case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    return "virtual";
+            case VK_PHYSICAL_DEVICE_TYPE_CPU:            return "cpu";
+            default:                                     return "other";
+        }
+    }
+}
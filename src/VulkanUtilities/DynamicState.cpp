@@ -0,0 +1,82 @@
+#include "VulkanUtilities/DynamicState.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace VulkanUtilities {
+    uint32_t getDynamicPipelineStateSupport(const VkPhysicalDeviceExtendedDynamicStateFeaturesEXT& dynamic_state_features, const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT& dynamic_state_3_features) {
+        uint32_t supported = 0;
+
+        if (dynamic_state_features.extendedDynamicState)
+            supported |= DYNAMIC_PIPELINE_STATE_RASTERIZATION | DYNAMIC_PIPELINE_STATE_DEPTH;
+
+        if (dynamic_state_3_features.extendedDynamicState3ColorBlendEnable && dynamic_state_3_features.extendedDynamicState3ColorWriteMask)
+            supported |= DYNAMIC_PIPELINE_STATE_BLEND;
+
+        return supported;
+    }
+
+    void populateExtendedDynamicStateFeatures(VkPhysicalDeviceExtendedDynamicStateFeaturesEXT& features) {
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+
+        features.extendedDynamicState = VK_TRUE;
+    }
+
+    void populateExtendedDynamicState3Features(VkPhysicalDeviceExtendedDynamicState3FeaturesEXT& features) {
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+
+        features.extendedDynamicState3ColorBlendEnable = VK_TRUE;
+        features.extendedDynamicState3ColorWriteMask   = VK_TRUE;
+    }
+
+    template <typename Function>
+    static void loadCommand(const VkDevice device, Function& function, const char* name) {
+        function = reinterpret_cast<Function>(vkGetDeviceProcAddr(device, name));
+
+        if (function == nullptr)
+            throw std::runtime_error{std::string{"Failed to load "} + name + "!"};
+    }
+
+    DynamicStateCommands loadDynamicStateCommands(const VkDevice device, const uint32_t dynamic_state) {
+        DynamicStateCommands commands{};
+
+        if (dynamic_state & DYNAMIC_PIPELINE_STATE_RASTERIZATION) {
+            loadCommand(device, commands.SetPrimitiveTopology, "vkCmdSetPrimitiveTopologyEXT");
+            loadCommand(device, commands.SetCullMode,          "vkCmdSetCullModeEXT");
+            loadCommand(device, commands.SetFrontFace,         "vkCmdSetFrontFaceEXT");
+        }
+
+        if (dynamic_state & DYNAMIC_PIPELINE_STATE_DEPTH) {
+            loadCommand(device, commands.SetDepthTestEnable,  "vkCmdSetDepthTestEnableEXT");
+            loadCommand(device, commands.SetDepthWriteEnable, "vkCmdSetDepthWriteEnableEXT");
+            loadCommand(device, commands.SetDepthCompareOp,   "vkCmdSetDepthCompareOpEXT");
+        }
+
+        if (dynamic_state & DYNAMIC_PIPELINE_STATE_BLEND) {
+            loadCommand(device, commands.SetColorBlendEnable, "vkCmdSetColorBlendEnableEXT");
+            loadCommand(device, commands.SetColorWriteMask,   "vkCmdSetColorWriteMaskEXT");
+        }
+
+        return commands;
+    }
+
+    void cmdSetFixedFunctionState(const DynamicStateCommands& commands, const VkCommandBuffer buffer, const uint32_t dynamic_state, const FixedFunctionState& state) {
+        if (dynamic_state & DYNAMIC_PIPELINE_STATE_RASTERIZATION) {
+            commands.SetPrimitiveTopology(buffer, state.Topology);
+            commands.SetCullMode(buffer, state.CullMode);
+            commands.SetFrontFace(buffer, state.FrontFace);
+        }
+
+        if (dynamic_state & DYNAMIC_PIPELINE_STATE_DEPTH) {
+            commands.SetDepthTestEnable(buffer, state.DepthTest);
+            commands.SetDepthWriteEnable(buffer, state.DepthWrite);
+            commands.SetDepthCompareOp(buffer, state.DepthCompare);
+        }
+
+        // The scene render passes only have the one color attachment
+        if (dynamic_state & DYNAMIC_PIPELINE_STATE_BLEND) {
+            commands.SetColorBlendEnable(buffer, 0, 1, &state.BlendEnable);
+            commands.SetColorWriteMask(buffer, 0, 1, &state.ColorWriteMask);
+        }
+    }
+}
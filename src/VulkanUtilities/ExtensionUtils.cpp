@@ -26,4 +26,71 @@ namespace VulkanUtilities {
         if (func != nullptr)
             func(instance, debug_messenger, allocator);
     }
+
+    // Labels get recorded every frame, so these are looked up once instead of on every call like the ones above
+    static PFN_vkSetDebugUtilsObjectNameEXT set_debug_utils_object_name = nullptr;
+    static PFN_vkCmdBeginDebugUtilsLabelEXT cmd_begin_debug_utils_label = nullptr;
+    static PFN_vkCmdEndDebugUtilsLabelEXT   cmd_end_debug_utils_label   = nullptr;
+
+    void loadDebugUtilsFunctions(const VkInstance instance) {
+        set_debug_utils_object_name = reinterpret_cast<PFN_vkSetDebugUtilsObjectNameEXT>(vkGetInstanceProcAddr(instance, "vkSetDebugUtilsObjectNameEXT"));
+        cmd_begin_debug_utils_label = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(vkGetInstanceProcAddr(instance, "vkCmdBeginDebugUtilsLabelEXT"));
+        cmd_end_debug_utils_label   = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(vkGetInstanceProcAddr(instance, "vkCmdEndDebugUtilsLabelEXT"));
+    }
+
+    void setDebugUtilsObjectNameEXT(
+        const VkDevice     device,
+        const VkObjectType object_type,
+        const uint64_t     object_handle,
+        const char*        name
+    ) {
+        if (set_debug_utils_object_name == nullptr || object_handle == 0)
+            return;
+
+        VkDebugUtilsObjectNameInfoEXT name_info{};
+
+        name_info.sType        = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+        name_info.objectType   = object_type;
+        name_info.objectHandle = object_handle;
+        name_info.pObjectName  = name;
+
+        set_debug_utils_object_name(device, &name_info);
+    }
+
+    void cmdBeginDebugUtilsLabelEXT(const VkCommandBuffer command_buffer, const char* name) {
+        if (cmd_begin_debug_utils_label == nullptr)
+            return;
+
+        VkDebugUtilsLabelEXT label{};
+
+        label.sType      = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+        label.pLabelName = name;
+
+        cmd_begin_debug_utils_label(command_buffer, &label);
+    }
+
+    void cmdEndDebugUtilsLabelEXT(const VkCommandBuffer command_buffer) {
+        if (cmd_end_debug_utils_label != nullptr)
+            cmd_end_debug_utils_label(command_buffer);
+    }
+
+    // Commands
+    static PFN_vkCmdDrawIndexedIndirectCountKHR cmd_draw_indexed_indirect_count = nullptr;
+
+    void loadDrawIndirectCountFunctions(const VkDevice device) {
+        cmd_draw_indexed_indirect_count = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCountKHR"));
+    }
+
+    void cmdDrawIndexedIndirectCountKHR(
+        VkCommandBuffer command_buffer,
+        VkBuffer        buffer,
+        VkDeviceSize    offset,
+        VkBuffer        count_buffer,
+        VkDeviceSize    count_buffer_offset,
+        uint32_t        max_draw_count,
+        uint32_t        stride
+    ) {
+        if (cmd_draw_indexed_indirect_count != nullptr)
+            cmd_draw_indexed_indirect_count(command_buffer, buffer, offset, count_buffer, count_buffer_offset, max_draw_count, stride);
+    }
 }
\ No newline at end of file
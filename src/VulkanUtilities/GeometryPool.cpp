@@ -0,0 +1,346 @@
+#include "VulkanUtilities/GeometryPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "VulkanUtilities/BufferUtils.hpp"
+#include "VulkanUtilities/HostAllocator.hpp"
+
+namespace VulkanUtilities {
+    RangeAllocator createRangeAllocator(const uint32_t capacity) {
+        RangeAllocator allocator{};
+
+        allocator.Capacity = capacity;
+        allocator.FreeRanges.push_back({ 0, capacity });
+
+        return allocator;
+    }
+
+    uint32_t allocateRange(RangeAllocator& allocator, const uint32_t count) {
+        if (count == 0)
+            return 0;
+
+        for (auto range = allocator.FreeRanges.begin(); range != allocator.FreeRanges.end(); ++range) {
+            if (range->Count < count)
+                continue;
+
+            const uint32_t offset = range->Offset;
+
+            range->Offset += count;
+            range->Count  -= count;
+
+            if (range->Count == 0)
+                allocator.FreeRanges.erase(range);
+
+            allocator.Used += count;
+
+            return offset;
+        }
+
+        return INVALID_GEOMETRY_OFFSET;
+    }
+
+    void freeRange(RangeAllocator& allocator, const GeometryRange range) {
+        if (range.Count == 0)
+            return;
+
+        auto& free_ranges = allocator.FreeRanges;
+
+        const auto next = std::lower_bound(free_ranges.begin(), free_ranges.end(), range.Offset,
+            [](const GeometryRange& free_range, const uint32_t offset) { return free_range.Offset < offset; });
+
+        auto inserted = free_ranges.insert(next, range);
+
+        // Merge with the hole after, then the one before
+        if (const auto after = inserted + 1; after != free_ranges.end() && inserted->Offset + inserted->Count == after->Offset) {
+            inserted->Count += after->Count;
+            inserted = free_ranges.erase(after) - 1;
+        }
+
+        if (inserted != free_ranges.begin()) {
+            if (const auto before = inserted - 1; before->Offset + before->Count == inserted->Offset) {
+                before->Count += inserted->Count;
+                free_ranges.erase(inserted);
+            }
+        }
+
+        allocator.Used -= range.Count;
+    }
+
+    uint32_t getLargestFreeRange(const RangeAllocator& allocator) {
+        uint32_t largest = 0;
+
+        for (const auto& range : allocator.FreeRanges)
+            largest = std::max(largest, range.Count);
+
+        return largest;
+    }
+
+    static void createPoolBuffers(const VkDevice device, const VkPhysicalDevice physical_device, GeometryPool& pool) {
+        // TRANSFER_SRC so compaction can copy out of them
+        constexpr VkBufferUsageFlags transfer_usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+        createBuffer(device, physical_device, static_cast<VkDeviceSize>(pool.Vertices.Capacity) * pool.VertexStride, transfer_usage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pool.VertexBuffer, pool.VertexMemory);
+
+        createBuffer(device, physical_device, static_cast<VkDeviceSize>(pool.Indices.Capacity) * getIndexSize(pool.IndexType), transfer_usage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pool.IndexBuffer, pool.IndexMemory);
+
+        if (pool.PositionStride > 0)
+            createBuffer(device, physical_device, static_cast<VkDeviceSize>(pool.Vertices.Capacity) * pool.PositionStride, transfer_usage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pool.PositionBuffer, pool.PositionMemory);
+    }
+
+    static void destroyPoolBuffers(const VkDevice device, const GeometryPool& pool) {
+        vkDestroyBuffer(device, pool.VertexBuffer, getAllocationCallbacks());
+        vkFreeMemory(device, pool.VertexMemory, getAllocationCallbacks());
+        vkDestroyBuffer(device, pool.PositionBuffer, getAllocationCallbacks());
+        vkFreeMemory(device, pool.PositionMemory, getAllocationCallbacks());
+        vkDestroyBuffer(device, pool.IndexBuffer, getAllocationCallbacks());
+        vkFreeMemory(device, pool.IndexMemory, getAllocationCallbacks());
+    }
+
+    GeometryPool createGeometryPool(
+        const VkDevice         device,
+        const VkPhysicalDevice physical_device,
+        const uint32_t         vertex_stride,
+        const uint32_t         vertex_capacity,
+        const uint32_t         index_capacity,
+        const VkIndexType      index_type,
+        const uint32_t         position_stride
+    ) {
+        GeometryPool pool{};
+
+        pool.VertexStride   = vertex_stride;
+        pool.PositionStride = position_stride;
+        pool.IndexType      = index_type;
+        pool.Vertices       = createRangeAllocator(vertex_capacity);
+        pool.Indices        = createRangeAllocator(index_capacity);
+
+        createPoolBuffers(device, physical_device, pool);
+
+        return pool;
+    }
+
+    void destroyGeometryPool(const VkDevice device, GeometryPool& pool) {
+        destroyPoolBuffers(device, pool);
+
+        pool = {};
+    }
+
+    MeshHandle uploadMesh(
+        const VkDevice                   device,
+        const VkPhysicalDevice           physical_device,
+        const VkCommandPool              command_pool,
+        const VkQueue                    queue,
+        GeometryPool&                    pool,
+        const std::span<const std::byte> vertices,
+        const IndexData&                 indices,
+        const std::span<const std::byte> positions
+    ) {
+        if (indices.Type != pool.IndexType)
+            throw std::runtime_error{"Mesh indices don't match the geometry pool's index type!"};
+
+        if (vertices.size() % pool.VertexStride != 0)
+            throw std::runtime_error{"Mesh vertex data isn't a whole number of " + std::to_string(pool.VertexStride) + " byte vertices!"};
+
+        const uint32_t vertex_count = static_cast<uint32_t>(vertices.size() / pool.VertexStride);
+
+        if (pool.PositionStride == 0 && !positions.empty())
+            throw std::runtime_error{"Got a position stream for a geometry pool that isn't split!"};
+
+        if (pool.PositionStride > 0 && positions.size() != static_cast<size_t>(vertex_count) * pool.PositionStride)
+            throw std::runtime_error{"Mesh position stream doesn't match its vertex count (" + std::to_string(vertex_count) + " vertices)!"};
+
+        const uint32_t vertex_offset = allocateRange(pool.Vertices, vertex_count);
+        if (vertex_offset == INVALID_GEOMETRY_OFFSET)
+            throw std::runtime_error{"Geometry pool is out of vertex space (" + std::to_string(vertex_count) + " vertices requested)!"};
+
+        const uint32_t first_index = allocateRange(pool.Indices, indices.IndexCount);
+        if (first_index == INVALID_GEOMETRY_OFFSET) {
+            freeRange(pool.Vertices, { vertex_offset, vertex_count });
+            throw std::runtime_error{"Geometry pool is out of index space (" + std::to_string(indices.IndexCount) + " indices requested)!"};
+        }
+
+        // Everything goes through one staging buffer: vertices, then positions, then indices
+        const VkDeviceSize vertex_size   = vertices.size();
+        const VkDeviceSize position_size = positions.size();
+        const VkDeviceSize index_size    = indices.Data.size();
+        const VkDeviceSize staging_size  = vertex_size + position_size + index_size;
+
+        if (staging_size > 0) {
+            VkBuffer       staging_buffer;
+            VkDeviceMemory staging_memory;
+            createBuffer(device, physical_device, staging_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, staging_buffer, staging_memory);
+
+            void* mapped;
+            vkMapMemory(device, staging_memory, 0, staging_size, 0, &mapped);
+            memcpy(mapped, vertices.data(), vertex_size);
+            memcpy(static_cast<std::byte*>(mapped) + vertex_size, positions.data(), position_size);
+            memcpy(static_cast<std::byte*>(mapped) + vertex_size + position_size, indices.Data.data(), index_size);
+            vkUnmapMemory(device, staging_memory);
+
+            // One submit (and one wait) for every stream
+            const VkCommandBuffer command_buffer = beginSingleTimeCommands(device, command_pool);
+
+            if (vertex_size > 0)
+                cmdCopyBufferRegions(command_buffer, staging_buffer, pool.VertexBuffer, { { 0, static_cast<VkDeviceSize>(vertex_offset) * pool.VertexStride, vertex_size } });
+
+            if (position_size > 0)
+                cmdCopyBufferRegions(command_buffer, staging_buffer, pool.PositionBuffer, { { vertex_size, static_cast<VkDeviceSize>(vertex_offset) * pool.PositionStride, position_size } });
+
+            if (index_size > 0)
+                cmdCopyBufferRegions(command_buffer, staging_buffer, pool.IndexBuffer, { { vertex_size + position_size, static_cast<VkDeviceSize>(first_index) * getIndexSize(pool.IndexType), index_size } });
+
+            endSingleTimeCommands(device, command_pool, queue, command_buffer);
+
+            vkDestroyBuffer(device, staging_buffer, getAllocationCallbacks());
+            vkFreeMemory(device, staging_memory, getAllocationCallbacks());
+        }
+
+        MeshAllocation allocation{ { vertex_offset, vertex_count }, { first_index, indices.IndexCount }, indices.Chunks, true };
+
+        for (auto& chunk : allocation.Chunks) {
+            chunk.FirstIndex   += first_index;
+            chunk.VertexOffset += static_cast<int32_t>(vertex_offset);
+        }
+
+        if (!pool.FreeHandles.empty()) {
+            const MeshHandle handle = pool.FreeHandles.back();
+            pool.FreeHandles.pop_back();
+
+            pool.Meshes[handle] = std::move(allocation);
+
+            return handle;
+        }
+
+        pool.Meshes.push_back(std::move(allocation));
+
+        return static_cast<MeshHandle>(pool.Meshes.size() - 1);
+    }
+
+    void freeMesh(GeometryPool& pool, const MeshHandle mesh) {
+        if (mesh >= pool.Meshes.size() || !pool.Meshes[mesh].Live)
+            throw std::runtime_error{"Tried to free a mesh that isn't in the geometry pool!"};
+
+        MeshAllocation& allocation = pool.Meshes[mesh];
+
+        freeRange(pool.Vertices, allocation.Vertices);
+        freeRange(pool.Indices,  allocation.Indices);
+
+        allocation = {};
+        pool.FreeHandles.push_back(mesh);
+    }
+
+    void compactGeometryPool(
+        const VkDevice         device,
+        const VkPhysicalDevice physical_device,
+        const VkCommandPool    command_pool,
+        const VkQueue          queue,
+        GeometryPool&          pool
+    ) {
+        GeometryPool compacted{};
+
+        compacted.VertexStride   = pool.VertexStride;
+        compacted.PositionStride = pool.PositionStride;
+        compacted.IndexType      = pool.IndexType;
+        compacted.Vertices       = createRangeAllocator(pool.Vertices.Capacity);
+        compacted.Indices        = createRangeAllocator(pool.Indices.Capacity);
+
+        createPoolBuffers(device, physical_device, compacted);
+
+        const VkDeviceSize index_size = getIndexSize(pool.IndexType);
+
+        std::vector<VkBufferCopy> vertex_copies;
+        std::vector<VkBufferCopy> position_copies;
+        std::vector<VkBufferCopy> index_copies;
+
+        // Live meshes keep their relative order, so it's just sliding everything down over the holes
+        std::vector<MeshHandle> live_meshes;
+        for (MeshHandle handle = 0; handle < pool.Meshes.size(); handle++)
+            if (pool.Meshes[handle].Live)
+                live_meshes.push_back(handle);
+
+        std::ranges::sort(live_meshes, {}, [&](const MeshHandle handle) { return pool.Meshes[handle].Vertices.Offset; });
+
+        for (const MeshHandle handle : live_meshes) {
+            MeshAllocation& allocation = pool.Meshes[handle];
+
+            const uint32_t vertex_offset = allocateRange(compacted.Vertices, allocation.Vertices.Count);
+            const uint32_t first_index   = allocateRange(compacted.Indices,  allocation.Indices.Count);
+
+            if (allocation.Vertices.Count > 0)
+                vertex_copies.push_back({
+                    static_cast<VkDeviceSize>(allocation.Vertices.Offset) * pool.VertexStride,
+                    static_cast<VkDeviceSize>(vertex_offset) * pool.VertexStride,
+                    static_cast<VkDeviceSize>(allocation.Vertices.Count) * pool.VertexStride
+                });
+
+            if (allocation.Vertices.Count > 0 && pool.PositionStride > 0)
+                position_copies.push_back({
+                    static_cast<VkDeviceSize>(allocation.Vertices.Offset) * pool.PositionStride,
+                    static_cast<VkDeviceSize>(vertex_offset) * pool.PositionStride,
+                    static_cast<VkDeviceSize>(allocation.Vertices.Count) * pool.PositionStride
+                });
+
+            if (allocation.Indices.Count > 0)
+                index_copies.push_back({
+                    allocation.Indices.Offset * index_size,
+                    first_index * index_size,
+                    allocation.Indices.Count * index_size
+                });
+
+            for (auto& chunk : allocation.Chunks) {
+                chunk.FirstIndex   = chunk.FirstIndex - allocation.Indices.Offset + first_index;
+                chunk.VertexOffset = chunk.VertexOffset - static_cast<int32_t>(allocation.Vertices.Offset) + static_cast<int32_t>(vertex_offset);
+            }
+
+            allocation.Vertices.Offset = vertex_offset;
+            allocation.Indices.Offset  = first_index;
+        }
+
+        // Every buffer in one submit, the old ones can't go before it's done anyway
+        const VkCommandBuffer command_buffer = beginSingleTimeCommands(device, command_pool);
+
+        cmdCopyBufferRegions(command_buffer, pool.VertexBuffer, compacted.VertexBuffer, vertex_copies);
+        cmdCopyBufferRegions(command_buffer, pool.IndexBuffer,  compacted.IndexBuffer,  index_copies);
+
+        if (pool.PositionStride > 0)
+            cmdCopyBufferRegions(command_buffer, pool.PositionBuffer, compacted.PositionBuffer, position_copies);
+
+        endSingleTimeCommands(device, command_pool, queue, command_buffer);
+
+        destroyPoolBuffers(device, pool);
+
+        pool.VertexBuffer   = compacted.VertexBuffer;
+        pool.VertexMemory   = compacted.VertexMemory;
+        pool.PositionBuffer = compacted.PositionBuffer;
+        pool.PositionMemory = compacted.PositionMemory;
+        pool.IndexBuffer    = compacted.IndexBuffer;
+        pool.IndexMemory    = compacted.IndexMemory;
+        pool.Vertices       = std::move(compacted.Vertices);
+        pool.Indices        = std::move(compacted.Indices);
+    }
+
+    void bindGeometryPool(const VkCommandBuffer command_buffer, const GeometryPool& pool) {
+        if (pool.PositionStride > 0) {
+            const VkBuffer     buffers[] = { pool.PositionBuffer, pool.VertexBuffer };
+            const VkDeviceSize offsets[] = { 0, 0 };
+
+            vkCmdBindVertexBuffers(command_buffer, 0, 2, buffers, offsets);
+        } else {
+            const VkDeviceSize offset = 0;
+
+            vkCmdBindVertexBuffers(command_buffer, 0, 1, &pool.VertexBuffer, &offset);
+        }
+
+        vkCmdBindIndexBuffer(command_buffer, pool.IndexBuffer, 0, pool.IndexType);
+    }
+
+    void drawMesh(const VkCommandBuffer command_buffer, const GeometryPool& pool, const MeshHandle mesh, const uint32_t instance_count, const uint32_t first_instance) {
+        for (const auto& chunk : pool.Meshes[mesh].Chunks)
+            vkCmdDrawIndexed(command_buffer, chunk.IndexCount, instance_count, chunk.FirstIndex, chunk.VertexOffset, first_instance);
+    }
+}
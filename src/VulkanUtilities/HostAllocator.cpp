@@ -0,0 +1,220 @@
+#include "VulkanUtilities/HostAllocator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace VulkanUtilities {
+    struct HostArena {
+        std::unique_ptr<std::byte[]> Memory; // Allocated the first time the thread needs it
+        size_t                       Offset = 0;
+        std::atomic<uint32_t>        Live   = 0; // Only rewound while this is 0, a free can (in theory) come from another thread
+    };
+
+    // Sits right in front of every pointer handed to the driver
+    struct AllocationHeader {
+        void*      Block; // What to hand back to std::free(), null for arena allocations
+        HostArena* Arena;
+        size_t     Size;
+        uint32_t   Scope;
+    };
+
+    struct AtomicScopeStatistics {
+        std::atomic<uint64_t> Allocations      = 0;
+        std::atomic<uint64_t> ArenaAllocations = 0;
+        std::atomic<uint64_t> Frees            = 0;
+        std::atomic<uint64_t> TotalBytes       = 0;
+        std::atomic<uint64_t> LiveBytes        = 0;
+        std::atomic<uint64_t> PeakLiveBytes    = 0;
+    };
+
+    static std::array<AtomicScopeStatistics, HOST_ALLOCATION_SCOPE_COUNT> scope_statistics;
+    static std::atomic<uint64_t>                                          internal_allocations = 0;
+    static std::atomic<uint64_t>                                          internal_bytes       = 0;
+
+    static thread_local HostArena thread_arena;
+
+    static VkAllocationCallbacks allocation_callbacks{};
+    static bool                  host_allocator_enabled = false;
+
+    static uint32_t getScopeIndex(const VkSystemAllocationScope scope) {
+        return std::min(static_cast<uint32_t>(scope), HOST_ALLOCATION_SCOPE_COUNT - 1);
+    }
+
+    static std::byte* alignUp(std::byte* pointer, const size_t alignment) {
+        const auto address = reinterpret_cast<uintptr_t>(pointer);
+        return pointer + ((alignment - address % alignment) % alignment);
+    }
+
+    static void countAllocation(const uint32_t scope, const size_t size, const bool arena) {
+        auto& statistics = scope_statistics[scope];
+
+        statistics.Allocations.fetch_add(1, std::memory_order_relaxed);
+        statistics.TotalBytes.fetch_add(size, std::memory_order_relaxed);
+
+        if (arena)
+            statistics.ArenaAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        const uint64_t live = statistics.LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+        uint64_t peak = statistics.PeakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak && !statistics.PeakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+
+    static void* allocateFromArena(const size_t size, const size_t alignment) {
+        HostArena& arena = thread_arena;
+
+        if (!arena.Memory)
+            arena.Memory = std::make_unique<std::byte[]>(HOST_ARENA_SIZE);
+
+        if (arena.Live.load(std::memory_order_acquire) == 0)
+            arena.Offset = 0;
+
+        std::byte* const start = arena.Memory.get() + arena.Offset;
+        std::byte* const user  = alignUp(start + sizeof(AllocationHeader), alignment);
+
+        if (user + size > arena.Memory.get() + HOST_ARENA_SIZE)
+            return nullptr;
+
+        arena.Offset = static_cast<size_t>(user + size - arena.Memory.get());
+        arena.Live.fetch_add(1, std::memory_order_relaxed);
+
+        new (user - sizeof(AllocationHeader)) AllocationHeader{ nullptr, &arena, size, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND };
+
+        return user;
+    }
+
+    static void* allocateFromHeap(const size_t size, const size_t alignment, const uint32_t scope) {
+        void* const block = std::malloc(size + sizeof(AllocationHeader) + alignment);
+
+        if (!block)
+            return nullptr;
+
+        std::byte* const user = alignUp(static_cast<std::byte*>(block) + sizeof(AllocationHeader), alignment);
+
+        new (user - sizeof(AllocationHeader)) AllocationHeader{ block, nullptr, size, scope };
+
+        return user;
+    }
+
+    static AllocationHeader* getHeader(void* memory) {
+        return reinterpret_cast<AllocationHeader*>(static_cast<std::byte*>(memory) - sizeof(AllocationHeader));
+    }
+
+    static void* VKAPI_CALL hostAllocation(void*, const size_t size, const size_t alignment, const VkSystemAllocationScope scope) {
+        const uint32_t scope_index = getScopeIndex(scope);
+
+        // The header has to stay aligned too, so nothing goes below its alignment
+        const size_t actual_alignment = std::max(alignment, alignof(AllocationHeader));
+
+        void* memory = nullptr;
+
+        if (scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND)
+            memory = allocateFromArena(size, actual_alignment);
+
+        const bool arena = memory != nullptr;
+
+        if (!memory)
+            memory = allocateFromHeap(size, actual_alignment, scope_index);
+
+        if (memory)
+            countAllocation(scope_index, size, arena);
+
+        return memory;
+    }
+
+    static void VKAPI_CALL hostFree(void*, void* memory) {
+        if (!memory)
+            return;
+
+        const AllocationHeader header = *getHeader(memory);
+
+        auto& statistics = scope_statistics[header.Scope];
+
+        statistics.Frees.fetch_add(1, std::memory_order_relaxed);
+        statistics.LiveBytes.fetch_sub(header.Size, std::memory_order_relaxed);
+
+        if (header.Arena)
+            header.Arena->Live.fetch_sub(1, std::memory_order_release);
+        else
+            std::free(header.Block);
+    }
+
+    static void* VKAPI_CALL hostReallocation(void* user_data, void* original, const size_t size, const size_t alignment, const VkSystemAllocationScope scope) {
+        if (!original)
+            return hostAllocation(user_data, size, alignment, scope);
+
+        if (size == 0) {
+            hostFree(user_data, original);
+            return nullptr;
+        }
+
+        void* const memory = hostAllocation(user_data, size, alignment, scope);
+
+        // The original has to stay untouched when this fails
+        if (!memory)
+            return nullptr;
+
+        std::memcpy(memory, original, std::min(size, getHeader(original)->Size));
+        hostFree(user_data, original);
+
+        return memory;
+    }
+
+    static void VKAPI_CALL notifyInternalAllocation(void*, const size_t size, VkInternalAllocationType, VkSystemAllocationScope) {
+        internal_allocations.fetch_add(1, std::memory_order_relaxed);
+        internal_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    static void VKAPI_CALL notifyInternalFree(void*, size_t, VkInternalAllocationType, VkSystemAllocationScope) {}
+
+    void enableHostAllocator() {
+        allocation_callbacks.pUserData             = nullptr;
+        allocation_callbacks.pfnAllocation         = hostAllocation;
+        allocation_callbacks.pfnReallocation       = hostReallocation;
+        allocation_callbacks.pfnFree               = hostFree;
+        allocation_callbacks.pfnInternalAllocation = notifyInternalAllocation;
+        allocation_callbacks.pfnInternalFree       = notifyInternalFree;
+
+        host_allocator_enabled = true;
+    }
+
+    const VkAllocationCallbacks* getAllocationCallbacks() {
+        return host_allocator_enabled ? &allocation_callbacks : nullptr;
+    }
+
+    HostAllocatorStatistics getHostAllocatorStatistics() {
+        HostAllocatorStatistics statistics{};
+
+        for (uint32_t scope = 0; scope < HOST_ALLOCATION_SCOPE_COUNT; scope++) {
+            const auto& source      = scope_statistics[scope];
+            auto&       destination = statistics.Scopes[scope];
+
+            destination.Allocations      = source.Allocations.load(std::memory_order_relaxed);
+            destination.ArenaAllocations = source.ArenaAllocations.load(std::memory_order_relaxed);
+            destination.Frees            = source.Frees.load(std::memory_order_relaxed);
+            destination.TotalBytes       = source.TotalBytes.load(std::memory_order_relaxed);
+            destination.LiveBytes        = source.LiveBytes.load(std::memory_order_relaxed);
+            destination.PeakLiveBytes    = source.PeakLiveBytes.load(std::memory_order_relaxed);
+        }
+
+        statistics.InternalAllocations = internal_allocations.load(std::memory_order_relaxed);
+        statistics.InternalBytes       = internal_bytes.load(std::memory_order_relaxed);
+
+        return statistics;
+    }
+
+    const char* getAllocationScopeName(const VkSystemAllocationScope scope) {
+        switch (scope) {
+            case VK_SYSTEM_ALLOCATION_SCOPE_COMMAND:  return "command";
+            case VK_SYSTEM_ALLOCATION_SCOPE_OBJECT:   return "object";
+            case VK_SYSTEM_ALLOCATION_SCOPE_CACHE:    return "cache";
+            case VK_SYSTEM_ALLOCATION_SCOPE_DEVICE:   return "device";
+            case VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE: return "instance";
+            default:                                  return "unknown";
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include "VulkanUtilities/ImageUtils.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "VulkanUtilities/BufferUtils.hpp"
+#include "VulkanUtilities/HostAllocator.hpp"
+
+namespace VulkanUtilities {
+    void createImage(
+        const VkDevice              device,
+        const VkPhysicalDevice      physical_device,
+        const uint32_t              width,
+        const uint32_t              height,
+        const uint32_t              mip_levels,
+        const VkFormat              format,
+        const VkImageUsageFlags     usage_flags,
+        const VkMemoryPropertyFlags property_flags,
+        VkImage&                    image,
+        VkDeviceMemory&             memory
+    ) {
+        VkImageCreateInfo create_info{};
+
+        create_info.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        create_info.imageType     = VK_IMAGE_TYPE_2D;
+        create_info.extent.width  = width;
+        create_info.extent.height = height;
+        create_info.extent.depth  = 1;
+        create_info.mipLevels     = mip_levels;
+        create_info.arrayLayers   = 1;
+        create_info.format        = format;
+        create_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        create_info.usage         = usage_flags;
+        create_info.samples       = VK_SAMPLE_COUNT_1_BIT;
+        create_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateImage(device, &create_info, getAllocationCallbacks(), &image) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create image!"};
+
+        VkMemoryRequirements memory_requirements{};
+        vkGetImageMemoryRequirements(device, image, &memory_requirements);
+
+        VkMemoryAllocateInfo allocate_info{};
+
+        allocate_info.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocate_info.allocationSize  = memory_requirements.size;
+        allocate_info.memoryTypeIndex = findMemoryType(physical_device, memory_requirements.memoryTypeBits, property_flags);
+
+        if (vkAllocateMemory(device, &allocate_info, getAllocationCallbacks(), &memory) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to allocate image memory!"};
+
+        vkBindImageMemory(device, image, memory, 0);
+    }
+
+    VkImageView createImageView(
+        const VkDevice           device,
+        const VkImage            image,
+        const VkFormat           format,
+        const VkImageAspectFlags aspect_flags,
+        const uint32_t           base_mip_level,
+        const uint32_t           mip_levels
+    ) {
+        VkImageViewCreateInfo create_info{};
+
+        create_info.sType    = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        create_info.image    = image;
+        create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        create_info.format   = format;
+
+        create_info.subresourceRange.aspectMask     = aspect_flags;
+        create_info.subresourceRange.baseMipLevel   = base_mip_level;
+        create_info.subresourceRange.levelCount     = mip_levels;
+        create_info.subresourceRange.baseArrayLayer = 0;
+        create_info.subresourceRange.layerCount     = 1;
+
+        VkImageView view;
+        if (vkCreateImageView(device, &create_info, getAllocationCallbacks(), &view) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create image view!"};
+
+        return view;
+    }
+
+    VkFormat findSupportedFormat(const VkPhysicalDevice device, const std::vector<VkFormat>& candidates, const VkFormatFeatureFlags features) {
+        for (const VkFormat format : candidates) {
+            VkFormatProperties properties{};
+            vkGetPhysicalDeviceFormatProperties(device, format, &properties);
+
+            if ((properties.optimalTilingFeatures & features) == features)
+                return format;
+        }
+
+        throw std::runtime_error{"Failed to find a supported format!"};
+    }
+
+    VkFormat findDepthFormat(const VkPhysicalDevice device) {
+        return findSupportedFormat(device, DEPTH_FORMAT_CANDIDATES, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+    }
+
+    bool hasStencilComponent(const VkFormat format) {
+        return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
+    }
+
+    VkImageAspectFlags getDepthAspectFlags(const VkFormat format) {
+        return hasStencilComponent(format) ? VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_DEPTH_BIT;
+    }
+
+    uint32_t getMipLevelCount(const uint32_t width, const uint32_t height) {
+        return std::bit_width(std::max({ width, height, 1u }));
+    }
+}
@@ -0,0 +1,80 @@
+#include "VulkanUtilities/IndexBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace VulkanUtilities {
+    uint32_t getIndexSize(const VkIndexType type) {
+        switch (type) {
+            case VK_INDEX_TYPE_UINT16: return sizeof(uint16_t);
+            case VK_INDEX_TYPE_UINT32: return sizeof(uint32_t);
+            default:
+                throw std::runtime_error{"Unsupported index type!"};
+        }
+    }
+
+    VkIndexType selectIndexType(const uint32_t vertex_count) {
+        return vertex_count <= MAX_16_BIT_INDEXED_VERTICES ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    }
+
+    IndexData packIndices(const std::span<const uint32_t> indices, const uint32_t vertex_count, const bool split_large_meshes) {
+        if (indices.size() % 3 != 0)
+            throw std::runtime_error{"Index count has to be a multiple of 3!"};
+
+        IndexData packed{};
+
+        packed.IndexCount = static_cast<uint32_t>(indices.size());
+        packed.Type       = split_large_meshes ? VK_INDEX_TYPE_UINT16 : selectIndexType(vertex_count);
+
+        if (packed.Type == VK_INDEX_TYPE_UINT32) {
+            packed.Data.resize(indices.size_bytes());
+            memcpy(packed.Data.data(), indices.data(), indices.size_bytes());
+
+            packed.Chunks.push_back({ 0, packed.IndexCount, 0 });
+
+            return packed;
+        }
+
+        // Grow each chunk one triangle at a time until its vertex range wouldn't fit in 16 bits anymore
+        uint32_t chunk_start = 0;
+        uint32_t chunk_min   = UINT32_MAX;
+        uint32_t chunk_max   = 0;
+
+        for (uint32_t i = 0; i < packed.IndexCount; i += 3) {
+            const uint32_t triangle_min = std::min({ indices[i], indices[i + 1], indices[i + 2] });
+            const uint32_t triangle_max = std::max({ indices[i], indices[i + 1], indices[i + 2] });
+
+            // A triangle that doesn't even fit on its own can't be drawn with 16-bit indices at all
+            if (triangle_max - triangle_min >= MAX_16_BIT_INDEXED_VERTICES)
+                return packIndices(indices, vertex_count, false);
+
+            if (std::max(chunk_max, triangle_max) - std::min(chunk_min, triangle_min) >= MAX_16_BIT_INDEXED_VERTICES) {
+                packed.Chunks.push_back({ chunk_start, i - chunk_start, static_cast<int32_t>(chunk_min) });
+
+                chunk_start = i;
+                chunk_min   = UINT32_MAX;
+                chunk_max   = 0;
+            }
+
+            chunk_min = std::min(chunk_min, triangle_min);
+            chunk_max = std::max(chunk_max, triangle_max);
+        }
+
+        if (chunk_start < packed.IndexCount)
+            packed.Chunks.push_back({ chunk_start, packed.IndexCount - chunk_start, static_cast<int32_t>(chunk_min) });
+
+        // Every chunk is its own draw, past a point that costs more than the index bandwidth saves
+        if (packed.Chunks.size() > 1 && packed.IndexCount / 3 < packed.Chunks.size() * MIN_TRIANGLES_PER_INDEX_CHUNK)
+            return packIndices(indices, vertex_count, false);
+
+        packed.Data.resize(indices.size() * sizeof(uint16_t));
+        auto* destination = reinterpret_cast<uint16_t*>(packed.Data.data());
+
+        for (const auto& chunk : packed.Chunks)
+            for (uint32_t i = chunk.FirstIndex; i < chunk.FirstIndex + chunk.IndexCount; i++)
+                destination[i] = static_cast<uint16_t>(indices[i] - static_cast<uint32_t>(chunk.VertexOffset));
+
+        return packed;
+    }
+}
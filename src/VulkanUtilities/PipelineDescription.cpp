@@ -0,0 +1,323 @@
+#include "VulkanUtilities/PipelineDescription.hpp"
+
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "StandardUtils.hpp"
+#include "VulkanUtilities/HostAllocator.hpp"
+
+namespace VulkanUtilities {
+    // Which fields each part is built from (layout and render pass go into every part that needs them at creation)
+    static constexpr VkGraphicsPipelineLibraryFlagsEXT VERTEX_INPUT_PART    = VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+    static constexpr VkGraphicsPipelineLibraryFlagsEXT PRE_RASTER_PART      = VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+    static constexpr VkGraphicsPipelineLibraryFlagsEXT FRAGMENT_SHADER_PART = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+    static constexpr VkGraphicsPipelineLibraryFlagsEXT FRAGMENT_OUTPUT_PART = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+    static constexpr VkGraphicsPipelineLibraryFlagsEXT LAYOUT_PARTS      = PRE_RASTER_PART | FRAGMENT_SHADER_PART;
+    static constexpr VkGraphicsPipelineLibraryFlagsEXT RENDER_PASS_PARTS = PRE_RASTER_PART | FRAGMENT_SHADER_PART | FRAGMENT_OUTPUT_PART;
+
+    // FNV-1a, the Vk structs in the description have no padding so hashing their bytes is fine
+    static void hashBytes(uint64_t& hash, const void* data, const size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3ull;
+        }
+    }
+
+    template <typename Value>
+    static void hashValue(uint64_t& hash, const Value& value) {
+        hashBytes(hash, &value, sizeof(Value));
+    }
+
+    template <typename Value>
+    static void hashVector(uint64_t& hash, const std::vector<Value>& values) {
+        hashValue(hash, values.size());
+        hashBytes(hash, values.data(), values.size() * sizeof(Value));
+    }
+
+    static void hashString(uint64_t& hash, const std::string& string) {
+        hashValue(hash, string.size());
+        hashBytes(hash, string.data(), string.size());
+    }
+
+    template <typename Value>
+    static bool bytesEqual(const std::vector<Value>& left, const std::vector<Value>& right) {
+        return left.size() == right.size() && (left.empty() || memcmp(left.data(), right.data(), left.size() * sizeof(Value)) == 0);
+    }
+
+    // Only the class has to match the pipeline when topology is dynamic (without dynamicPrimitiveTopologyUnrestricted)
+    static uint32_t getTopologyClass(const VkPrimitiveTopology topology) {
+        switch (topology) {
+            case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+                return 0;
+
+            case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+                return 1;
+
+            case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+                return 3;
+
+            default:
+                return 2;
+        }
+    }
+
+    // What actually ends up baked into the pipeline, dynamic fields are zeroed (or reduced to the topology class) so they hash and compare the same
+    static FixedFunctionState getBakedFixedFunctionState(const GraphicsPipelineDescription& description) {
+        FixedFunctionState baked = description.FixedFunction;
+
+        if (description.DynamicState & DYNAMIC_PIPELINE_STATE_RASTERIZATION) {
+            baked.Topology  = static_cast<VkPrimitiveTopology>(getTopologyClass(baked.Topology));
+            baked.CullMode  = 0;
+            baked.FrontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        }
+
+        if (description.DynamicState & DYNAMIC_PIPELINE_STATE_DEPTH) {
+            baked.DepthTest    = VK_FALSE;
+            baked.DepthWrite   = VK_FALSE;
+            baked.DepthCompare = VK_COMPARE_OP_NEVER;
+        }
+
+        if (description.DynamicState & DYNAMIC_PIPELINE_STATE_BLEND) {
+            baked.BlendEnable    = VK_FALSE;
+            baked.ColorWriteMask = 0;
+        }
+
+        return baked;
+    }
+
+    bool equalGraphicsPipelineDescriptions(const GraphicsPipelineDescription& left, const GraphicsPipelineDescription& right, const VkGraphicsPipelineLibraryFlagsEXT parts) {
+        const FixedFunctionState left_baked  = getBakedFixedFunctionState(left);
+        const FixedFunctionState right_baked = getBakedFixedFunctionState(right);
+
+        if (left.DynamicState != right.DynamicState)
+            return false;
+
+        if ((parts & LAYOUT_PARTS) && left.Layout != right.Layout)
+            return false;
+
+        if ((parts & RENDER_PASS_PARTS) && (left.RenderPass != right.RenderPass || left.Subpass != right.Subpass))
+            return false;
+
+        if ((parts & VERTEX_INPUT_PART) && !(bytesEqual(left.VertexBindings, right.VertexBindings) && bytesEqual(left.VertexAttributes, right.VertexAttributes)
+                                           && left_baked.Topology == right_baked.Topology))
+            return false;
+
+        if ((parts & PRE_RASTER_PART) && !(left.VertexShader == right.VertexShader && left_baked.CullMode == right_baked.CullMode && left_baked.FrontFace == right_baked.FrontFace))
+            return false;
+
+        if ((parts & FRAGMENT_SHADER_PART) && !(left.FragmentShader == right.FragmentShader && left.FragmentConstants == right.FragmentConstants
+                                              && left_baked.DepthTest == right_baked.DepthTest && left_baked.DepthWrite == right_baked.DepthWrite
+                                              && left_baked.DepthCompare == right_baked.DepthCompare))
+            return false;
+
+        if ((parts & FRAGMENT_OUTPUT_PART) && !(left_baked.BlendEnable == right_baked.BlendEnable && left_baked.ColorWriteMask == right_baked.ColorWriteMask))
+            return false;
+
+        return true;
+    }
+
+    // The parts go into the hash too, so a part never shares a key with the whole pipeline (or another part)
+    uint64_t hashGraphicsPipelineDescription(const GraphicsPipelineDescription& description, const VkGraphicsPipelineLibraryFlagsEXT parts) {
+        const FixedFunctionState baked = getBakedFixedFunctionState(description);
+
+        uint64_t hash = 0xCBF29CE484222325ull;
+
+        hashValue(hash, parts);
+        hashValue(hash, description.DynamicState);
+
+        if (parts & LAYOUT_PARTS)
+            hashValue(hash, description.Layout);
+
+        if (parts & RENDER_PASS_PARTS) {
+            hashValue(hash, description.RenderPass);
+            hashValue(hash, description.Subpass);
+        }
+
+        if (parts & VERTEX_INPUT_PART) {
+            hashVector(hash, description.VertexBindings);
+            hashVector(hash, description.VertexAttributes);
+            hashValue(hash, baked.Topology);
+        }
+
+        if (parts & PRE_RASTER_PART) {
+            hashString(hash, description.VertexShader);
+            hashValue(hash, baked.CullMode);
+            hashValue(hash, baked.FrontFace);
+        }
+
+        if (parts & FRAGMENT_SHADER_PART) {
+            hashString(hash, description.FragmentShader);
+            hashVector(hash, description.FragmentConstants);
+            hashValue(hash, baked.DepthTest);
+            hashValue(hash, baked.DepthWrite);
+            hashValue(hash, baked.DepthCompare);
+        }
+
+        if (parts & FRAGMENT_OUTPUT_PART) {
+            hashValue(hash, baked.BlendEnable);
+            hashValue(hash, baked.ColorWriteMask);
+        }
+
+        return hash;
+    }
+
+    bool operator==(const GraphicsPipelineDescription& left, const GraphicsPipelineDescription& right) {
+        return equalGraphicsPipelineDescriptions(left, right);
+    }
+
+    static VkPipelineShaderStageCreateInfo createShaderStage(const VkShaderStageFlagBits stage, const VkShaderModule module, const VkSpecializationInfo* specialization) {
+        VkPipelineShaderStageCreateInfo stage_info{};
+
+        stage_info.sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stage_info.stage               = stage;
+        stage_info.module              = module;
+        stage_info.pName               = "main";
+        stage_info.pSpecializationInfo = specialization;
+
+        return stage_info;
+    }
+
+    void populateGraphicsPipelineState(const VkDevice device, GraphicsPipelineState& state, const GraphicsPipelineDescription& description, const VkGraphicsPipelineLibraryFlagsEXT parts) {
+        const bool                depth_only     = description.FragmentShader.empty();
+        const FixedFunctionState& fixed_function = description.FixedFunction;
+
+        if (parts & PRE_RASTER_PART) {
+            state.VertexModule = createShaderModule(device, StandardUtilities::readFile(description.VertexShader));
+            state.Stages[state.StageCount++] = createShaderStage(VK_SHADER_STAGE_VERTEX_BIT, state.VertexModule, nullptr);
+        }
+
+        // The vertex module is already there, it would leak if the fragment shader can't be read (or compiled)
+        if ((parts & FRAGMENT_SHADER_PART) && !depth_only) {
+            try {
+                state.FragmentModule    = createShaderModule(device, StandardUtilities::readFile(description.FragmentShader));
+                state.FragmentConstants = createSpecializationConstants(description.FragmentConstants);
+            } catch (const std::exception&) {
+                destroyGraphicsPipelineState(device, state);
+                throw;
+            }
+
+            const VkSpecializationInfo* specialization = description.FragmentConstants.empty() ? nullptr : &state.FragmentConstants.Info;
+            state.Stages[state.StageCount++] = createShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, state.FragmentModule, specialization);
+        }
+
+        state.VertexInput.sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        state.VertexInput.vertexBindingDescriptionCount   = static_cast<uint32_t>(description.VertexBindings.size());
+        state.VertexInput.pVertexBindingDescriptions      = description.VertexBindings.data();
+        state.VertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(description.VertexAttributes.size());
+        state.VertexInput.pVertexAttributeDescriptions    = description.VertexAttributes.data();
+
+        state.InputAssembly.sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        state.InputAssembly.topology               = fixed_function.Topology;
+        state.InputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        // Viewport and scissor are dynamic, only the counts matter here
+        state.Viewport.sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        state.Viewport.viewportCount = 1;
+        state.Viewport.scissorCount  = 1;
+
+        state.Rasterization.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        state.Rasterization.depthClampEnable        = VK_FALSE;
+        state.Rasterization.rasterizerDiscardEnable = VK_FALSE;
+        state.Rasterization.polygonMode             = VK_POLYGON_MODE_FILL;
+        state.Rasterization.lineWidth               = 1.0f; // Required for line modes
+        state.Rasterization.cullMode                = fixed_function.CullMode;
+        state.Rasterization.frontFace               = fixed_function.FrontFace;
+        state.Rasterization.depthBiasEnable         = VK_FALSE;
+
+        state.Multisample.sType                = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        state.Multisample.sampleShadingEnable  = VK_FALSE;
+        state.Multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        state.Multisample.minSampleShading     = 1.0f;
+
+        state.DepthStencil.sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        state.DepthStencil.depthTestEnable       = fixed_function.DepthTest;
+        state.DepthStencil.depthWriteEnable      = fixed_function.DepthWrite;
+        state.DepthStencil.depthCompareOp        = fixed_function.DepthCompare;
+        state.DepthStencil.depthBoundsTestEnable = VK_FALSE;
+        state.DepthStencil.stencilTestEnable     = VK_FALSE;
+
+        state.ColorBlendAttachment.colorWriteMask      = fixed_function.ColorWriteMask;
+        state.ColorBlendAttachment.blendEnable         = fixed_function.BlendEnable;
+        state.ColorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        state.ColorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        state.ColorBlendAttachment.colorBlendOp        = VK_BLEND_OP_ADD;
+        state.ColorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        state.ColorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        state.ColorBlendAttachment.alphaBlendOp        = VK_BLEND_OP_ADD;
+
+        state.ColorBlend.sType           = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        state.ColorBlend.logicOpEnable   = VK_FALSE;
+        state.ColorBlend.logicOp         = VK_LOGIC_OP_COPY;
+        state.ColorBlend.attachmentCount = 1;
+        state.ColorBlend.pAttachments    = &state.ColorBlendAttachment;
+
+        // A pipeline library part may only list the dynamic states of the part it is
+        uint32_t dynamic_state_count = 0;
+
+        const auto addDynamicStates = [&](const VkGraphicsPipelineLibraryFlagsEXT part, const uint32_t dynamic_bit, std::initializer_list<VkDynamicState> dynamic_states) {
+            if (!(parts & part) || (dynamic_bit != 0 && !(description.DynamicState & dynamic_bit)))
+                return;
+
+            for (const VkDynamicState dynamic_state : dynamic_states)
+                state.DynamicStates[dynamic_state_count++] = dynamic_state;
+        };
+
+        addDynamicStates(PRE_RASTER_PART,      0,                                    { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR });
+        addDynamicStates(VERTEX_INPUT_PART,    DYNAMIC_PIPELINE_STATE_RASTERIZATION, { VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT });
+        addDynamicStates(PRE_RASTER_PART,      DYNAMIC_PIPELINE_STATE_RASTERIZATION, { VK_DYNAMIC_STATE_CULL_MODE_EXT, VK_DYNAMIC_STATE_FRONT_FACE_EXT });
+        addDynamicStates(FRAGMENT_SHADER_PART, DYNAMIC_PIPELINE_STATE_DEPTH,         { VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT, VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT, VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT });
+        addDynamicStates(FRAGMENT_OUTPUT_PART, DYNAMIC_PIPELINE_STATE_BLEND,         { VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT, VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT });
+
+        state.Dynamic.sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        state.Dynamic.dynamicStateCount = dynamic_state_count;
+        state.Dynamic.pDynamicStates    = state.DynamicStates.data();
+    }
+
+    void destroyGraphicsPipelineState(const VkDevice device, GraphicsPipelineState& state) {
+        vkDestroyShaderModule(device, state.VertexModule,   getAllocationCallbacks());
+        vkDestroyShaderModule(device, state.FragmentModule, getAllocationCallbacks());
+
+        state.VertexModule   = VK_NULL_HANDLE;
+        state.FragmentModule = VK_NULL_HANDLE;
+    }
+
+    VkPipeline createGraphicsPipeline(const VkDevice device, const GraphicsPipelineDescription& description) {
+        GraphicsPipelineState state;
+        populateGraphicsPipelineState(device, state, description);
+
+        VkGraphicsPipelineCreateInfo graphics_pipeline_info{};
+
+        graphics_pipeline_info.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        graphics_pipeline_info.stageCount          = state.StageCount;
+        graphics_pipeline_info.pStages             = state.Stages.data();
+        graphics_pipeline_info.pVertexInputState   = &state.VertexInput;
+        graphics_pipeline_info.pInputAssemblyState = &state.InputAssembly;
+        graphics_pipeline_info.pViewportState      = &state.Viewport;
+        graphics_pipeline_info.pRasterizationState = &state.Rasterization;
+        graphics_pipeline_info.pMultisampleState   = &state.Multisample;
+        graphics_pipeline_info.pDepthStencilState  = &state.DepthStencil;
+        graphics_pipeline_info.pColorBlendState    = &state.ColorBlend;
+        graphics_pipeline_info.pDynamicState       = &state.Dynamic;
+        graphics_pipeline_info.layout              = description.Layout;
+        graphics_pipeline_info.renderPass          = description.RenderPass;
+        graphics_pipeline_info.subpass             = description.Subpass;
+        graphics_pipeline_info.basePipelineIndex   = -1;
+
+        VkPipeline pipeline;
+        const VkResult result = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphics_pipeline_info, getAllocationCallbacks(), &pipeline);
+
+        destroyGraphicsPipelineState(device, state);
+
+        if (result != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create the Graphics Pipeline (" + description.VertexShader + ", " + description.FragmentShader + ")!"};
+
+        return pipeline;
+    }
+}
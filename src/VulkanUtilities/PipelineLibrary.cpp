@@ -0,0 +1,170 @@
+#include "VulkanUtilities/PipelineLibrary.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "VulkanUtilities/HostAllocator.hpp"
+
+namespace VulkanUtilities {
+    bool isGraphicsPipelineLibrarySupported(const VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT& features) {
+        return features.graphicsPipelineLibrary;
+    }
+
+    void populateGraphicsPipelineLibraryFeatures(VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT& features) {
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+
+        features.graphicsPipelineLibrary = VK_TRUE;
+    }
+
+    // Each part only gets the state it owns, the rest of the create info is ignored for it anyway
+    //  . Retaining the link time optimization info is what makes the optimized link possible later
+    VkPipeline createPipelineLibraryPart(const VkDevice device, const GraphicsPipelineDescription& description, const VkGraphicsPipelineLibraryFlagBitsEXT part) {
+        GraphicsPipelineState state;
+        populateGraphicsPipelineState(device, state, description, part);
+
+        VkGraphicsPipelineLibraryCreateInfoEXT library_info{};
+
+        library_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+        library_info.flags = part;
+
+        VkGraphicsPipelineCreateInfo graphics_pipeline_info{};
+
+        graphics_pipeline_info.sType             = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        graphics_pipeline_info.pNext             = &library_info;
+        graphics_pipeline_info.flags             = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+        graphics_pipeline_info.pDynamicState     = &state.Dynamic; // Only lists this part's dynamic states
+        graphics_pipeline_info.basePipelineIndex = -1;
+
+        switch (part) {
+            case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+                graphics_pipeline_info.pVertexInputState   = &state.VertexInput;
+                graphics_pipeline_info.pInputAssemblyState = &state.InputAssembly;
+                break;
+
+            case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+                graphics_pipeline_info.stageCount          = state.StageCount;
+                graphics_pipeline_info.pStages             = state.Stages.data();
+                graphics_pipeline_info.pViewportState      = &state.Viewport;
+                graphics_pipeline_info.pRasterizationState = &state.Rasterization;
+                graphics_pipeline_info.layout              = description.Layout;
+                graphics_pipeline_info.renderPass          = description.RenderPass;
+                graphics_pipeline_info.subpass             = description.Subpass;
+                break;
+
+            // Depth only descriptions have no fragment stage at all, which is allowed here
+            case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+                graphics_pipeline_info.stageCount         = state.StageCount;
+                graphics_pipeline_info.pStages            = state.Stages.data();
+                graphics_pipeline_info.pMultisampleState  = &state.Multisample;
+                graphics_pipeline_info.pDepthStencilState = &state.DepthStencil;
+                graphics_pipeline_info.layout             = description.Layout;
+                graphics_pipeline_info.renderPass         = description.RenderPass;
+                graphics_pipeline_info.subpass            = description.Subpass;
+                break;
+
+            case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT:
+                graphics_pipeline_info.pMultisampleState = &state.Multisample;
+                graphics_pipeline_info.pColorBlendState  = &state.ColorBlend;
+                graphics_pipeline_info.renderPass        = description.RenderPass;
+                graphics_pipeline_info.subpass           = description.Subpass;
+                break;
+
+            default:
+                throw std::runtime_error{"Unknown graphics pipeline library part!"};
+        }
+
+        VkPipeline library;
+        const VkResult result = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphics_pipeline_info, getAllocationCallbacks(), &library);
+
+        destroyGraphicsPipelineState(device, state);
+
+        if (result != VK_SUCCESS)
+            throw std::runtime_error{"Failed to create a Graphics Pipeline Library part (" + description.VertexShader + ", " + description.FragmentShader + ")!"};
+
+        return library;
+    }
+
+    VkPipeline linkPipelineLibraries(const VkDevice device, const GraphicsPipelineDescription& description, const PipelineLibraryParts& parts, const bool optimize) {
+        VkPipelineLibraryCreateInfoKHR library_info{};
+
+        library_info.sType        = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+        library_info.libraryCount = static_cast<uint32_t>(parts.size());
+        library_info.pLibraries   = parts.data();
+
+        VkGraphicsPipelineCreateInfo graphics_pipeline_info{};
+
+        graphics_pipeline_info.sType             = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        graphics_pipeline_info.pNext             = &library_info;
+        graphics_pipeline_info.flags             = optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0;
+        graphics_pipeline_info.layout            = description.Layout;
+        graphics_pipeline_info.basePipelineIndex = -1;
+
+        VkPipeline pipeline;
+        if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphics_pipeline_info, getAllocationCallbacks(), &pipeline) != VK_SUCCESS)
+            throw std::runtime_error{"Failed to link the Graphics Pipeline Libraries (" + description.VertexShader + ", " + description.FragmentShader + ")!"};
+
+        return pipeline;
+    }
+
+    // Compiled outside the lock, if another thread got the same part in first ours is thrown away (cheaper than making everyone wait)
+    static VkPipeline getPipelineLibraryPart(const VkDevice device, PipelineLibraryCache& cache, const GraphicsPipelineDescription& description, const VkGraphicsPipelineLibraryFlagBitsEXT part) {
+        const uint64_t key = hashGraphicsPipelineDescription(description, part);
+
+        {
+            const std::lock_guard lock{ cache.Mutex };
+
+            if (const auto found = cache.Parts.find(key); found != cache.Parts.end()) {
+                if (!equalGraphicsPipelineDescriptions(found->second.Description, description, part))
+                    throw std::runtime_error{"Two different pipeline library parts hashed to the same key!"};
+
+                cache.Statistics.Hits++;
+                return found->second.Library;
+            }
+        }
+
+        const auto       start   = std::chrono::steady_clock::now();
+        const VkPipeline library = createPipelineLibraryPart(device, description, part);
+
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const std::lock_guard lock{ cache.Mutex };
+
+        const auto [entry, inserted] = cache.Parts.try_emplace(key, PipelineLibraryEntry{ description, library });
+
+        if (!inserted) {
+            vkDestroyPipeline(device, library, getAllocationCallbacks());
+            cache.Statistics.Hits++;
+
+            return entry->second.Library;
+        }
+
+        cache.Statistics.Misses++;
+        cache.Statistics.CompileMilliseconds += milliseconds;
+
+        return library;
+    }
+
+    PipelineLibraryParts getPipelineLibraryParts(const VkDevice device, PipelineLibraryCache& cache, const GraphicsPipelineDescription& description) {
+        PipelineLibraryParts parts{};
+
+        for (size_t i = 0; i < GRAPHICS_PIPELINE_LIBRARY_PARTS.size(); i++)
+            parts[i] = getPipelineLibraryPart(device, cache, description, GRAPHICS_PIPELINE_LIBRARY_PARTS[i]);
+
+        return parts;
+    }
+
+    PipelineLibraryStatistics getPipelineLibraryStatistics(PipelineLibraryCache& cache) {
+        const std::lock_guard lock{ cache.Mutex };
+        return cache.Statistics;
+    }
+
+    void destroyPipelineLibraryCache(const VkDevice device, PipelineLibraryCache& cache) {
+        const std::lock_guard lock{ cache.Mutex };
+
+        for (const auto& [key, entry] : cache.Parts)
+            vkDestroyPipeline(device, entry.Library, getAllocationCallbacks());
+
+        cache.Parts.clear();
+        cache.Statistics = {};
+    }
+}
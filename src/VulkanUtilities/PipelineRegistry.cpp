@@ -0,0 +1,258 @@
+#include "VulkanUtilities/PipelineRegistry.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "spdlog/spdlog.h"
+
+#include "VulkanUtilities/DebugNames.hpp"
+#include "VulkanUtilities/HostAllocator.hpp"
+
+namespace VulkanUtilities {
+    void createPipelineRegistry(PipelineRegistry& registry, const VkDevice device, const uint32_t worker_count, const bool use_libraries) {
+        registry.Device = device;
+
+        if (worker_count > 0)
+            registry.Workers = std::make_unique<StandardUtilities::ThreadPool>(worker_count);
+
+        if (use_libraries)
+            registry.Libraries = std::make_unique<PipelineLibraryCache>();
+    }
+
+    void destroyPipelineRegistry(PipelineRegistry& registry) {
+        waitForPipelines(registry);
+
+        registry.Workers.reset();
+
+        for (const auto& [key, entry] : registry.Entries)
+            vkDestroyPipeline(registry.Device, entry.Pipeline, getAllocationCallbacks());
+
+        for (const VkPipeline pipeline : registry.Retired)
+            vkDestroyPipeline(registry.Device, pipeline, getAllocationCallbacks());
+
+        if (registry.Libraries) {
+            destroyPipelineLibraryCache(registry.Device, *registry.Libraries);
+            registry.Libraries.reset();
+        }
+
+        registry.Entries.clear();
+        registry.Retired.clear();
+        registry.Statistics = {};
+        registry.Device     = VK_NULL_HANDLE;
+    }
+
+    // A 64-bit collision is unlikely enough that handing out the wrong pipeline silently would be the worse outcome
+    static PipelineRegistryEntry* findEntry(PipelineRegistry& registry, const uint64_t key, const GraphicsPipelineDescription& description) {
+        const auto found = registry.Entries.find(key);
+
+        if (found == registry.Entries.end())
+            return nullptr;
+
+        if (!equalGraphicsPipelineDescriptions(found->second.Description, description))
+            throw std::runtime_error{"Two different pipeline descriptions hashed to the same key!"};
+
+        return &found->second;
+    }
+
+    static double millisecondsSince(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Done before the pipeline is published, naming it needs it externally synchronized
+    static void nameEntryPipeline(const PipelineRegistry& registry, const PipelineRegistryEntry& entry, const VkPipeline pipeline) {
+        if constexpr (DEBUG_NAMES_ENABLED) {
+            const GraphicsPipelineDescription& description = entry.Description;
+
+            if (!description.Name.empty())
+                setObjectName(registry.Device, VK_OBJECT_TYPE_PIPELINE, pipeline, description.Name.c_str());
+            else if (description.FragmentShader.empty())
+                setObjectName(registry.Device, VK_OBJECT_TYPE_PIPELINE, pipeline, description.VertexShader.c_str());
+            else
+                setObjectName(registry.Device, VK_OBJECT_TYPE_PIPELINE, pipeline, (description.VertexShader + ", " + description.FragmentShader).c_str());
+        }
+    }
+
+    // Swaps the fast-linked pipeline out for the optimized one, the old one is kept until the registry goes
+    //  . Failing here isn't fatal, the fast-linked pipeline just stays
+    static void optimizeEntry(PipelineRegistry& registry, PipelineRegistryEntry& entry, const PipelineLibraryParts& parts) {
+        const auto start = std::chrono::steady_clock::now();
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+
+        try {
+            pipeline = linkPipelineLibraries(registry.Device, entry.Description, parts, true);
+        } catch (const std::exception& exception) {
+            spdlog::warn("Optimized link failed, keeping the fast-linked pipeline: {}", exception.what());
+        }
+
+        const double milliseconds = millisecondsSince(start);
+
+        if (pipeline != VK_NULL_HANDLE)
+            nameEntryPipeline(registry, entry, pipeline);
+
+        {
+            const std::lock_guard lock{ registry.Mutex };
+
+            entry.Optimizing = false;
+
+            if (pipeline != VK_NULL_HANDLE) {
+                registry.Retired.push_back(entry.Pipeline);
+
+                entry.Pipeline  = pipeline;
+                entry.Optimized = true;
+
+                registry.Statistics.OptimizedLinks++;
+                registry.Statistics.CompileMilliseconds += milliseconds;
+                registry.Statistics.LinkMilliseconds    += milliseconds;
+
+                registry.Generation++;
+            }
+        }
+
+        registry.Compiled.notify_all();
+    }
+
+    // Compiles without holding the lock, entries never move (unordered_map nodes stay put through a rehash)
+    //  . A failed compile marks the entry so nobody waits on it forever, then rethrows (or returns null on a worker, nobody's there to catch it)
+    //  . Without workers there's nothing to hide an optimized link behind, so it's done straight away instead of the fast one,
+    //    same for a blocking caller, it would keep the fast-linked pipeline forever
+    static VkPipeline compileEntry(PipelineRegistry& registry, PipelineRegistryEntry& entry, const bool blocking) {
+        const auto start = std::chrono::steady_clock::now();
+
+        const bool optimize = !registry.Libraries || !registry.Workers || blocking;
+
+        VkPipeline           pipeline = VK_NULL_HANDLE;
+        PipelineLibraryParts parts{};
+        double               link_milliseconds = 0.0;
+
+        try {
+            if (registry.Libraries) {
+                parts = getPipelineLibraryParts(registry.Device, *registry.Libraries, entry.Description);
+
+                const auto link_start = std::chrono::steady_clock::now();
+
+                pipeline          = linkPipelineLibraries(registry.Device, entry.Description, parts, optimize);
+                link_milliseconds = millisecondsSince(link_start);
+            } else
+                pipeline = createGraphicsPipeline(registry.Device, entry.Description);
+        } catch (const std::exception& exception) {
+            {
+                const std::lock_guard lock{ registry.Mutex };
+
+                entry.Failed = true;
+                registry.Generation++;
+            }
+
+            registry.Compiled.notify_all();
+
+            if (blocking)
+                throw;
+
+            // An entry only ever gets compiled once, so this is the one time anyone hears about it
+            spdlog::error("Background pipeline compile failed, its fallback is used from now on: {}", exception.what());
+
+            return VK_NULL_HANDLE;
+        }
+
+        const double milliseconds = millisecondsSince(start);
+
+        nameEntryPipeline(registry, entry, pipeline);
+
+        {
+            const std::lock_guard lock{ registry.Mutex };
+
+            entry.Pipeline   = pipeline;
+            entry.Optimized  = optimize;
+            entry.Optimizing = !optimize; // Before anyone can see the pipeline, so a blocking lookup knows to wait
+
+            registry.Statistics.CompileMilliseconds += milliseconds;
+
+            if (registry.Libraries) {
+                (optimize ? registry.Statistics.OptimizedLinks : registry.Statistics.FastLinks)++;
+                registry.Statistics.LinkMilliseconds += link_milliseconds;
+            }
+
+            registry.Generation++;
+        }
+
+        registry.Compiled.notify_all();
+
+        if (!optimize)
+            registry.Workers->submit([&registry, &entry, parts] { optimizeEntry(registry, entry, parts); });
+
+        return pipeline;
+    }
+
+    VkPipeline getPipeline(PipelineRegistry& registry, const GraphicsPipelineDescription& description) {
+        const uint64_t key = hashGraphicsPipelineDescription(description);
+
+        std::unique_lock lock{ registry.Mutex };
+
+        if (PipelineRegistryEntry* entry = findEntry(registry, key, description)) {
+            if (entry->Pipeline != VK_NULL_HANDLE && !entry->Optimizing) {
+                registry.Statistics.Hits++;
+                return entry->Pipeline;
+            }
+
+            // A worker has it already (or its optimized link), compiling it twice would only be slower
+            registry.Compiled.wait(lock, [entry] { return (entry->Pipeline != VK_NULL_HANDLE && !entry->Optimizing) || entry->Failed; });
+
+            if (entry->Failed)
+                throw std::runtime_error{"Failed to create the Graphics Pipeline (" + description.VertexShader + ", " + description.FragmentShader + ")!"};
+
+            return entry->Pipeline;
+        }
+
+        registry.Statistics.Misses++;
+
+        PipelineRegistryEntry& entry = registry.Entries.emplace(key, PipelineRegistryEntry{ description }).first->second;
+
+        lock.unlock();
+
+        return compileEntry(registry, entry, true);
+    }
+
+    VkPipeline requestPipeline(PipelineRegistry& registry, const GraphicsPipelineDescription& description, const VkPipeline fallback) {
+        if (!registry.Workers)
+            return getPipeline(registry, description);
+
+        const uint64_t key = hashGraphicsPipelineDescription(description);
+
+        std::unique_lock lock{ registry.Mutex };
+
+        if (const PipelineRegistryEntry* entry = findEntry(registry, key, description)) {
+            if (entry->Pipeline != VK_NULL_HANDLE) {
+                registry.Statistics.Hits++;
+                return entry->Pipeline;
+            }
+
+            registry.Statistics.Fallbacks++;
+            return fallback;
+        }
+
+        registry.Statistics.Misses++;
+        registry.Statistics.Fallbacks++;
+
+        PipelineRegistryEntry& entry = registry.Entries.emplace(key, PipelineRegistryEntry{ description }).first->second;
+
+        lock.unlock();
+
+        registry.Workers->submit([&registry, &entry] { compileEntry(registry, entry, false); });
+
+        return fallback;
+    }
+
+    void waitForPipelines(PipelineRegistry& registry) {
+        if (registry.Workers)
+            registry.Workers->waitIdle();
+    }
+
+    uint64_t getPipelineRegistryGeneration(const PipelineRegistry& registry) {
+        return registry.Generation.load(std::memory_order_acquire);
+    }
+
+    PipelineRegistryStatistics getPipelineRegistryStatistics(PipelineRegistry& registry) {
+        const std::lock_guard lock{ registry.Mutex };
+        return registry.Statistics;
+    }
+}
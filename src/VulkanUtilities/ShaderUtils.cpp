@@ -1,6 +1,9 @@
 #include "VulkanUtilities/ShaderUtils.hpp"
 
 #include <stdexcept>
+#include <utility>
+
+#include "VulkanUtilities/HostAllocator.hpp"
 
 namespace VulkanUtilities {
     VkShaderModule createShaderModule(const VkDevice device, const std::vector<char>& shader) {
@@ -11,9 +14,26 @@ namespace VulkanUtilities {
         create_info.pCode    = reinterpret_cast<const uint32_t*>(shader.data());
 
         VkShaderModule shader_module;
-        if (vkCreateShaderModule(device, &create_info, nullptr, &shader_module) != VK_SUCCESS)
+        if (vkCreateShaderModule(device, &create_info, getAllocationCallbacks(), &shader_module) != VK_SUCCESS)
             throw std::runtime_error{"Failed to create Shader Module!"};
 
         return shader_module;
     }
+
+    SpecializationConstants createSpecializationConstants(std::vector<uint32_t> values) {
+        SpecializationConstants constants{};
+
+        constants.Values = std::move(values);
+        constants.Entries.resize(constants.Values.size());
+
+        for (uint32_t i = 0; i < constants.Entries.size(); i++)
+            constants.Entries[i] = { i, static_cast<uint32_t>(i * sizeof(uint32_t)), sizeof(uint32_t) };
+
+        constants.Info.mapEntryCount = static_cast<uint32_t>(constants.Entries.size());
+        constants.Info.pMapEntries   = constants.Entries.data();
+        constants.Info.dataSize      = constants.Values.size() * sizeof(uint32_t);
+        constants.Info.pData         = constants.Values.data();
+
+        return constants;
+    }
 }
@@ -0,0 +1,274 @@
+#include "VulkanUtilities/VertexEncoding.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define VERTEX_ENCODING_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if defined(VERTEX_ENCODING_SSE2) && (defined(__F16C__) || defined(__AVX2__))
+    #define VERTEX_ENCODING_F16C
+    #include <immintrin.h>
+#endif
+
+namespace VulkanUtilities {
+    // Round to nearest even, overflow goes to infinity (same thing the hardware conversions do)
+    uint16_t floatToHalf(const float value) {
+        const uint32_t bits     = std::bit_cast<uint32_t>(value);
+        const uint32_t sign     = (bits >> 16) & 0x8000;
+        const uint32_t absolute = bits & 0x7FFFFFFF;
+
+        // NaN stays NaN (quiet), infinity and anything too big becomes infinity
+        if (absolute >= 0x477FF000)
+            return static_cast<uint16_t>(sign | (absolute > 0x7F800000 ? 0x7E00 : 0x7C00));
+
+        // Subnormal halves, scaling by 2^24 turns them into plain integers (and the FPU does the rounding)
+        if (absolute < 0x38800000)
+            return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(std::bit_cast<float>(absolute) * 16777216.0f)));
+
+        // Rebias the exponent (127 -> 15) and round the mantissa, a mantissa overflow carries into the exponent on its own
+        return static_cast<uint16_t>(sign | ((absolute + 0xC8000FFF + ((absolute >> 13) & 1)) >> 13));
+    }
+
+    float halfToFloat(const uint16_t value) {
+        const uint32_t sign     = static_cast<uint32_t>(value & 0x8000) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1F;
+        const uint32_t mantissa = value & 0x3FF;
+
+        if (exponent == 0) {
+            const float magnitude = static_cast<float>(mantissa) / 16777216.0f;
+            return sign ? -magnitude : magnitude;
+        }
+
+        if (exponent == 31)
+            return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+
+        return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+    }
+
+    // Round to nearest even like floatToHalf(), so they match what _mm_cvtps_epi32 gives the SIMD encoders bit for bit
+    uint8_t floatToUnorm8(const float value) {
+        return static_cast<uint8_t>(std::nearbyint(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    }
+
+    int16_t floatToSnorm16(const float value) {
+        return static_cast<int16_t>(std::nearbyint(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    float snorm16ToFloat(const int16_t value) {
+        return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+    }
+
+    // Projects the normal onto an octahedron and unfolds the lower half over the corners, so it fits in two numbers
+    glm::vec2 encodeOctahedral(const glm::vec3 normal) {
+        const float     inverse_length = 1.0f / (std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z));
+        const glm::vec2 projected{ normal.x * inverse_length, normal.y * inverse_length };
+
+        if (normal.z >= 0.0f)
+            return projected;
+
+        return {
+            (1.0f - std::fabs(projected.y)) * (projected.x >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - std::fabs(projected.x)) * (projected.y >= 0.0f ? 1.0f : -1.0f)
+        };
+    }
+
+    glm::vec3 decodeOctahedral(const glm::vec2 encoded) {
+        glm::vec3 normal{ encoded.x, encoded.y, 1.0f - std::fabs(encoded.x) - std::fabs(encoded.y) };
+
+        if (normal.z < 0.0f) {
+            const float x = normal.x;
+
+            normal.x = (1.0f - std::fabs(normal.y)) * (x        >= 0.0f ? 1.0f : -1.0f);
+            normal.y = (1.0f - std::fabs(x))        * (normal.y >= 0.0f ? 1.0f : -1.0f);
+        }
+
+        return glm::normalize(normal);
+    }
+
+    // Scalar Encoders
+    void encodeHalf4Scalar(const std::span<const glm::vec3> source, const std::span<Half4> destination) {
+        for (size_t i = 0; i < source.size(); i++)
+            destination[i] = {{ floatToHalf(source[i].x), floatToHalf(source[i].y), floatToHalf(source[i].z), floatToHalf(1.0f) }};
+    }
+
+    void encodeHalf2Scalar(const std::span<const glm::vec2> source, const std::span<Half2> destination) {
+        for (size_t i = 0; i < source.size(); i++)
+            destination[i] = {{ floatToHalf(source[i].x), floatToHalf(source[i].y) }};
+    }
+
+    void encodeColorsUnorm8Scalar(const std::span<const glm::vec4> source, const std::span<ColorUnorm8> destination) {
+        for (size_t i = 0; i < source.size(); i++)
+            destination[i] = {{ floatToUnorm8(source[i].x), floatToUnorm8(source[i].y), floatToUnorm8(source[i].z), floatToUnorm8(source[i].w) }};
+    }
+
+    void encodeSnorm16x2Scalar(const std::span<const glm::vec2> source, const std::span<Snorm16x2> destination) {
+        for (size_t i = 0; i < source.size(); i++)
+            destination[i] = {{ floatToSnorm16(source[i].x), floatToSnorm16(source[i].y) }};
+    }
+
+    void encodeOctahedralNormalsScalar(const std::span<const glm::vec3> source, const std::span<Snorm16x2> destination) {
+        for (size_t i = 0; i < source.size(); i++) {
+            const glm::vec2 encoded = encodeOctahedral(source[i]);
+            destination[i] = {{ floatToSnorm16(encoded.x), floatToSnorm16(encoded.y) }};
+        }
+    }
+
+#ifdef VERTEX_ENCODING_SSE2
+    // Four floats to four halves (one per 32-bit lane), the same steps as floatToHalf() but branch-free
+    static __m128i floatToHalfSse2(const __m128 values) {
+#ifdef VERTEX_ENCODING_F16C
+        return _mm_cvtepu16_epi32(_mm_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+#else
+        const __m128i bits     = _mm_castps_si128(values);
+        const __m128i sign     = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x8000));
+        const __m128i absolute = _mm_and_si128(bits, _mm_set1_epi32(0x7FFFFFFF));
+
+        const __m128i lowest_bit = _mm_and_si128(_mm_srli_epi32(absolute, 13), _mm_set1_epi32(1));
+        const __m128i normal     = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(absolute, _mm_set1_epi32(static_cast<int>(0xC8000FFF))), lowest_bit), 13);
+        const __m128i subnormal  = _mm_cvtps_epi32(_mm_mul_ps(_mm_castsi128_ps(absolute), _mm_set1_ps(16777216.0f)));
+        const __m128i overflow   = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(_mm_cmpgt_epi32(absolute, _mm_set1_epi32(0x7F800000)), _mm_set1_epi32(0x0200)));
+
+        const __m128i is_subnormal = _mm_cmplt_epi32(absolute, _mm_set1_epi32(0x38800000));
+        const __m128i is_overflow  = _mm_cmpgt_epi32(absolute, _mm_set1_epi32(0x477FEFFF));
+
+        __m128i result = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal), _mm_andnot_si128(is_subnormal, normal));
+        result         = _mm_or_si128(_mm_and_si128(is_overflow, overflow),   _mm_andnot_si128(is_overflow, result));
+
+        return _mm_or_si128(result, sign);
+#endif
+    }
+
+    // SSE2 only has a signed 32 -> 16 bit pack, so shift into signed range first and flip the top bit back after
+    static __m128i packUnsigned16(const __m128i low, const __m128i high) {
+        const __m128i bias = _mm_set1_epi32(0x8000);
+        return _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(low, bias), _mm_sub_epi32(high, bias)), _mm_set1_epi16(static_cast<short>(0x8000)));
+    }
+
+    static __m128i floatToSnorm16Sse2(const __m128 values) {
+        const __m128 clamped = _mm_min_ps(_mm_max_ps(values, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+        return _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(32767.0f)));
+    }
+#endif
+
+    // SIMD Encoders
+    void encodeHalf4(const std::span<const glm::vec3> source, const std::span<Half4> destination) {
+        size_t i = 0;
+
+#ifdef VERTEX_ENCODING_SSE2
+        // Two positions per iteration, each padded out with w = 1
+        for (; i + 2 <= source.size(); i += 2) {
+            const __m128i first  = floatToHalfSse2(_mm_setr_ps(source[i].x,     source[i].y,     source[i].z,     1.0f));
+            const __m128i second = floatToHalfSse2(_mm_setr_ps(source[i + 1].x, source[i + 1].y, source[i + 1].z, 1.0f));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&destination[i]), packUnsigned16(first, second));
+        }
+#endif
+
+        encodeHalf4Scalar(source.subspan(i), destination.subspan(i));
+    }
+
+    void encodeHalf2(const std::span<const glm::vec2> source, const std::span<Half2> destination) {
+        size_t i = 0;
+
+#ifdef VERTEX_ENCODING_SSE2
+        for (; i + 4 <= source.size(); i += 4) {
+            const auto* floats = reinterpret_cast<const float*>(&source[i]);
+
+            const __m128i low  = floatToHalfSse2(_mm_loadu_ps(floats));
+            const __m128i high = floatToHalfSse2(_mm_loadu_ps(floats + 4));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&destination[i]), packUnsigned16(low, high));
+        }
+#endif
+
+        encodeHalf2Scalar(source.subspan(i), destination.subspan(i));
+    }
+
+    void encodeColorsUnorm8(const std::span<const glm::vec4> source, const std::span<ColorUnorm8> destination) {
+        size_t i = 0;
+
+#ifdef VERTEX_ENCODING_SSE2
+        const __m128 zero  = _mm_setzero_ps();
+        const __m128 one   = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(255.0f);
+
+        // Four colors (16 floats) in, four RGBA8 colors (16 bytes) out
+        for (; i + 4 <= source.size(); i += 4) {
+            const auto* floats = reinterpret_cast<const float*>(&source[i]);
+
+            __m128i channels[4];
+            for (int j = 0; j < 4; j++)
+                channels[j] = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(floats + j * 4), zero), one), scale));
+
+            const __m128i low  = _mm_packs_epi32(channels[0], channels[1]);
+            const __m128i high = _mm_packs_epi32(channels[2], channels[3]);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&destination[i]), _mm_packus_epi16(low, high));
+        }
+#endif
+
+        encodeColorsUnorm8Scalar(source.subspan(i), destination.subspan(i));
+    }
+
+    void encodeSnorm16x2(const std::span<const glm::vec2> source, const std::span<Snorm16x2> destination) {
+        size_t i = 0;
+
+#ifdef VERTEX_ENCODING_SSE2
+        for (; i + 4 <= source.size(); i += 4) {
+            const auto* floats = reinterpret_cast<const float*>(&source[i]);
+
+            const __m128i low  = floatToSnorm16Sse2(_mm_loadu_ps(floats));
+            const __m128i high = floatToSnorm16Sse2(_mm_loadu_ps(floats + 4));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&destination[i]), _mm_packs_epi32(low, high));
+        }
+#endif
+
+        encodeSnorm16x2Scalar(source.subspan(i), destination.subspan(i));
+    }
+
+    void encodeOctahedralNormals(const std::span<const glm::vec3> source, const std::span<Snorm16x2> destination) {
+        size_t i = 0;
+
+#ifdef VERTEX_ENCODING_SSE2
+        const __m128 sign_mask = _mm_set1_ps(-0.0f);
+        const __m128 zero      = _mm_setzero_ps();
+        const __m128 one       = _mm_set1_ps(1.0f);
+
+        // Four normals at a time, laid out as x/y/z registers
+        for (; i + 4 <= source.size(); i += 4) {
+            const __m128 x = _mm_setr_ps(source[i].x, source[i + 1].x, source[i + 2].x, source[i + 3].x);
+            const __m128 y = _mm_setr_ps(source[i].y, source[i + 1].y, source[i + 2].y, source[i + 3].y);
+            const __m128 z = _mm_setr_ps(source[i].z, source[i + 1].z, source[i + 2].z, source[i + 3].z);
+
+            const __m128 inverse_length = _mm_div_ps(one, _mm_add_ps(_mm_add_ps(_mm_andnot_ps(sign_mask, x), _mm_andnot_ps(sign_mask, y)), _mm_andnot_ps(sign_mask, z)));
+
+            const __m128 projected_x = _mm_mul_ps(x, inverse_length);
+            const __m128 projected_y = _mm_mul_ps(y, inverse_length);
+
+            // sign() that treats 0 as positive, same as the scalar version
+            const __m128 sign_x = _mm_or_ps(one, _mm_and_ps(_mm_cmplt_ps(projected_x, zero), sign_mask));
+            const __m128 sign_y = _mm_or_ps(one, _mm_and_ps(_mm_cmplt_ps(projected_y, zero), sign_mask));
+
+            const __m128 folded_x = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, projected_y)), sign_x);
+            const __m128 folded_y = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, projected_x)), sign_y);
+
+            const __m128 lower = _mm_cmplt_ps(z, zero);
+
+            const __m128 encoded_x = _mm_or_ps(_mm_and_ps(lower, folded_x), _mm_andnot_ps(lower, projected_x));
+            const __m128 encoded_y = _mm_or_ps(_mm_and_ps(lower, folded_y), _mm_andnot_ps(lower, projected_y));
+
+            const __m128i low  = floatToSnorm16Sse2(_mm_unpacklo_ps(encoded_x, encoded_y));
+            const __m128i high = floatToSnorm16Sse2(_mm_unpackhi_ps(encoded_x, encoded_y));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&destination[i]), _mm_packs_epi32(low, high));
+        }
+#endif
+
+        encodeOctahedralNormalsScalar(source.subspan(i), destination.subspan(i));
+    }
+}
@@ -2,7 +2,7 @@
 
 #include "HelloTriangle.hpp"
 
-int main() {
-    return HelloTriangle::helloTriangle();
+int main(int argc, char** argv) {
+    return HelloTriangle::helloTriangle(argc, argv);
     return 0;
-}
+}
\ No newline at end of file